@@ -0,0 +1,77 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <iomanip>
+#include "bench.hpp"
+
+namespace
+{
+	std::atomic<size_t> allocations(0);
+
+	void *countedAllocate(size_t size) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		void *p = std::malloc(size ? size : 1);
+		if (!p)
+			throw std::bad_alloc();
+		return (p);
+	}
+}
+
+void *operator new(size_t size) {
+	return (countedAllocate(size));
+}
+
+void *operator new[](size_t size) {
+	return (countedAllocate(size));
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+	std::free(p);
+}
+
+namespace bench
+{
+	size_t allocationCount() {
+		return (allocations.load(std::memory_order_relaxed));
+	}
+
+	Runner::Runner(const char *filter, double minTimeMs, size_t repetitions)
+		: filter(filter), minTimeNs(minTimeMs * 1e6), repetitions(repetitions ? repetitions : 1) {}
+
+	bool Runner::selected(const char *name) const {
+		return (this->filter == NULL || std::strstr(name, this->filter) != NULL);
+	}
+
+	void Runner::printJson(std::ostream &os, const char *isa) const {
+		std::ios_base::fmtflags flags = os.flags();
+		os << "{\n";
+		os << "  \"schema\": 1,\n";
+		os << "  \"isa\": \"" << isa << "\",\n";
+		os << "  \"benchmarks\": [";
+		for (size_t i = 0; i < this->results.size(); ++i) {
+			const Result &r = this->results[i];
+			os << (i ? ",\n" : "\n");
+			os << "    {\"name\": \"" << r.name << "\", "
+				<< std::fixed << std::setprecision(3)
+				<< "\"ns_per_op\": " << r.nsPerOp << ", "
+				<< "\"mops_per_s\": " << 1e3 / r.nsPerOp << ", "
+				<< "\"allocs_per_op\": " << r.allocsPerOp << ", "
+				<< "\"iterations\": " << r.iterations << "}";
+		}
+		os << "\n  ]\n}\n";
+		os.flags(flags);
+	}
+} // namespace bench
@@ -0,0 +1,104 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <cstddef>
+#include <chrono>
+#include <ostream>
+#include "Vector.hpp"
+
+/**
+ * Minimal microbenchmark harness. Each case is a callable doing one
+ * operation; the runner doubles the iteration count until a batch takes
+ * at least minTime, then keeps the fastest of several batches.
+ * Allocations are counted by the global operator new overrides in
+ * bench.cpp, so allocs/op covers everything the operation touches.
+ *
+ * Output is one JSON object, keys and case order fixed, so runs can be
+ * diffed or compared by a script.
+ */
+namespace bench
+{
+	size_t allocationCount();
+
+	/**
+	 * @brief Forces the compiler to materialize value and to assume the memory
+	 * it points to may be read or written.
+	 */
+	template <class T>
+	inline void doNotOptimize(T &value) {
+#if defined(__GNUC__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		(void)value;
+#endif
+	}
+
+	struct Result
+	{
+		const char	*name;
+		double		nsPerOp;
+		double		allocsPerOp;
+		size_t		iterations;
+	};
+
+	class Runner
+	{
+	private:
+		ft::Vector<Result>	results;
+		const char			*filter;
+		double				minTimeNs;
+		size_t				repetitions;
+
+		bool selected(const char *name) const;
+
+	public:
+		Runner(const char *filter, double minTimeMs, size_t repetitions);
+
+		/**
+		 * @brief Times op(); itemsPerOp > 1 reports per item, e.g. per point of
+		 * a batch call.
+		 */
+		template <class Op>
+		void run(const char *name, Op op, size_t itemsPerOp = 1) {
+			if (!selected(name))
+				return ;
+			typedef std::chrono::steady_clock Clock;
+
+			size_t iterations = 1;
+			double elapsed = 0.0;
+			for (;;) {
+				Clock::time_point start = Clock::now();
+				for (size_t i = 0; i < iterations; ++i)
+					op();
+				elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+				if (elapsed >= minTimeNs || iterations >= (static_cast<size_t>(1) << 40))
+					break;
+				iterations *= 2;
+			}
+
+			double best = elapsed;
+			size_t allocations = 0;
+			for (size_t r = 0; r < repetitions; ++r) {
+				size_t before = allocationCount();
+				Clock::time_point start = Clock::now();
+				for (size_t i = 0; i < iterations; ++i)
+					op();
+				elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+				allocations = allocationCount() - before;
+				if (elapsed < best)
+					best = elapsed;
+			}
+
+			Result result;
+			result.name = name;
+			result.nsPerOp = best / static_cast<double>(iterations * itemsPerOp);
+			result.allocsPerOp = static_cast<double>(allocations) / static_cast<double>(iterations * itemsPerOp);
+			result.iterations = iterations;
+			this->results.push_back(result);
+		};
+
+		void printJson(std::ostream &os, const char *isa) const;
+	};
+} // namespace bench
+
+#endif // !BENCH_HPP
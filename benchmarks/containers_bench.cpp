@@ -0,0 +1,441 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "Vector.hpp"
+#include "SmallVector.hpp"
+#include "List.hpp"
+#include "Map.hpp"
+#include "ArenaAllocator.hpp"
+#include "PoolAllocator.hpp"
+#include "UnorderedMap.hpp"
+#include "FlatMap.hpp"
+#include "String.hpp"
+#include "StringView.hpp"
+#include "rt_simd.hpp"
+
+/**
+ * ft_containers microbenchmarks against the std equivalents. Usage:
+ *   containers_bench [--filter=substring] [--min-time-ms=N] [--repetitions=N]
+ * Prints the JSON report of bench::Runner on stdout.
+ */
+
+namespace
+{
+	const size_t GROW_COUNT = 1 << 16;
+
+	/**
+	 * @brief Fills an empty vector by push_back from scratch, so every
+	 * doubling relocates the elements stored so far.
+	 */
+	template <class Vector, class T>
+	void growVector(const T &seed) {
+		Vector v;
+		for (size_t i = 0; i < GROW_COUNT; ++i)
+			v.push_back(seed);
+		bench::doNotOptimize(v);
+	}
+
+	void benchVectorGrowth(bench::Runner &runner) {
+		float f = 1.5f;
+		int n = 7;
+		// longer than the small-string buffer, so copies allocate and moves do not
+		std::string s("a vertex group name of some length");
+
+		runner.run("vector.push_back.float.ft", [&]() {
+			bench::doNotOptimize(f);
+			growVector<ft::Vector<float> >(f);
+		}, GROW_COUNT);
+		runner.run("vector.push_back.float.std", [&]() {
+			bench::doNotOptimize(f);
+			growVector<std::vector<float> >(f);
+		}, GROW_COUNT);
+		runner.run("vector.push_back.int.ft", [&]() {
+			bench::doNotOptimize(n);
+			growVector<ft::Vector<int> >(n);
+		}, GROW_COUNT);
+		runner.run("vector.push_back.int.std", [&]() {
+			bench::doNotOptimize(n);
+			growVector<std::vector<int> >(n);
+		}, GROW_COUNT);
+		runner.run("vector.push_back.string.ft", [&]() {
+			growVector<ft::Vector<std::string> >(s);
+		}, GROW_COUNT);
+		runner.run("vector.push_back.string.std", [&]() {
+			growVector<std::vector<std::string> >(s);
+		}, GROW_COUNT);
+	}
+
+	// Vertex records of 6 floats written the way a loader would, per float.
+	void benchVectorAppend(bench::Runner &runner) {
+		float record[6] = {0.5f, -1.0f, 2.0f, 0.25f, 0.75f, 1.0f};
+		const size_t floats = 6 * GROW_COUNT;
+
+		runner.run("vector.record6.push_back.ft", [&]() {
+			bench::doNotOptimize(record);
+			ft::Vector<float> v;
+			for (size_t i = 0; i < GROW_COUNT; ++i)
+				for (size_t k = 0; k < 6; ++k)
+					v.push_back(record[k]);
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.record6.push_back.std", [&]() {
+			bench::doNotOptimize(record);
+			std::vector<float> v;
+			for (size_t i = 0; i < GROW_COUNT; ++i)
+				for (size_t k = 0; k < 6; ++k)
+					v.push_back(record[k]);
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.record6.append.ft", [&]() {
+			bench::doNotOptimize(record);
+			ft::Vector<float> v;
+			for (size_t i = 0; i < GROW_COUNT; ++i)
+				v.append(record, record + 6);
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.record6.insert_end.std", [&]() {
+			bench::doNotOptimize(record);
+			std::vector<float> v;
+			for (size_t i = 0; i < GROW_COUNT; ++i)
+				v.insert(v.end(), record, record + 6);
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.record6.append_uninitialized.ft", [&]() {
+			bench::doNotOptimize(record);
+			ft::Vector<float> v;
+			for (size_t i = 0; i < GROW_COUNT; ++i) {
+				float *out = v.append_uninitialized(6);
+				for (size_t k = 0; k < 6; ++k)
+					out[k] = record[k];
+			}
+			bench::doNotOptimize(v);
+		}, floats);
+
+		// known count: size once, then overwrite every element
+		runner.run("vector.overwrite.resize_for_overwrite.ft", [&]() {
+			bench::doNotOptimize(record);
+			ft::Vector<float> v;
+			v.resize_for_overwrite(floats);
+			for (size_t i = 0; i < floats; ++i)
+				v[i] = record[i % 6];
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.overwrite.resize.ft", [&]() {
+			bench::doNotOptimize(record);
+			ft::Vector<float> v;
+			v.resize(floats);
+			for (size_t i = 0; i < floats; ++i)
+				v[i] = record[i % 6];
+			bench::doNotOptimize(v);
+		}, floats);
+		runner.run("vector.overwrite.resize.std", [&]() {
+			bench::doNotOptimize(record);
+			std::vector<float> v;
+			v.resize(floats);
+			for (size_t i = 0; i < floats; ++i)
+				v[i] = record[i % 6];
+			bench::doNotOptimize(v);
+		}, floats);
+	}
+
+	const size_t NODE_COUNT = 1024;
+
+	// Node containers and vector growth with ft::Allocator, from an arena
+	// reset once per op, and with std.
+	void benchArena(bench::Runner &runner) {
+		typedef ft::Pair<const int, int> MapValue;
+		ft::Arena arena;
+		float f = 1.5f;
+
+		runner.run("vector.push_back.float.ft_arena", [&]() {
+			arena.reset();
+			bench::doNotOptimize(f);
+			ft::Vector<float, ft::ArenaAllocator<float> > v(arena);
+			for (size_t i = 0; i < GROW_COUNT; ++i)
+				v.push_back(f);
+			bench::doNotOptimize(v);
+		}, GROW_COUNT);
+
+		runner.run("list.push_back.int.ft", []() {
+			ft::List<int> l;
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				l.push_back(static_cast<int>(i));
+			bench::doNotOptimize(l);
+		}, NODE_COUNT);
+		runner.run("list.push_back.int.ft_arena", [&]() {
+			arena.reset();
+			ft::List<int, ft::ArenaAllocator<int> > l(arena);
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				l.push_back(static_cast<int>(i));
+			bench::doNotOptimize(l);
+		}, NODE_COUNT);
+		runner.run("list.push_back.int.std", []() {
+			std::list<int> l;
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				l.push_back(static_cast<int>(i));
+			bench::doNotOptimize(l);
+		}, NODE_COUNT);
+
+		// keys in a scrambled order so the tree rebalances
+		runner.run("map.insert.int.ft", []() {
+			ft::Map<int, int> m;
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				m[static_cast<int>((i * 7919) % NODE_COUNT)] = static_cast<int>(i);
+			bench::doNotOptimize(m);
+		}, NODE_COUNT);
+		runner.run("map.insert.int.ft_arena", [&]() {
+			arena.reset();
+			ft::Map<int, int, ft::less<int>, ft::ArenaAllocator<MapValue> > m(ft::less<int>(), arena);
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				m[static_cast<int>((i * 7919) % NODE_COUNT)] = static_cast<int>(i);
+			bench::doNotOptimize(m);
+		}, NODE_COUNT);
+		runner.run("map.insert.int.std", []() {
+			std::map<int, int> m;
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				m[static_cast<int>((i * 7919) % NODE_COUNT)] = static_cast<int>(i);
+			bench::doNotOptimize(m);
+		}, NODE_COUNT);
+	}
+
+	const size_t BIG_COUNT = 1 << 20;
+
+	int scrambledKey(size_t i) {
+		return (static_cast<int>((i * 2654435761u) % BIG_COUNT));
+	}
+
+	template <class MapType>
+	void fillMap(MapType &m) {
+		for (size_t i = 0; i < BIG_COUNT; ++i)
+			m[scrambledKey(i)] = static_cast<int>(i);
+	}
+
+	// Lookup and in-order walk of a map filled by fillMap; lookups hit every
+	// key in an order unrelated to insertion.
+	template <class MapType>
+	void benchBigMapReads(bench::Runner &runner, MapType &m, const char *findName,
+		const char *iterateName) {
+		runner.run(findName, [&]() {
+			long sum = 0;
+			for (size_t i = 0; i < BIG_COUNT; ++i)
+				sum += m.find(static_cast<int>((i * 40503u) % BIG_COUNT))->second;
+			bench::doNotOptimize(sum);
+		}, BIG_COUNT);
+		runner.run(iterateName, [&]() {
+			long sum = 0;
+			for (typename MapType::iterator it = m.begin(); it != m.end(); ++it)
+				sum += it->second;
+			bench::doNotOptimize(sum);
+		}, BIG_COUNT);
+	}
+
+	// Build, lookup and in-order walk of a 1M-entry map.
+	template <class MapType>
+	void benchBigMap(bench::Runner &runner, const char *insertName, const char *findName,
+		const char *iterateName) {
+		runner.run(insertName, []() {
+			MapType m;
+			fillMap(m);
+			bench::doNotOptimize(m);
+		}, BIG_COUNT);
+
+		MapType m;
+		fillMap(m);
+		benchBigMapReads(runner, m, findName, iterateName);
+	}
+
+	void benchPool(bench::Runner &runner) {
+		typedef ft::Pair<const int, int> MapValue;
+
+		runner.run("list.push_back.int.ft_pool", []() {
+			ft::List<int, ft::PoolAllocator<int> > l;
+			for (size_t i = 0; i < NODE_COUNT; ++i)
+				l.push_back(static_cast<int>(i));
+			bench::doNotOptimize(l);
+		}, NODE_COUNT);
+
+		benchBigMap<ft::Map<int, int> >(runner,
+			"map1m.insert.ft", "map1m.find.ft", "map1m.iterate.ft");
+		benchBigMap<ft::Map<int, int, ft::less<int>, ft::PoolAllocator<MapValue> > >(runner,
+			"map1m.insert.ft_pool", "map1m.find.ft_pool", "map1m.iterate.ft_pool");
+		benchBigMap<std::map<int, int> >(runner,
+			"map1m.insert.std", "map1m.find.std", "map1m.iterate.std");
+	}
+
+	// Same 1M-key workload as benchPool, for the hash maps.
+	void benchHashMap(bench::Runner &runner) {
+		benchBigMap<ft::UnorderedMap<int, int> >(runner,
+			"map1m.insert.ft_unordered", "map1m.find.ft_unordered", "map1m.iterate.ft_unordered");
+		benchBigMap<std::unordered_map<int, int> >(runner,
+			"map1m.insert.std_unordered", "map1m.find.std_unordered", "map1m.iterate.std_unordered");
+
+		// misses probe until an empty group, the worst case at 7/8 load
+		ft::UnorderedMap<int, int> table;
+		std::unordered_map<int, int> stdTable;
+		fillMap(table);
+		fillMap(stdTable);
+		runner.run("map1m.find_miss.ft_unordered", [&]() {
+			size_t found = 0;
+			for (size_t i = 0; i < BIG_COUNT; ++i)
+				found += table.count(static_cast<int>(BIG_COUNT + i));
+			bench::doNotOptimize(found);
+		}, BIG_COUNT);
+		runner.run("map1m.find_miss.std_unordered", [&]() {
+			size_t found = 0;
+			for (size_t i = 0; i < BIG_COUNT; ++i)
+				found += stdTable.count(static_cast<int>(BIG_COUNT + i));
+			bench::doNotOptimize(found);
+		}, BIG_COUNT);
+	}
+
+	// Same keys as fillMap, built in one go from the unsorted pairs: one
+	// insert at a time would shift the arrays on every key.
+	void benchFlatMap(bench::Runner &runner) {
+		typedef ft::Pair<const int, int> MapValue;
+
+		ft::Vector<MapValue> items;
+		for (size_t i = 0; i < BIG_COUNT; ++i)
+			items.push_back(MapValue(scrambledKey(i), static_cast<int>(i)));
+		runner.run("map1m.insert.ft_flat", [&]() {
+			ft::FlatMap<int, int> m(items.begin(), items.end());
+			bench::doNotOptimize(m);
+		}, BIG_COUNT);
+
+		ft::FlatMap<int, int> m(items.begin(), items.end());
+		benchBigMapReads(runner, m, "map1m.find.ft_flat", "map1m.iterate.ft_flat");
+	}
+
+	// Lines shaped like the vertex and face records loadOBJ reads.
+	std::string objText() {
+		std::string text;
+		for (size_t i = 0; i < NODE_COUNT; ++i)
+		{
+			text += "v 0." + std::to_string(i * 7919 % 1000000) + " -1.250000 "
+				+ std::to_string(i) + ".500000\n";
+			text += "f " + std::to_string(i + 1) + "/1/1 " + std::to_string(i + 2)
+				+ "/2/2 " + std::to_string(i + 3) + "/3/3\n";
+		}
+		return (text);
+	}
+
+	// One string reused for every token, like tempStr in loadOBJ, plus a
+	// by-value copy per token like isNumber takes.
+	template <class StringType>
+	void benchTokenize(bench::Runner &runner, const char *name, const std::string &text,
+		size_t tokens) {
+		runner.run(name, [&]() {
+			std::istringstream in(text);
+			StringType token;
+			size_t chars = 0;
+			while (in >> token)
+			{
+				StringType copy(token);
+				chars += copy.size();
+			}
+			bench::doNotOptimize(chars);
+		}, tokens);
+	}
+
+	void benchString(bench::Runner &runner) {
+		std::string text = objText();
+		std::istringstream in(text);
+		std::string token;
+		size_t tokens = 0;
+		while (in >> token)
+			++tokens;
+		benchTokenize<ft::String>(runner, "string.tokenize_obj.ft", text, tokens);
+		benchTokenize<std::string>(runner, "string.tokenize_obj.std", text, tokens);
+		runner.run("string.tokenize_obj.ft_view", [&]() {
+			ft::Tokenizer in(ft::StringView(text.data(), text.size()));
+			ft::StringView token;
+			size_t chars = 0;
+			while (in.next(token))
+				chars += token.size();
+			bench::doNotOptimize(chars);
+		}, tokens);
+	}
+
+	const size_t FACE_COUNT = 1 << 14;
+
+	// loadOBJ's face loop: a scratch list per face, fanned into triangles.
+	// Faces cycle through 3 to 6 corners, so the inline buffer holds the
+	// scratch whatever the polygon.
+	template <class Scratch>
+	void benchFaceLoop(bench::Runner &runner, const char *name) {
+		runner.run(name, []() {
+			ft::Vector<int> indices;
+			indices.reserve(FACE_COUNT * 12);
+			for (size_t face = 0; face < FACE_COUNT; ++face)
+			{
+				Scratch scratch;
+				size_t corners = 3 + face % 4;
+				for (size_t i = 0; i < corners; ++i)
+				{
+					scratch.push_back(static_cast<int>(face + i));
+					if (scratch.size() == 3)
+					{
+						int *triangle = indices.append_uninitialized(3);
+						triangle[0] = scratch[0];
+						triangle[1] = scratch[1];
+						triangle[2] = scratch[2];
+						scratch.erase(scratch.begin() + 1);
+					}
+				}
+			}
+			bench::doNotOptimize(indices);
+		}, FACE_COUNT);
+	}
+
+	void benchSmallVector(bench::Runner &runner) {
+		benchFaceLoop<ft::Vector<int> >(runner, "face_loop.scratch.ft_vector");
+		benchFaceLoop<ft::SmallVector<int, 3> >(runner, "face_loop.scratch.ft_small");
+		benchFaceLoop<std::vector<int> >(runner, "face_loop.scratch.std_vector");
+	}
+
+	const char *argValue(const char *arg, const char *key) {
+		size_t len = std::strlen(key);
+		if (std::strncmp(arg, key, len) == 0)
+			return (arg + len);
+		return (NULL);
+	}
+}
+
+int main(int argc, char **argv) {
+	const char *filter = NULL;
+	double minTimeMs = 20.0;
+	size_t repetitions = 5;
+
+	for (int i = 1; i < argc; ++i) {
+		const char *value;
+		if ((value = argValue(argv[i], "--filter=")))
+			filter = value;
+		else if ((value = argValue(argv[i], "--min-time-ms=")))
+			minTimeMs = std::atof(value);
+		else if ((value = argValue(argv[i], "--repetitions=")))
+			repetitions = static_cast<size_t>(std::atol(value));
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--filter=substring] [--min-time-ms=N] [--repetitions=N]" << std::endl;
+			return (1);
+		}
+	}
+
+	bench::Runner runner(filter, minTimeMs, repetitions);
+	benchVectorGrowth(runner);
+	benchVectorAppend(runner);
+	benchArena(runner);
+	benchPool(runner);
+	benchHashMap(runner);
+	benchFlatMap(runner);
+	benchString(runner);
+	benchSmallVector(runner);
+	runner.printJson(std::cout, rt::simd::isaName(rt::simd::activeIsa()));
+	return (0);
+}
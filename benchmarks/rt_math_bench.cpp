@@ -0,0 +1,603 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include "bench.hpp"
+#include "rt_vector.hpp"
+#include "rt_matrix.hpp"
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+#include "rt_quaternion.hpp"
+#include "rt_transform.hpp"
+#include "rt_batch.hpp"
+#include "rt_linalg.hpp"
+#include "rt_frustum.hpp"
+#include "rt_ray.hpp"
+#include "rt_fastmath.hpp"
+#include "rt_curve.hpp"
+
+/**
+ * rt_math microbenchmarks. Usage:
+ *   rt_math_bench [--filter=substring] [--min-time-ms=N] [--repetitions=N]
+ * Prints the JSON report of bench::Runner on stdout.
+ */
+
+namespace
+{
+	const char *simdMat4MulNames[] = {
+		"simd.mat4_mul.scalar", "simd.mat4_mul.sse2", "simd.mat4_mul.avx", "simd.mat4_mul.avx2"
+	};
+	const char *simdMat4MulVec4Names[] = {
+		"simd.mat4_mul_vec4.scalar", "simd.mat4_mul_vec4.sse2", "simd.mat4_mul_vec4.avx", "simd.mat4_mul_vec4.avx2"
+	};
+	const char *batchNames[] = {
+		"batch.transform_soa.scalar", "batch.transform_soa.sse2", "batch.transform_soa.avx", "batch.transform_soa.avx2"
+	};
+
+	const char *cullSpheresNames[] = {
+		"cull.spheres.scalar", "cull.spheres.sse2", "cull.spheres.avx", "cull.spheres.avx2"
+	};
+	const char *cullAabbsNames[] = {
+		"cull.aabbs.scalar", "cull.aabbs.sse2", "cull.aabbs.avx", "cull.aabbs.avx2"
+	};
+
+	const char *rayClosestNames[] = {
+		"ray.closest.scalar", "ray.closest.sse2", "ray.closest.avx", "ray.closest.avx2"
+	};
+	const char *rayPacketNames[] = {
+		"ray.packet.scalar", "ray.packet.sse2", "ray.packet.avx", "ray.packet.avx2"
+	};
+
+	const char *fastSinCosNames[] = {
+		"fast.sincos.scalar", "fast.sincos.sse2", "fast.sincos.avx", "fast.sincos.avx2"
+	};
+	const char *fastRsqrtNames[] = {
+		"fast.rsqrt.scalar", "fast.rsqrt.sse2", "fast.rsqrt.avx", "fast.rsqrt.avx2"
+	};
+
+	const float modelData[16] = {
+		0.8f, -0.2f, 0.1f, 1.5f,
+		0.3f, 0.9f, -0.4f, -2.0f,
+		-0.1f, 0.5f, 0.7f, 0.25f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+
+	void benchConstruction(bench::Runner &runner) {
+		runner.run("rtvector.construct3", []() {
+			rt::RTVector<float> v(1.0f, 2.0f, 3.0f);
+			bench::doNotOptimize(v);
+		});
+		runner.run("rtmatrix.construct4x4", []() {
+			rt::RTMatrix<float> m(4, 4);
+			bench::doNotOptimize(m);
+		});
+		runner.run("vec3f.construct", []() {
+			rt::Vec3f v(1.0f, 2.0f, 3.0f);
+			bench::doNotOptimize(v);
+		});
+		runner.run("mat4f.identity", []() {
+			rt::Mat4f m = rt::Mat4f::identity();
+			bench::doNotOptimize(m);
+		});
+	}
+
+	void benchMultiply(bench::Runner &runner) {
+		rt::RTMatrix<float> ra(4, 4, modelData);
+		rt::RTMatrix<float> rb(4, 4, modelData);
+		rt::RTVector<float> rv(1.0f, 2.0f, 3.0f, 1.0f);
+		rt::Mat4f a(modelData);
+		rt::Mat4f b(modelData);
+		rt::Mat4d ad = rt::Mat4d::identity();
+		rt::Mat4d bd = rt::Mat4d::identity();
+		for (size_t i = 0; i < 16; ++i) {
+			ad.getData()[i] = modelData[i];
+			bd.getData()[i] = modelData[i];
+		}
+		rt::Vec4f v(1.0f, 2.0f, 3.0f, 1.0f);
+
+		runner.run("rtmatrix.mul4x4", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTMatrix<float> r = ra * rb;
+			bench::doNotOptimize(r);
+		});
+		// off the float 4x4 kernel: the small-operand loop
+		rt::RTMatrix<double> rad(4, 4);
+		rt::RTMatrix<float> ra3(3, 3, modelData);
+		for (size_t i = 0; i < 16; ++i)
+			rad[i / 4][i % 4] = modelData[i];
+		runner.run("rtmatrix.mul4x4d", [&]() {
+			bench::doNotOptimize(rad);
+			rt::RTMatrix<double> r = rad * rad;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtmatrix.mul3x3", [&]() {
+			bench::doNotOptimize(ra3);
+			rt::RTMatrix<float> r = ra3 * ra3;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtmatrix.mul_rtvector4", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTVector<float> r = ra * rv;
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4f.mul", [&]() {
+			bench::doNotOptimize(a);
+			rt::Mat4f r = a * b;
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4d.mul", [&]() {
+			bench::doNotOptimize(ad);
+			rt::Mat4d r = ad * bd;
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4f.mul_vec4", [&]() {
+			bench::doNotOptimize(a);
+			rt::Vec4f r = a * v;
+			bench::doNotOptimize(r);
+		});
+
+		float out[16];
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::simd::Mat4MulFn mul = rt::simd::mat4MulKernel(static_cast<rt::simd::Isa>(isa));
+			rt::simd::Mat4MulVec4Fn mulVec = rt::simd::mat4MulVec4Kernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(simdMat4MulNames[isa], [&]() {
+				bench::doNotOptimize(a);
+				mul(a.getData(), b.getData(), out);
+				bench::doNotOptimize(out);
+			});
+			runner.run(simdMat4MulVec4Names[isa], [&]() {
+				bench::doNotOptimize(a);
+				mulVec(a.getData(), v.getData(), out);
+				bench::doNotOptimize(out);
+			});
+		}
+	}
+
+	void benchInverse(bench::Runner &runner) {
+		rt::RTMatrix<float> r4(4, 4, modelData);
+		rt::RTMatrix<double> r5(5, 5);
+		for (size_t i = 0; i < 5; ++i)
+			for (size_t j = 0; j < 5; ++j)
+				r5[i][j] = (i == j) ? 5.0 : 1.0 / static_cast<double>(i + j + 1);
+		rt::Mat4f m(modelData);
+		rt::Mat3f m3;
+		for (size_t i = 0; i < 3; ++i)
+			for (size_t j = 0; j < 3; ++j)
+				m3[i][j] = modelData[i * 4 + j];
+
+		// in place: every call inverts the previous result back
+		runner.run("rtmatrix.inverse4x4", [&]() {
+			r4.inverse();
+			bench::doNotOptimize(r4);
+		});
+		runner.run("rtmatrix.inverse5x5", [&]() {
+			r5.inverse();
+			bench::doNotOptimize(r5);
+		});
+		runner.run("mat3f.inverse", [&]() {
+			bench::doNotOptimize(m3);
+			rt::Mat3f r = rt::inverse(m3);
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4f.inverse", [&]() {
+			bench::doNotOptimize(m);
+			rt::Mat4f r = rt::inverse(m);
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4f.affine_inverse", [&]() {
+			bench::doNotOptimize(m);
+			rt::Mat4f r = rt::affineInverse(m);
+			bench::doNotOptimize(r);
+		});
+		runner.run("mat4f.normal_matrix", [&]() {
+			bench::doNotOptimize(m);
+			rt::Mat3f r = rt::normalMatrix(m);
+			bench::doNotOptimize(r);
+		});
+	}
+
+	void benchVectorOps(bench::Runner &runner) {
+		rt::RTVector<float> ra(1.0f, 2.0f, 3.0f);
+		rt::RTVector<float> rb(-0.5f, 4.0f, 0.25f);
+		rt::RTVector<float> rc(2.0f, -1.0f, 1.0f);
+		rt::RTVector<float> rr(0.0f, 0.0f, 0.0f);
+		rt::Vec3f a(1.0f, 2.0f, 3.0f);
+		rt::Vec3f b(-0.5f, 4.0f, 0.25f);
+		rt::Vec3f c(2.0f, -1.0f, 1.0f);
+		float s = 0.5f;
+
+		runner.run("rtvector.add", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTVector<float> r = ra + rb;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtvector.expr", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTVector<float> r = ra + rb * s - rc;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtvector.assign_expr", [&]() {
+			bench::doNotOptimize(ra);
+			rr = ra + rb * s - rc;
+			bench::doNotOptimize(rr);
+		});
+		runner.run("vec3f.add", [&]() {
+			bench::doNotOptimize(a);
+			rt::Vec3f r = a + b;
+			bench::doNotOptimize(r);
+		});
+		runner.run("vec3f.expr", [&]() {
+			bench::doNotOptimize(a);
+			rt::Vec3f r = a + b * s - c;
+			bench::doNotOptimize(r);
+		});
+
+		runner.run("rtvector.get_normalized", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTVector<float> r = ra.get_normalized();
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtvector.normalize", [&]() {
+			rr.normalize();
+			bench::doNotOptimize(rr);
+		});
+		runner.run("vec3f.get_normalized", [&]() {
+			bench::doNotOptimize(a);
+			rt::Vec3f r = a.get_normalized();
+			bench::doNotOptimize(r);
+		});
+		runner.run("vec3f.normalize", [&]() {
+			c.normalize();
+			bench::doNotOptimize(c);
+		});
+
+		runner.run("rtvector.dot", [&]() {
+			bench::doNotOptimize(ra);
+			float r = rt::RTVector<float>::dot(ra, rb);
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtvector.cross", [&]() {
+			bench::doNotOptimize(ra);
+			rt::RTVector<float> r = rt::RTVector<float>::cross(ra, rb);
+			bench::doNotOptimize(r);
+		});
+		runner.run("vec3f.dot", [&]() {
+			bench::doNotOptimize(a);
+			float r = rt::Vec3f::dot(a, b);
+			bench::doNotOptimize(r);
+		});
+		runner.run("vec3f.cross", [&]() {
+			bench::doNotOptimize(a);
+			rt::Vec3f r = rt::Vec3f::cross(a, b);
+			bench::doNotOptimize(r);
+		});
+	}
+
+	void benchQuaternion(bench::Runner &runner) {
+		rt::Quatf q = rt::Quatf::fromAxisAngle(rt::Vec3f(0.3f, 1.0f, 0.2f), 0.7f);
+		rt::Quatf p = rt::Quatf::fromAxisAngle(rt::Vec3f(1.0f, 0.0f, 0.5f), -1.1f);
+		rt::Vec3f v(1.0f, 2.0f, 3.0f);
+		float t = 0.3f;
+
+		runner.run("quatf.mul", [&]() {
+			bench::doNotOptimize(q);
+			rt::Quatf r = q * p;
+			bench::doNotOptimize(r);
+		});
+		runner.run("quatf.rotate", [&]() {
+			bench::doNotOptimize(q);
+			rt::Vec3f r = q.rotate(v);
+			bench::doNotOptimize(r);
+		});
+		runner.run("quatf.to_mat4", [&]() {
+			bench::doNotOptimize(q);
+			rt::Mat4f r = q.toMat4();
+			bench::doNotOptimize(r);
+		});
+		runner.run("quatf.slerp", [&]() {
+			bench::doNotOptimize(q);
+			rt::Quatf r = rt::Quatf::slerp(q, p, t);
+			bench::doNotOptimize(r);
+		});
+		runner.run("transform.look_at", [&]() {
+			bench::doNotOptimize(v);
+			rt::Mat4f r = rt::lookAt(v, rt::Vec3f(0.0f, 0.0f, 0.0f), rt::Vec3f(0.0f, 1.0f, 0.0f));
+			bench::doNotOptimize(r);
+		});
+	}
+
+	void benchBatch(bench::Runner &runner) {
+		const size_t count = 4096;
+		ft::Vector<float> x(count), y(count), z(count);
+		for (size_t i = 0; i < count; ++i) {
+			x[i] = static_cast<float>(i % 17) * 0.25f;
+			y[i] = static_cast<float>(i % 31) * -0.5f;
+			z[i] = static_cast<float>(i % 7);
+		}
+		ft::Vector<float> ox(count), oy(count), oz(count);
+
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::batch::TransformSoaFn kernel = rt::batch::transformSoaKernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(batchNames[isa], [&]() {
+				kernel(modelData, &x[0], &y[0], &z[0], &ox[0], &oy[0], &oz[0], count);
+				bench::doNotOptimize(ox);
+			}, count);
+		}
+	}
+
+	void benchCulling(bench::Runner &runner) {
+		const size_t count = 64 * 1024;
+		ft::Vector<float> x(count), y(count), z(count), r(count);
+		ft::Vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+		for (size_t i = 0; i < count; ++i) {
+			x[i] = static_cast<float>(i % 97) - 48.0f;
+			y[i] = static_cast<float>(i % 89) - 44.0f;
+			z[i] = static_cast<float>(i % 83) - 60.0f;
+			r[i] = static_cast<float>(i % 5) * 0.5f;
+			minX[i] = x[i] - r[i];
+			minY[i] = y[i] - r[i];
+			minZ[i] = z[i] - r[i];
+			maxX[i] = x[i] + r[i];
+			maxY[i] = y[i] + r[i];
+			maxZ[i] = z[i] + r[i];
+		}
+		ft::Vector<uint64_t> mask((count + 63) / 64);
+		rt::Mat4f viewProjection = rt::perspective(rt::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f)
+			* rt::translate(rt::Mat4f::identity(), rt::Vec3f(0.0f, 0.0f, -10.0f));
+		rt::cull::Planes planes(rt::Frustumf::fromMatrix(viewProjection));
+
+		runner.run("frustum.from_matrix", [&]() {
+			bench::doNotOptimize(viewProjection);
+			rt::Frustumf f = rt::Frustumf::fromMatrix(viewProjection);
+			bench::doNotOptimize(f);
+		});
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::cull::SpheresFn spheres = rt::cull::cullSpheresKernel(static_cast<rt::simd::Isa>(isa));
+			rt::cull::AabbsFn aabbs = rt::cull::cullAabbsKernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(cullSpheresNames[isa], [&]() {
+				spheres(planes, &x[0], &y[0], &z[0], &r[0], count, &mask[0]);
+				bench::doNotOptimize(mask);
+			}, count);
+			runner.run(cullAabbsNames[isa], [&]() {
+				aabbs(planes, &minX[0], &minY[0], &minZ[0], &maxX[0], &maxY[0], &maxZ[0], count, &mask[0]);
+				bench::doNotOptimize(mask);
+			}, count);
+		}
+	}
+
+	/**
+	 * Rays per second against a 1024-triangle UV sphere, brute force: one
+	 * ray at a time over all triangles, and a 256-ray packet per triangle.
+	 */
+	void benchRays(bench::Runner &runner) {
+		const size_t rings = 16, segments = 32;
+		const size_t triangles = 2 * rings * segments;
+		ft::Vector<float> positions((rings + 1) * (segments + 1) * 3);
+		ft::Vector<int> indices(triangles * 3);
+		for (size_t r = 0; r <= rings; ++r) {
+			for (size_t s = 0; s <= segments; ++s) {
+				float theta = static_cast<float>(r) * 3.14159265f / static_cast<float>(rings);
+				float phi = static_cast<float>(s) * 6.28318531f / static_cast<float>(segments);
+				float *p = &positions[(r * (segments + 1) + s) * 3];
+				p[0] = std::sin(theta) * std::cos(phi);
+				p[1] = std::cos(theta);
+				p[2] = std::sin(theta) * std::sin(phi);
+			}
+		}
+		for (size_t r = 0, k = 0; r < rings; ++r) {
+			for (size_t s = 0; s < segments; ++s) {
+				int a = static_cast<int>(r * (segments + 1) + s);
+				int b = a + static_cast<int>(segments + 1);
+				int quad[6] = { a, b, a + 1, a + 1, b, b + 1 };
+				for (size_t q = 0; q < 6; ++q)
+					indices[k++] = quad[q];
+			}
+		}
+		ft::Vector<float> packed(triangles * 9);
+		rt::ray::packTriangles(&positions[0], 3, &indices[0], triangles, &packed[0]);
+		rt::ray::Triangles tris(&packed[0], triangles);
+
+		// 16 x 16 pinhole camera at z = 3 looking down -z, about half the rays hit
+		const size_t count = 256;
+		ft::Vector<float> ox(count, 0.0f), oy(count, 0.0f), oz(count, 3.0f), dx(count), dy(count), dz(count, -1.0f);
+		ft::Vector<float> t(count), u(count), v(count);
+		ft::Vector<int> index(count);
+		for (size_t i = 0; i < count; ++i) {
+			dx[i] = (static_cast<float>(i % 16) - 7.5f) / 16.0f;
+			dy[i] = (static_cast<float>(i / 16) - 7.5f) / 16.0f;
+		}
+		rt::ray::RayPacket rays = { &ox[0], &oy[0], &oz[0], &dx[0], &dy[0], &dz[0], count };
+		rt::ray::HitPacket hits = { &t[0], &u[0], &v[0], &index[0] };
+
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::ray::ClosestFn closest = rt::ray::closestKernel(static_cast<rt::simd::Isa>(isa));
+			rt::ray::PacketFn packet = rt::ray::packetKernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(rayClosestNames[isa], [&]() {
+				for (size_t i = 0; i < count; ++i) {
+					const float ray[6] = { ox[i], oy[i], oz[i], dx[i], dy[i], dz[i] };
+					rt::ray::Hit hit = { std::numeric_limits<float>::infinity(), 0.0f, 0.0f, -1 };
+					closest(ray, tris, 0, hit);
+					bench::doNotOptimize(hit);
+				}
+			}, count);
+			runner.run(rayPacketNames[isa], [&]() {
+				rt::ray::resetHits(hits, count);
+				for (size_t tri = 0; tri < triangles; ++tri)
+					packet(rays, tris, tri, hits);
+				bench::doNotOptimize(t);
+			}, count);
+		}
+	}
+
+	/**
+	 * Per element over 4096 floats: libm against the fast:: scalar functions
+	 * and the batch kernels.
+	 */
+	void benchFastMath(bench::Runner &runner) {
+		const size_t count = 4096;
+		ft::Vector<float> x(count), s(count), c(count);
+		for (size_t i = 0; i < count; ++i)
+			x[i] = static_cast<float>(i) * 0.0123f - 25.0f;
+
+		runner.run("fast.sincos.libm", [&]() {
+			for (size_t i = 0; i < count; ++i) {
+				s[i] = std::sin(x[i]);
+				c[i] = std::cos(x[i]);
+			}
+			bench::doNotOptimize(s);
+			bench::doNotOptimize(c);
+		}, count);
+		runner.run("fast.tan.libm", [&]() {
+			for (size_t i = 0; i < count; ++i)
+				s[i] = std::tan(x[i]);
+			bench::doNotOptimize(s);
+		}, count);
+		runner.run("fast.tan.fast", [&]() {
+			for (size_t i = 0; i < count; ++i)
+				s[i] = rt::fast::tan(x[i]);
+			bench::doNotOptimize(s);
+		}, count);
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::fast::SinCosFn sinCos = rt::fast::sinCosKernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(fastSinCosNames[isa], [&]() {
+				sinCos(&x[0], &s[0], &c[0], count);
+				bench::doNotOptimize(s);
+				bench::doNotOptimize(c);
+			}, count);
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			x[i] = static_cast<float>(i) * 0.37f + 0.01f;
+		runner.run("fast.rsqrt.libm", [&]() {
+			for (size_t i = 0; i < count; ++i)
+				s[i] = 1.0f / std::sqrt(x[i]);
+			bench::doNotOptimize(s);
+		}, count);
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa) {
+			rt::fast::RsqrtFn rsqrt = rt::fast::rsqrtKernel(static_cast<rt::simd::Isa>(isa));
+			runner.run(fastRsqrtNames[isa], [&]() {
+				rsqrt(&x[0], &s[0], count);
+				bench::doNotOptimize(s);
+			}, count);
+		}
+	}
+
+	/**
+	 * Per point over 1M vertices in the x y z r g b layout of loadOBJ.
+	 */
+	void benchCurves(bench::Runner &runner) {
+		const size_t count = 1024 * 1024;
+		const size_t stride = 6;
+		ft::Vector<float> vertices(count * stride);
+		for (size_t i = 0; i < count; ++i) {
+			vertices[i * stride] = static_cast<float>((i * 7919) % 1000) * 0.1f;
+			vertices[i * stride + 1] = static_cast<float>((i * 104729) % 997) * 0.1f;
+			vertices[i * stride + 2] = static_cast<float>((i * 1299709) % 991) * 0.1f;
+		}
+		ft::Vector<uint64_t> keys(count);
+		rt::curve::Quantizer quantizer = rt::curve::Quantizer::fromPoints(&vertices[0], stride, count);
+
+		runner.run("curve.morton.magic", [&]() {
+			rt::curve::mortonKeysKernel(false)(quantizer, &vertices[0], stride, &keys[0], count);
+			bench::doNotOptimize(keys);
+		}, count);
+		if (rt::curve::hasBmi2()) {
+			runner.run("curve.morton.bmi2", [&]() {
+				rt::curve::mortonKeysKernel(true)(quantizer, &vertices[0], stride, &keys[0], count);
+				bench::doNotOptimize(keys);
+			}, count);
+		}
+		runner.run("curve.hilbert", [&]() {
+			rt::curve::hilbertKeys(quantizer, &vertices[0], stride, &keys[0], count);
+			bench::doNotOptimize(keys);
+		}, count);
+		runner.run("curve.hilbert.threads", [&]() {
+			rt::curve::hilbertKeys(quantizer, &vertices[0], stride, &keys[0], count, 0);
+			bench::doNotOptimize(keys);
+		}, count);
+	}
+
+	void benchLarge(bench::Runner &runner) {
+		const size_t n = 256;
+		rt::RTMatrix<double> a(n, n);
+		rt::RTMatrix<double> spd(n, n);
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < n; ++j) {
+				a[i][j] = static_cast<double>((i * 7 + j * 3) % 13) / 13.0 - 0.5 + (i == j ? 4.0 : 0.0);
+				spd[i][j] = (i == j) ? static_cast<double>(n) : 1.0 / static_cast<double>(i + j + 1);
+			}
+		rt::RTMatrix<float> af(n, n);
+		for (size_t i = 0; i < n * n; ++i)
+			af.getData()[i] = static_cast<float>(a.getData()[i]);
+
+		runner.run("rtmatrix.mul256f", [&]() {
+			bench::doNotOptimize(af);
+			rt::RTMatrix<float> r = af * af;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtmatrix.mul256d", [&]() {
+			bench::doNotOptimize(a);
+			rt::RTMatrix<double> r = a * a;
+			bench::doNotOptimize(r);
+		});
+		runner.run("rtmatrix.inverse256d", [&]() {
+			rt::RTMatrix<double> r(a);
+			r.inverse();
+			bench::doNotOptimize(r);
+		});
+		runner.run("linalg.lu256d", [&]() {
+			bench::doNotOptimize(a);
+			rt::LU<double> lu(a, 1);
+			bench::doNotOptimize(lu);
+		});
+		runner.run("linalg.cholesky256d", [&]() {
+			bench::doNotOptimize(spd);
+			rt::Cholesky<double> cholesky(spd, 1);
+			bench::doNotOptimize(cholesky);
+		});
+	}
+
+	const char *argValue(const char *arg, const char *key) {
+		size_t len = std::strlen(key);
+		if (std::strncmp(arg, key, len) == 0)
+			return (arg + len);
+		return (NULL);
+	}
+}
+
+int main(int argc, char **argv) {
+	const char *filter = NULL;
+	double minTimeMs = 20.0;
+	size_t repetitions = 5;
+
+	for (int i = 1; i < argc; ++i) {
+		const char *value;
+		if ((value = argValue(argv[i], "--filter=")))
+			filter = value;
+		else if ((value = argValue(argv[i], "--min-time-ms=")))
+			minTimeMs = std::atof(value);
+		else if ((value = argValue(argv[i], "--repetitions=")))
+			repetitions = static_cast<size_t>(std::atol(value));
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--filter=substring] [--min-time-ms=N] [--repetitions=N]" << std::endl;
+			return (1);
+		}
+	}
+
+	bench::Runner runner(filter, minTimeMs, repetitions);
+	benchConstruction(runner);
+	benchMultiply(runner);
+	benchInverse(runner);
+	benchVectorOps(runner);
+	benchQuaternion(runner);
+	benchBatch(runner);
+	benchCulling(runner);
+	benchRays(runner);
+	benchFastMath(runner);
+	benchCurves(runner);
+	benchLarge(runner);
+	runner.printJson(std::cout, rt::simd::isaName(rt::simd::activeIsa()));
+	return (0);
+}
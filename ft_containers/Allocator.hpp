@@ -3,6 +3,8 @@
 
 #include <cstddef>
 #include <limits>
+#include <new>
+#include <utility>
 
 namespace ft {
 	template <class T>
@@ -43,14 +45,23 @@ namespace ft {
 			return (std::numeric_limits<size_type>::max() / sizeof(T));
 		};
 
+		// hint is a locality hint (a nearby pointer), not a size; it is ignored
 		pointer allocate(size_type num, const void * hint=0) {
-			return (pointer)(::operator new ((num + (size_t)hint) * sizeof(T)));
+			(void)hint;
+			if (num > max_size())
+				throw std::bad_alloc();
+			return (pointer)(::operator new (num * sizeof(T)));
 		};
 
 		void construct(pointer p, const_reference value) {
 			new((void*)p)T(value);
 		};
 
+		template <class... Args>
+		void construct(pointer p, Args&&... args) {
+			new((void*)p)T(std::forward<Args>(args)...);
+		};
+
 		void destroy(pointer p) {
 			p->~T();
 		};
@@ -0,0 +1,278 @@
+#ifndef ARENA_ALLOCATOR_HPP
+#define ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace ft {
+	struct ArenaStats
+	{
+		size_t	allocations;	// allocate calls since the last reset
+		size_t	deallocations;	// deallocate calls, which free nothing
+		size_t	bytesUsed;		// bytes handed out since the last reset, padding included
+		size_t	peakBytesUsed;	// largest bytesUsed over the arena's life
+		size_t	bytesReserved;	// bytes held in blocks
+		size_t	blocks;
+		size_t	resets;
+	};
+
+	/**
+	 * @brief Monotonic arena: allocation bumps a pointer through a chain of
+	 * blocks, deallocation is a no-op, and everything is given back at once.
+	 *
+	 * reset() rewinds to the first block and keeps the chain for the next load
+	 * or frame, in O(1); release() also returns the blocks to operator new.
+	 * Objects in the arena are not destroyed by either, so containers using
+	 * it must be destroyed (or be trivially destructible) before a reset.
+	 */
+	class Arena
+	{
+	private:
+		struct Block
+		{
+			Block	*next;
+			size_t	size;	// usable bytes after the header
+		};
+
+		static constexpr size_t HEADER = (sizeof(Block) + alignof(std::max_align_t) - 1)
+			& ~(alignof(std::max_align_t) - 1);
+
+		Block		*first;
+		Block		*current;
+		char		*cursor;
+		char		*limit;
+		size_t		blockSize;
+		ArenaStats	counters;
+
+		static char *data(Block *block) {
+			return (reinterpret_cast<char*>(block) + HEADER);
+		};
+
+		static char *alignUp(char *p, size_t align) {
+			uintptr_t address = reinterpret_cast<uintptr_t>(p);
+			return (p + ((align - address % align) % align));
+		};
+
+		void enter(Block *block) {
+			this->current = block;
+			this->cursor = data(block);
+			this->limit = this->cursor + block->size;
+		};
+
+		// Moves to the next kept block that fits, or links a new one after the
+		// current block.
+		void grow(size_t bytes, size_t align) {
+			size_t needed = bytes + align - 1;
+			Block *next = this->current ? this->current->next : this->first;
+			while (next && next->size < needed)
+				next = next->next;
+			if (next == NULL)
+			{
+				size_t size = needed > this->blockSize ? needed : this->blockSize;
+				next = static_cast<Block*>(::operator new(HEADER + size));
+				next->size = size;
+				if (this->current)
+				{
+					next->next = this->current->next;
+					this->current->next = next;
+				}
+				else
+				{
+					next->next = this->first;
+					this->first = next;
+				}
+				this->counters.bytesReserved += size;
+				++this->counters.blocks;
+			}
+			enter(next);
+		};
+
+	public:
+		explicit Arena(size_t blockSize = 64 * 1024)
+			: first(NULL), current(NULL), cursor(NULL), limit(NULL),
+			blockSize(blockSize ? blockSize : 1), counters() {};
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		~Arena() {
+			release();
+		};
+
+		/**
+		 * @brief bytes aligned to align, a power of two.
+		 */
+		void *allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+			char *result = this->cursor ? alignUp(this->cursor, align) : NULL;
+			if (result == NULL || result > this->limit || bytes > (size_t)(this->limit - result))
+			{
+				grow(bytes, align);
+				result = alignUp(this->cursor, align);
+			}
+			this->counters.bytesUsed += (result + bytes) - this->cursor;
+			if (this->counters.bytesUsed > this->counters.peakBytesUsed)
+				this->counters.peakBytesUsed = this->counters.bytesUsed;
+			++this->counters.allocations;
+			this->cursor = result + bytes;
+			return (result);
+		};
+
+		void deallocate(void *, size_t) {
+			++this->counters.deallocations;
+		};
+
+		void reset() {
+			if (this->first)
+				enter(this->first);
+			this->counters.allocations = 0;
+			this->counters.deallocations = 0;
+			this->counters.bytesUsed = 0;
+			++this->counters.resets;
+		};
+
+		void release() {
+			while (this->first)
+			{
+				Block *next = this->first->next;
+				::operator delete(static_cast<void*>(this->first));
+				this->first = next;
+			}
+			this->current = NULL;
+			this->cursor = NULL;
+			this->limit = NULL;
+			this->counters.bytesReserved = 0;
+			this->counters.blocks = 0;
+			reset();
+		};
+
+		const ArenaStats &stats() const {
+			return (this->counters);
+		};
+
+		/**
+		 * @brief Arena of the innermost ArenaScope on this thread, or NULL.
+		 */
+		static Arena *&scoped() {
+			static thread_local Arena *arena = NULL;
+			return (arena);
+		};
+	};
+
+	/**
+	 * @brief Makes arena the one default-constructed ArenaAllocators bind to
+	 * until the scope ends, for containers such as BasicString that take no
+	 * allocator argument.
+	 */
+	class ArenaScope
+	{
+	private:
+		Arena	*previous;
+
+	public:
+		explicit ArenaScope(Arena &arena) : previous(Arena::scoped()) {
+			Arena::scoped() = &arena;
+		};
+
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+
+		~ArenaScope() {
+			Arena::scoped() = this->previous;
+		};
+	};
+
+	/**
+	 * @brief Drop-in for ft::Allocator that allocates from an Arena. Without
+	 * an arena (none given and no ArenaScope open) it uses operator new like
+	 * ft::Allocator.
+	 */
+	template <class T>
+	class ArenaAllocator
+	{
+	private:
+		Arena	*_arena;
+
+	public:
+		typedef T			value_type;
+		typedef T*			pointer;
+		typedef T&			reference;
+		typedef const T*	const_pointer;
+		typedef const T&	const_reference;
+		typedef size_t		size_type;
+		typedef ptrdiff_t	difference_type;
+
+		template <class U>
+		struct rebind {
+			typedef ArenaAllocator<U> other;
+		};
+
+		pointer			address(reference value) const {
+			return &value;
+		};
+		const_pointer	address(const_reference value) const {
+			return &value;
+		};
+
+		ArenaAllocator() throw() : _arena(Arena::scoped()) {};
+		ArenaAllocator(Arena &arena) throw() : _arena(&arena) {};
+		ArenaAllocator(const ArenaAllocator& other) throw() : _arena(other._arena) {};
+		template <class U>
+		ArenaAllocator(const ArenaAllocator<U>& other) throw() : _arena(other.arena()) {};
+
+		~ArenaAllocator() throw() {};
+
+		ArenaAllocator& operator=(const ArenaAllocator&) = default;
+
+		Arena *arena() const {
+			return (_arena);
+		};
+
+		size_type max_size() const throw() {
+			return (std::numeric_limits<size_type>::max() / sizeof(T));
+		};
+
+		pointer allocate(size_type num, const void * hint=0) {
+			(void)hint;
+			if (num > max_size())
+				throw std::bad_alloc();
+			if (_arena)
+				return (pointer)(_arena->allocate(num * sizeof(T), alignof(T)));
+			return (pointer)(::operator new (num * sizeof(T)));
+		};
+
+		void construct(pointer p, const_reference value) {
+			new((void*)p)T(value);
+		};
+
+		template <class... Args>
+		void construct(pointer p, Args&&... args) {
+			new((void*)p)T(std::forward<Args>(args)...);
+		};
+
+		void destroy(pointer p) {
+			p->~T();
+		};
+
+		void deallocate(pointer p, size_type num) {
+			if (_arena)
+				_arena->deallocate(p, num * sizeof(T));
+			else
+				::operator delete((void*)p);
+		};
+	};
+
+	template <class T, class U>
+	bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+		return (lhs.arena() == rhs.arena());
+	}
+
+	template <class T, class U>
+	bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+		return (lhs.arena() != rhs.arena());
+	}
+}
+
+#endif // !ARENA_ALLOCATOR_HPP
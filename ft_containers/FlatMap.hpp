@@ -0,0 +1,479 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "reverse_iterator.hpp"
+#include "type_traits.hpp"
+#include "functional.hpp"
+#include "Pair.hpp"
+#include "Allocator.hpp"
+#include "Vector.hpp"
+
+namespace ft
+{
+	/**
+	 * @brief Sorted map in two contiguous arrays, keys and values, index by
+	 * index. Lookups are a branchless binary search over the keys alone; the
+	 * values are only read for the match.
+	 *
+	 * Meant for tables built once and read often: build from an unsorted
+	 * range (sorted and deduplicated in one pass) or reserve and insert.
+	 * Single inserts and erases shift the tail, O(n), and invalidate
+	 * iterators after the position.
+	 *
+	 * Iterators are random access and dereference to Pair<const Key&, T&>,
+	 * so it->first and it->second read like ft::Map's.
+	 */
+	template < class Key, class T, class Compare = less<Key>, class Alloc = Allocator<Pair<const Key,T> > >
+	class FlatMap
+	{
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef Pair<const key_type, mapped_type>		value_type;
+		typedef Compare									key_compare;
+		typedef Alloc									allocator_type;
+		typedef Pair<const key_type&, mapped_type&>		reference;
+		typedef Pair<const key_type&, const mapped_type&>	const_reference;
+		typedef std::ptrdiff_t							difference_type;
+		typedef size_t									size_type;
+
+		typedef typename Alloc::template rebind<key_type>::other		key_allocator_type;
+		typedef typename Alloc::template rebind<mapped_type>::other		mapped_allocator_type;
+		typedef Vector<key_type, key_allocator_type>					key_container_type;
+		typedef Vector<mapped_type, mapped_allocator_type>				mapped_container_type;
+
+		template <typename Tp, typename Ref>
+		class _FlatMap_iterator;
+
+		typedef _FlatMap_iterator<mapped_type, reference>				iterator;
+		typedef _FlatMap_iterator<const mapped_type, const_reference>	const_iterator;
+		typedef ft::reverse_iterator<iterator>							reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>					const_reverse_iterator;
+
+		class value_compare : ft::binary_function <value_type, value_type, bool>
+		{
+			public:
+				Compare comp;
+				value_compare (Compare c) : comp(c) {}
+
+				bool operator() (const value_type& x, const value_type& y) const
+				{
+					return comp(x.first, y.first);
+				}
+		};
+
+	private:
+		key_container_type		_keys;
+		mapped_container_type	_values;
+		key_compare				_comp;
+
+		// First index whose key is not less than k. The loop has a fixed
+		// trip count of log2(size) and compiles to a conditional move, so it
+		// never mispredicts; the prefetches fetch both possible next probes.
+		size_type lowerIndex(const key_type &k) const {
+			size_type len = _keys.size();
+			if (len == 0)
+				return (0);
+			const key_type *first = _keys.begin();
+			const key_type *base = first;
+			while (len > 1)
+			{
+				size_type half = len / 2;
+				__builtin_prefetch(base + half / 2);
+				__builtin_prefetch(base + half + half / 2);
+				base = _comp(base[half], k) ? base + half : base;
+				len -= half;
+			}
+			return ((base - first) + _comp(*base, k));
+		}
+
+		size_type findIndex(const key_type &k) const {
+			size_type i = lowerIndex(k);
+			if (i == _keys.size() || _comp(k, _keys[i]))
+				return (_keys.size());
+			return (i);
+		}
+
+		template <class V>
+		Pair<iterator, bool> insertAt(size_type i, const key_type &k, const V &v) {
+			_keys.insert(_keys.begin() + i, k);
+			try
+			{
+				_values.insert(_values.begin() + i, v);
+			}
+			catch(...)
+			{
+				_keys.erase(_keys.begin() + i);
+				throw;
+			}
+			return (Pair<iterator, bool>(begin() + i, true));
+		}
+
+	public:
+		explicit FlatMap (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _keys(key_allocator_type(alloc)), _values(mapped_allocator_type(alloc)), _comp(comp) {};
+
+		/**
+		 * @brief Bulk build: the range is sorted by key (stable, so the first
+		 * of equal keys wins, as with repeated insert) and deduplicated.
+		 */
+		template <class InputIterator>
+		FlatMap (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0)
+			: _keys(key_allocator_type(alloc)), _values(mapped_allocator_type(alloc)), _comp(comp)
+		{
+			Vector<value_type, allocator_type> items(alloc);
+			for (; first != last; ++first)
+				items.push_back(*first);
+			Vector<size_type> order;
+			order.resize_for_overwrite(items.size());
+			for (size_type i = 0; i < items.size(); ++i)
+				order[i] = i;
+			key_compare keyComp = _comp;
+			std::stable_sort(order.begin(), order.end(), [&](size_type a, size_type b) {
+				return (keyComp(items[a].first, items[b].first));
+			});
+			_keys.reserve(items.size());
+			_values.reserve(items.size());
+			for (size_type i = 0; i < order.size(); ++i)
+			{
+				const value_type &item = items[order[i]];
+				if (i && !_comp(_keys.back(), item.first))
+					continue ;
+				_keys.push_back(item.first);
+				_values.push_back(item.second);
+			}
+		};
+
+		FlatMap (const FlatMap& x) : _keys(x._keys), _values(x._values), _comp(x._comp) {};
+
+		FlatMap (FlatMap&& x) noexcept
+			: _keys(std::move(x._keys)), _values(std::move(x._values)), _comp(x._comp) {};
+
+		~FlatMap() {};
+
+		FlatMap& operator= (const FlatMap& x) {
+			if (this != &x)
+			{
+				_keys = x._keys;
+				_values = x._values;
+				_comp = x._comp;
+			}
+			return (*this);
+		};
+
+		FlatMap& operator= (FlatMap&& x) noexcept {
+			_keys = std::move(x._keys);
+			_values = std::move(x._values);
+			_comp = x._comp;
+			return (*this);
+		};
+
+		iterator begin() {
+			return (iterator(_keys.begin(), _values.begin()));
+		};
+		const_iterator begin() const {
+			return (const_iterator(_keys.begin(), _values.begin()));
+		};
+		iterator end() {
+			return (iterator(_keys.end(), _values.end()));
+		};
+		const_iterator end() const {
+			return (const_iterator(_keys.end(), _values.end()));
+		};
+		reverse_iterator rbegin() {
+			return (reverse_iterator(end()));
+		};
+		const_reverse_iterator rbegin() const {
+			return (const_reverse_iterator(end()));
+		};
+		reverse_iterator rend() {
+			return (reverse_iterator(begin()));
+		};
+		const_reverse_iterator rend() const {
+			return (const_reverse_iterator(begin()));
+		};
+
+		bool empty() const {
+			return (_keys.empty());
+		};
+
+		size_type size() const {
+			return (_keys.size());
+		};
+
+		size_type max_size() const {
+			return (_keys.max_size());
+		};
+
+		void reserve (size_type n) {
+			_keys.reserve(n);
+			_values.reserve(n);
+		};
+
+		mapped_type& operator[] (const key_type& k) {
+			size_type i = lowerIndex(k);
+			if (i == _keys.size() || _comp(k, _keys[i]))
+				insertAt(i, k, mapped_type());
+			return (_values[i]);
+		};
+
+		mapped_type& at (const key_type& k) {
+			size_type i = findIndex(k);
+			if (i == _keys.size())
+				throw std::out_of_range("flat_map");
+			return (_values[i]);
+		};
+
+		const mapped_type& at (const key_type& k) const {
+			size_type i = findIndex(k);
+			if (i == _keys.size())
+				throw std::out_of_range("flat_map");
+			return (_values[i]);
+		};
+
+		Pair<iterator, bool> insert (const value_type& val) {
+			size_type i = lowerIndex(val.first);
+			if (i != _keys.size() && !_comp(val.first, _keys[i]))
+				return (Pair<iterator, bool>(begin() + i, false));
+			return (insertAt(i, val.first, val.second));
+		};
+
+		// Keeps existing keys, like repeated insert; for large ranges building
+		// a new FlatMap from the merged items is cheaper.
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			for (; first != last; ++first)
+				insert(*first);
+		};
+
+		void erase (iterator position) {
+			size_type i = position - begin();
+			_keys.erase(_keys.begin() + i);
+			_values.erase(_values.begin() + i);
+		};
+
+		size_type erase (const key_type& k) {
+			size_type i = findIndex(k);
+			if (i == _keys.size())
+				return (0);
+			erase(begin() + i);
+			return (1);
+		};
+
+		void erase (iterator first, iterator last) {
+			size_type from = first - begin();
+			size_type to = last - begin();
+			_keys.erase(_keys.begin() + from, _keys.begin() + to);
+			_values.erase(_values.begin() + from, _values.begin() + to);
+		};
+
+		void swap (FlatMap& x) {
+			_keys.swap(x._keys);
+			_values.swap(x._values);
+			key_compare temp_comp = _comp;
+			_comp = x._comp;
+			x._comp = temp_comp;
+		};
+
+		void clear() {
+			_keys.clear();
+			_values.clear();
+		};
+
+		key_compare key_comp() const {
+			return (_comp);
+		};
+
+		value_compare value_comp() const {
+			return (value_compare(_comp));
+		};
+
+		iterator find (const key_type& k) {
+			return (begin() + findIndex(k));
+		};
+
+		const_iterator find (const key_type& k) const {
+			return (begin() + findIndex(k));
+		};
+
+		size_type count (const key_type& k) const {
+			return (findIndex(k) != _keys.size());
+		};
+
+		iterator lower_bound (const key_type& k) {
+			return (begin() + lowerIndex(k));
+		};
+
+		const_iterator lower_bound (const key_type& k) const {
+			return (begin() + lowerIndex(k));
+		};
+
+		iterator upper_bound (const key_type& k) {
+			size_type i = lowerIndex(k);
+			if (i != _keys.size() && !_comp(k, _keys[i]))
+				++i;
+			return (begin() + i);
+		};
+
+		const_iterator upper_bound (const key_type& k) const {
+			size_type i = lowerIndex(k);
+			if (i != _keys.size() && !_comp(k, _keys[i]))
+				++i;
+			return (begin() + i);
+		};
+
+		Pair<iterator,iterator> equal_range (const key_type& k) {
+			return (Pair<iterator,iterator>(lower_bound(k), upper_bound(k)));
+		};
+
+		Pair<const_iterator,const_iterator> equal_range (const key_type& k) const {
+			return (Pair<const_iterator,const_iterator>(lower_bound(k), upper_bound(k)));
+		};
+
+		/**
+		 * @brief The sorted keys, contiguous, for callers that search or scan
+		 * them directly.
+		 */
+		const key_container_type &keys() const {
+			return (_keys);
+		};
+
+		const mapped_container_type &values() const {
+			return (_values);
+		};
+
+		allocator_type get_allocator() const {
+			return (allocator_type(_keys.get_allocator()));
+		};
+
+		template <typename Tp, typename Ref>
+		class _FlatMap_iterator
+		{
+			private:
+				const key_type	*_key;
+				Tp				*_value;
+
+				// operator-> needs an address; the pair of references lives here
+				struct arrow
+				{
+					Ref	ref;
+					const Ref *operator->() const {return (&ref);};
+				};
+
+			public:
+				typedef _FlatMap_iterator<mapped_type, typename FlatMap::reference>	iterator;
+				typedef _FlatMap_iterator<Tp, Ref>					self;
+
+				typedef random_access_iterator_tag					iterator_category;
+				typedef typename FlatMap::value_type				value_type;
+				typedef std::ptrdiff_t								difference_type;
+				typedef arrow										pointer;
+				typedef Ref											reference;
+
+				_FlatMap_iterator() : _key(NULL), _value(NULL) {};
+				_FlatMap_iterator(const key_type *key, Tp *value) : _key(key), _value(value) {};
+				_FlatMap_iterator(const iterator& other) : _key(other.key()), _value(other.value()) {};
+				~_FlatMap_iterator() {};
+				self& operator= (const iterator& rhs) {
+					this->_key = rhs.key();
+					this->_value = rhs.value();
+					return (*this);
+				};
+
+				const key_type *key() const {return (this->_key);};
+				Tp *value() const {return (this->_value);};
+
+				reference operator*() const {
+					return (reference(*this->_key, *this->_value));
+				};
+
+				pointer operator->() const {
+					pointer p = {**this};
+					return (p);
+				};
+
+				reference operator[] (difference_type n) const {
+					return (*(*this + n));
+				};
+
+				self& operator++ () {
+					++this->_key;
+					++this->_value;
+					return (*this);
+				};
+
+				self operator++ (int) {
+					self tmp(*this);
+					++(*this);
+					return (tmp);
+				};
+
+				self& operator-- () {
+					--this->_key;
+					--this->_value;
+					return (*this);
+				};
+
+				self operator-- (int) {
+					self tmp(*this);
+					--(*this);
+					return (tmp);
+				};
+
+				self& operator+= (difference_type n) {
+					this->_key += n;
+					this->_value += n;
+					return (*this);
+				};
+
+				self& operator-= (difference_type n) {
+					return (*this += -n);
+				};
+
+				self operator+ (difference_type n) const {
+					self tmp(*this);
+					return (tmp += n);
+				};
+
+				self operator- (difference_type n) const {
+					self tmp(*this);
+					return (tmp -= n);
+				};
+
+				difference_type operator- (const self& other) const {
+					return (this->_key - other._key);
+				};
+
+				bool operator== (const self& other) const {return (this->_key == other._key);};
+				bool operator!= (const self& other) const {return (this->_key != other._key);};
+				bool operator< (const self& other) const {return (this->_key < other._key);};
+				bool operator> (const self& other) const {return (this->_key > other._key);};
+				bool operator<= (const self& other) const {return (this->_key <= other._key);};
+				bool operator>= (const self& other) const {return (this->_key >= other._key);};
+		};
+	};
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator== (const FlatMap<Key,T,Compare,Alloc>& lhs, const FlatMap<Key,T,Compare,Alloc>& rhs) {
+		return (lhs.keys() == rhs.keys() && lhs.values() == rhs.values());
+	}
+
+	template <class Key, class T, class Compare, class Alloc>
+	bool operator!= (const FlatMap<Key,T,Compare,Alloc>& lhs, const FlatMap<Key,T,Compare,Alloc>& rhs) {
+		return (!(lhs == rhs));
+	}
+
+	template <class Key, class T, class Compare, class Alloc>
+	void swap (FlatMap<Key,T,Compare,Alloc>& x, FlatMap<Key,T,Compare,Alloc>& y) {
+		x.swap(y);
+	}
+}
+
+#endif // !FLAT_MAP_HPP
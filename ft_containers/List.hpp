@@ -51,77 +51,60 @@ namespace ft
 	private:
 		allocator_type		_allocator;
 		size_type			_n;
+		// The value lives inside its node, so a node is one allocation from
+		// the allocator rebound to t_node.
 		typedef struct		s_node
 		{
 			pointer		data;
 			s_node		*next;
 			s_node		*prev;
+			alignas(T) unsigned char	storage[sizeof(T)];
 		}					t_node;
+		typedef typename Alloc::template rebind<t_node>::other	node_allocator_type;
+
+		node_allocator_type	_node_allocator;
 		t_node				*_begin;
 		t_node				*_end;
 
+		t_node *allocateNode() {
+			t_node *node = _node_allocator.allocate(1);
+			node->data = reinterpret_cast<pointer>(node->storage);
+			node->next = NULL;
+			node->prev = NULL;
+			return (node);
+		};
+
 		t_node *createNode(const value_type& val) {
-			pointer p;
-			t_node *node = NULL;
-			try
-			{
-				p = _allocator.allocate(1);
-			}
-			catch(...)
-			{
-				throw;
-			}
-			_allocator.construct(p, val);
+			t_node *node = allocateNode();
 			try
 			{
-				node = new t_node();
+				_allocator.construct(node->data, val);
 			}
 			catch(...)
 			{
-				_allocator.destroy(p);
-				_allocator.deallocate(p, 1);
+				_node_allocator.deallocate(node, 1);
 				throw;
 			}
-			if (node)
-			{
-				node->data = p;
-				node->next = NULL;
-				node->prev = NULL;
-			}
 			return (node);
 		};
 
 		void deleteNode(t_node *node)
 		{
 			_allocator.destroy(node->data);
-			_allocator.deallocate(node->data, -1);
-			delete node;
+			_node_allocator.deallocate(node, 1);
 		}
 
 		t_node *createEnd() {
-			t_node *node = NULL;
+			t_node *node = allocateNode();
 			try
 			{
-				node = new t_node();
+				_allocator.construct(node->data);
 			}
 			catch(...)
 			{
+				_node_allocator.deallocate(node, 1);
 				throw;
 			}
-			if (node)
-			{
-				try
-				{
-					node->data = new T();
-				}
-				catch(...)
-				{
-					delete node;
-					throw;
-				}
-				node->next = NULL;
-				node->prev = NULL;
-			}
 			return (node);
 		};
 
@@ -275,7 +258,8 @@ namespace ft
 		// CONSTRUCTORS
 		explicit List (const allocator_type& alloc = allocator_type())
 			:	_allocator(alloc),
-				_n(0)
+				_n(0),
+				_node_allocator(alloc)
 		{
 			try
 			{
@@ -291,7 +275,8 @@ namespace ft
 		explicit List (size_type n, const value_type& val = value_type(),
 			const allocator_type& alloc = allocator_type())
 			:	_allocator(alloc),
-				_n(0)
+				_n(0),
+				_node_allocator(alloc)
 		{
 			try
 			{
@@ -309,7 +294,8 @@ namespace ft
 		List (InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
 			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0)
 			:	_allocator(alloc),
-				_n(0)
+				_n(0),
+				_node_allocator(alloc)
 		{
 			try
 			{
@@ -325,7 +311,8 @@ namespace ft
 
 		List (const List& x)
 			:	_allocator(x._allocator),
-				_n(0)
+				_n(0),
+				_node_allocator(x._node_allocator)
 		{
 			try
 			{
@@ -344,20 +331,18 @@ namespace ft
 			while (_begin != _end)
 			{
 				t_node *temp = _begin->next;
-				_allocator.destroy(_begin->data);
-				_allocator.deallocate(_begin->data, -1);
-				delete _begin;
+				deleteNode(_begin);
 				_begin = temp;
 			}
-			delete _end->data;
-			delete _end;
+			deleteNode(_end);
 		};
 
 		//Operator =
 		List& operator= (const List& x) {
-			this->_allocator = x._allocator;
-			this->_begin = this->_end;
-			this->assign(x.begin(), x.end());
+			// the copy is built with x's allocators and takes our nodes, end
+			// node included, back to the ones that allocated them
+			List temp(x);
+			this->swap(temp);
 			return (*this);
 		};
 
@@ -492,9 +477,7 @@ namespace ft
 				t_node *temp = _begin;
 				_begin = _begin->next;
 				_begin->prev = NULL;
-				_allocator.destroy(temp->data);
-				_allocator.deallocate(temp->data, -1);
-				delete temp;
+				deleteNode(temp);
 				--_n;
 			}
 		};
@@ -534,9 +517,7 @@ namespace ft
 				else
 					_begin = _end;
 				this->_end->prev = last->prev;
-				_allocator.destroy(last->data);
-				_allocator.deallocate(last->data, -1);
-				delete last;
+				deleteNode(last);
 				--_n;
 			}
 		};
@@ -605,6 +586,12 @@ namespace ft
 		};
 
 		void swap (List& x) {
+			allocator_type temp_allocator = this->_allocator;
+			node_allocator_type temp_node_allocator = this->_node_allocator;
+			this->_allocator = x._allocator;
+			this->_node_allocator = x._node_allocator;
+			x._allocator = temp_allocator;
+			x._node_allocator = temp_node_allocator;
 			t_node *temp_begin = this->_begin;
 			t_node *temp_end = this->_end;
 			size_type temp_n = this->_n;
@@ -17,24 +17,12 @@
 #include "iterator.hpp"
 #include "reverse_iterator.hpp"
 #include "type_traits.hpp"
+#include "functional.hpp"
 #include "Pair.hpp"
 #include "Allocator.hpp"
 
 namespace ft
 {
-    template <class Arg1, class Arg2, class Result>
-    struct binary_function {
-        typedef Arg1 first_argument_type;
-        typedef Arg2 second_argument_type;
-        typedef Result result_type;
-    };
-
-    template <class T>
-    struct less : ft::binary_function <T,T,bool>
-    {
-        bool operator() (const T& x, const T& y) const { return x<y; }
-    };
-
     template < class Key, class T, class Compare = less<Key>, class Alloc = Allocator<Pair<const Key,T> > >
     class Map
     {
@@ -83,12 +71,14 @@ namespace ft
             node*       left;
             node*       right;
             value_type* val;
-
-            node() {};
-            ~node() {};
+            alignas(value_type) unsigned char storage[sizeof(value_type)];
         };
+        // the value lives inside its node: one allocation per node, from the
+        // allocator rebound to node
+        typedef typename Alloc::template rebind<node>::other    node_allocator_type;
 
         allocator_type          _allocator;
+        node_allocator_type     _node_allocator;
 
         key_compare     _comp;
         node*           _tree;
@@ -97,25 +87,17 @@ namespace ft
 
         node *createNode(key_type key, mapped_type data)
         {
-            node* p;
-            try
-            {
-                p = new node();
-            }
-            catch(...)
-            {
-                throw;
-            }
+            node* p = _node_allocator.allocate(1);
+            p->val = reinterpret_cast<value_type*>(p->storage);
             try
             {
-                p->val = _allocator.allocate(1);
+                _allocator.construct(p->val, key, data);
             }
             catch(...)
             {
-                delete p;
+                _node_allocator.deallocate(p, 1);
                 throw;
             }
-            _allocator.construct(p->val, value_type(key, data));
             p->is_red = false;
             p->is_nil = false;
             p->left = _nil;
@@ -127,8 +109,7 @@ namespace ft
         void deleteNode(node *n)
         {
             _allocator.destroy(n->val);
-            _allocator.deallocate(n->val, 1);
-            delete n;
+            _node_allocator.deallocate(n, 1);
         }
 
         node *createNil()
@@ -151,25 +132,17 @@ namespace ft
 
         node *cloneNode(node *prev_node)
         {
-            node* new_node;
+            node* new_node = _node_allocator.allocate(1);
+            new_node->val = reinterpret_cast<value_type*>(new_node->storage);
             try
             {
-                new_node = new node();
+                _allocator.construct(new_node->val, *prev_node->val);
             }
             catch(...)
             {
+                _node_allocator.deallocate(new_node, 1);
                 throw;
             }
-            try
-            {
-                new_node->val = _allocator.allocate(1);
-            }
-            catch(...)
-            {
-                delete new_node;
-                throw;
-            }
-            _allocator.construct(new_node->val, value_type(prev_node->val->first, prev_node->val->second));
             new_node->is_red = prev_node->is_red;
             new_node->is_nil = prev_node->is_nil;
             return (new_node);
@@ -561,7 +534,7 @@ namespace ft
 
     public:
         explicit Map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-            : _allocator(alloc), _comp(comp)
+            : _allocator(alloc), _node_allocator(alloc), _comp(comp)
         {
             try
             {
@@ -578,7 +551,7 @@ namespace ft
         template <class InputIterator>
         Map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
                 const allocator_type& alloc = allocator_type())
-            : _allocator(alloc), _comp(comp)
+            : _allocator(alloc), _node_allocator(alloc), _comp(comp)
         {
             try
             {
@@ -597,7 +570,7 @@ namespace ft
             }
         };
 
-        Map (const Map& x) : _allocator(x._allocator), _comp(x._comp), _size(x._size) {
+        Map (const Map& x) : _allocator(x._allocator), _node_allocator(x._node_allocator), _comp(x._comp), _size(x._size) {
             try
             {
                 _nil = createNil();
@@ -659,21 +632,17 @@ namespace ft
         };
 
         reverse_iterator rbegin() {
-            if (_tree == _nil)
-                return (rend());
-            return (reverse_iterator(rbTreeMax(_tree)));
+            return (reverse_iterator(end()));
         };
         const_reverse_iterator rbegin() const {
-            if (_tree == _nil)
-                return (rend());
-            return (const_reverse_iterator(rbTreeMax(_tree)));
+            return (const_reverse_iterator(end()));
         };
 
         reverse_iterator rend() {
-            return (reverse_iterator(_nil));
+            return (reverse_iterator(begin()));
         };
         const_reverse_iterator rend() const {
-            return (const_reverse_iterator(_nil));
+            return (const_reverse_iterator(begin()));
         };
 
         bool empty() const {
@@ -826,7 +795,13 @@ namespace ft
             node*       temp_tree = _tree;
             node*       temp_nil = _nil;
             size_type   temp_size = _size;
+            allocator_type      temp_allocator = _allocator;
+            node_allocator_type temp_node_allocator = _node_allocator;
 
+            this->_allocator = x._allocator;
+            this->_node_allocator = x._node_allocator;
+            x._allocator = temp_allocator;
+            x._node_allocator = temp_node_allocator;
             this->_comp = x._comp;
             this->_tree = x._tree;
             this->_nil = x._nil;
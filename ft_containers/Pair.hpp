@@ -25,6 +25,7 @@ namespace ft
 		second_type	second;
 
 		Pair() : first(T1()), second(T2()) {};
+		Pair (const Pair& pr) : first(pr.first), second(pr.second) {};
 		template<class U, class V>
 		Pair (const Pair<U, V>& pr) : first(pr.first), second(pr.second) {};
 		Pair (const first_type& a, const second_type& b) : first(a), second(b) {};
@@ -0,0 +1,370 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace ft {
+	struct NodePoolStats
+	{
+		size_t	blockSize;
+		size_t	liveBlocks;		// handed out and not yet freed
+		size_t	peakBlocks;
+		size_t	slabs;
+		size_t	bytesReserved;	// bytes held in slabs
+	};
+
+	/**
+	 * @brief Pool of same-sized blocks. Blocks are carved in order from slabs
+	 * of slabBytes; freed blocks go on an intrusive free list and are reused
+	 * first. Once every block is free the pool rewinds to carving from its
+	 * first slab, so a container rebuilt after a clear gets its nodes back in
+	 * address order. Slabs are only returned to operator new by release() or
+	 * the destructor. Not synchronized.
+	 */
+	class NodePool
+	{
+	private:
+		struct Slab
+		{
+			Slab	*next;
+		};
+		struct FreeBlock
+		{
+			FreeBlock	*next;
+		};
+
+		static constexpr size_t HEADER = (sizeof(Slab) + alignof(std::max_align_t) - 1)
+			& ~(alignof(std::max_align_t) - 1);
+
+		size_t			slabBytes;
+		Slab			*first;
+		Slab			*last;
+		Slab			*current;	// slab being carved, NULL before the first
+		FreeBlock		*freeList;
+		char			*cursor;
+		char			*limit;
+		NodePoolStats	counters;
+
+		size_t blocksPerSlab() const {
+			size_t blocks = (this->slabBytes - HEADER) / this->counters.blockSize;
+			return (blocks ? blocks : 1);
+		};
+
+		// Carves the next kept slab, or appends a new one.
+		void grow() {
+			Slab *slab = this->current ? this->current->next : this->first;
+			if (slab == NULL)
+			{
+				size_t bytes = HEADER + blocksPerSlab() * this->counters.blockSize;
+				slab = static_cast<Slab*>(::operator new(bytes));
+				slab->next = NULL;
+				if (this->last)
+					this->last->next = slab;
+				else
+					this->first = slab;
+				this->last = slab;
+				++this->counters.slabs;
+				this->counters.bytesReserved += bytes;
+			}
+			this->current = slab;
+			this->cursor = reinterpret_cast<char*>(slab) + HEADER;
+			this->limit = this->cursor + blocksPerSlab() * this->counters.blockSize;
+		};
+
+		void rewind() {
+			this->current = NULL;
+			this->freeList = NULL;
+			this->cursor = NULL;
+			this->limit = NULL;
+		};
+
+	public:
+		/**
+		 * @brief blockSize is rounded up to a multiple of alignof(max_align_t),
+		 * so every block is aligned like operator new memory.
+		 */
+		explicit NodePool(size_t blockSize = alignof(std::max_align_t), size_t slabBytes = 64 * 1024)
+			: slabBytes(slabBytes), first(NULL), last(NULL), current(NULL), freeList(NULL),
+			cursor(NULL), limit(NULL), counters() {
+			const size_t align = alignof(std::max_align_t);
+			this->counters.blockSize = blockSize ? (blockSize + align - 1) & ~(align - 1) : align;
+		};
+
+		NodePool(const NodePool&) = delete;
+		NodePool& operator=(const NodePool&) = delete;
+
+		~NodePool() {
+			release();
+		};
+
+		void *allocate() {
+			void *p;
+			if (this->freeList)
+			{
+				p = this->freeList;
+				this->freeList = this->freeList->next;
+			}
+			else
+			{
+				if (this->cursor == this->limit)
+					grow();
+				p = this->cursor;
+				this->cursor += this->counters.blockSize;
+			}
+			if (++this->counters.liveBlocks > this->counters.peakBlocks)
+				this->counters.peakBlocks = this->counters.liveBlocks;
+			return (p);
+		};
+
+		void deallocate(void *p) {
+			FreeBlock *block = static_cast<FreeBlock*>(p);
+			block->next = this->freeList;
+			this->freeList = block;
+			if (--this->counters.liveBlocks == 0)
+				rewind();
+		};
+
+		/**
+		 * @brief Frees every slab at once; blocks still in use become invalid.
+		 */
+		void release() {
+			while (this->first)
+			{
+				Slab *next = this->first->next;
+				::operator delete(static_cast<void*>(this->first));
+				this->first = next;
+			}
+			this->last = NULL;
+			rewind();
+			this->counters.liveBlocks = 0;
+			this->counters.slabs = 0;
+			this->counters.bytesReserved = 0;
+		};
+
+		const NodePoolStats &stats() const {
+			return (this->counters);
+		};
+	};
+
+	/**
+	 * @brief One NodePool per size class, in steps of alignof(max_align_t)
+	 * up to MAX_BLOCK bytes.
+	 */
+	class PoolSet
+	{
+	public:
+		static constexpr size_t GRANULE = alignof(std::max_align_t);
+		static constexpr size_t CLASSES = 32;
+		static constexpr size_t MAX_BLOCK = GRANULE * CLASSES;
+
+	private:
+		alignas(NodePool) unsigned char	storage[CLASSES * sizeof(NodePool)];
+		PoolSet							*nextSpare;
+
+		NodePool *pools() {
+			return (reinterpret_cast<NodePool*>(this->storage));
+		};
+
+		const NodePool *pools() const {
+			return (reinterpret_cast<const NodePool*>(this->storage));
+		};
+
+		// Sets left idle by exited threads, kept with their slabs for the
+		// next thread.
+		static std::mutex &spareLock() {
+			static std::mutex lock;
+			return (lock);
+		};
+
+		static PoolSet *&spares() {
+			static PoolSet *first = NULL;
+			return (first);
+		};
+
+		// Holds the calling thread's set and hands it back at thread exit.
+		struct LocalOwner
+		{
+			PoolSet	*pools;
+
+			LocalOwner() {
+				std::lock_guard<std::mutex> guard(spareLock());
+				this->pools = spares();
+				if (this->pools)
+					spares() = this->pools->nextSpare;
+				else
+					this->pools = new PoolSet();
+			};
+
+			~LocalOwner() {
+				// blocks still live belong to containers that outlive the
+				// thread; the set stays theirs, so it is neither reused nor
+				// freed
+				if (this->pools->liveBlocks() != 0)
+					return ;
+				std::lock_guard<std::mutex> guard(spareLock());
+				this->pools->nextSpare = spares();
+				spares() = this->pools;
+			};
+		};
+
+	public:
+		explicit PoolSet(size_t slabBytes = 64 * 1024) : nextSpare(NULL) {
+			for (size_t i = 0; i < CLASSES; ++i)
+				new((void*)(pools() + i)) NodePool((i + 1) * GRANULE, slabBytes);
+		};
+
+		PoolSet(const PoolSet&) = delete;
+		PoolSet& operator=(const PoolSet&) = delete;
+
+		~PoolSet() {
+			for (size_t i = 0; i < CLASSES; ++i)
+				pools()[i].~NodePool();
+		};
+
+		/**
+		 * @brief Pool for blocks of bytes, or NULL past MAX_BLOCK.
+		 */
+		NodePool *poolFor(size_t bytes) {
+			if (bytes == 0 || bytes > MAX_BLOCK)
+				return (NULL);
+			return (pools() + (bytes - 1) / GRANULE);
+		};
+
+		void release() {
+			for (size_t i = 0; i < CLASSES; ++i)
+				pools()[i].release();
+		};
+
+		size_t liveBlocks() const {
+			size_t live = 0;
+			for (size_t i = 0; i < CLASSES; ++i)
+				live += pools()[i].stats().liveBlocks;
+			return (live);
+		};
+
+		/**
+		 * @brief This thread's pool set. The pools are not synchronized, so
+		 * containers using it must be destroyed on the thread that built
+		 * them; freeing a node from another thread while this one runs is a
+		 * data race.
+		 *
+		 * When the thread exits with no blocks live, its set and slabs go to
+		 * the next thread that asks, so short-lived workers such as those of
+		 * rt::parallelFor reuse the same sets. A set with live blocks, e.g.
+		 * of a container with static storage, is kept alive for them instead.
+		 */
+		static PoolSet &local() {
+			static thread_local LocalOwner owner;
+			return (*owner.pools);
+		};
+	};
+
+	/**
+	 * @brief Drop-in for ft::Allocator for node containers: single-object
+	 * allocations, such as the nodes List and Map get through rebind, come
+	 * from the NodePool of their size class; arrays and oversized types go to
+	 * operator new. deallocate must be given the count passed to allocate.
+	 *
+	 * Default-constructed allocators use PoolSet::local(), which ties the
+	 * container to its thread; pass a PoolSet to group containers in pools
+	 * of their own.
+	 */
+	template <class T>
+	class PoolAllocator
+	{
+	private:
+		PoolSet	*_pools;
+
+		NodePool *poolFor(size_t num) const {
+			if (num != 1 || alignof(T) > PoolSet::GRANULE)
+				return (NULL);
+			return (_pools->poolFor(sizeof(T)));
+		};
+
+	public:
+		typedef T			value_type;
+		typedef T*			pointer;
+		typedef T&			reference;
+		typedef const T*	const_pointer;
+		typedef const T&	const_reference;
+		typedef size_t		size_type;
+		typedef ptrdiff_t	difference_type;
+
+		template <class U>
+		struct rebind {
+			typedef PoolAllocator<U> other;
+		};
+
+		pointer			address(reference value) const {
+			return &value;
+		};
+		const_pointer	address(const_reference value) const {
+			return &value;
+		};
+
+		PoolAllocator() : _pools(&PoolSet::local()) {};
+		PoolAllocator(PoolSet &pools) throw() : _pools(&pools) {};
+		PoolAllocator(const PoolAllocator& other) throw() : _pools(other._pools) {};
+		template <class U>
+		PoolAllocator(const PoolAllocator<U>& other) throw() : _pools(other.pools()) {};
+
+		~PoolAllocator() throw() {};
+
+		PoolAllocator& operator=(const PoolAllocator&) = default;
+
+		PoolSet *pools() const {
+			return (_pools);
+		};
+
+		size_type max_size() const throw() {
+			return (std::numeric_limits<size_type>::max() / sizeof(T));
+		};
+
+		pointer allocate(size_type num, const void * hint=0) {
+			(void)hint;
+			if (num > max_size())
+				throw std::bad_alloc();
+			NodePool *pool = poolFor(num);
+			if (pool)
+				return (pointer)(pool->allocate());
+			return (pointer)(::operator new (num * sizeof(T)));
+		};
+
+		void construct(pointer p, const_reference value) {
+			new((void*)p)T(value);
+		};
+
+		template <class... Args>
+		void construct(pointer p, Args&&... args) {
+			new((void*)p)T(std::forward<Args>(args)...);
+		};
+
+		void destroy(pointer p) {
+			p->~T();
+		};
+
+		void deallocate(pointer p, size_type num) {
+			NodePool *pool = poolFor(num);
+			if (pool)
+				pool->deallocate(p);
+			else
+				::operator delete((void*)p);
+		};
+	};
+
+	template <class T, class U>
+	bool operator==(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) {
+		return (lhs.pools() == rhs.pools());
+	}
+
+	template <class T, class U>
+	bool operator!=(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) {
+		return (lhs.pools() != rhs.pools());
+	}
+}
+
+#endif // !POOL_ALLOCATOR_HPP
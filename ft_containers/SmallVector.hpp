@@ -0,0 +1,511 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "iterator.hpp"
+#include "reverse_iterator.hpp"
+#include "type_traits.hpp"
+#include "Allocator.hpp"
+#include "vector_storage.hpp"
+
+namespace ft
+{
+	/**
+	 * @brief Vector with room for N elements inside the object. Up to N
+	 * elements never allocate; past that the elements move to the allocator
+	 * and stay there, so a cleared SmallVector keeps its heap capacity.
+	 *
+	 * Same interface as ft::Vector. Moving or swapping an inline SmallVector
+	 * moves its elements, so unlike ft::Vector it invalidates iterators.
+	 */
+	template <class T, size_t N, class Alloc = Allocator<T> >
+	class SmallVector
+	{
+		static_assert(N > 0, "SmallVector needs an inline capacity");
+
+	public:
+		typedef T											value_type;
+		typedef Alloc										allocator_type;
+		typedef T&											reference;
+		typedef const T&									const_reference;
+		typedef T*											pointer;
+		typedef const T*									const_pointer;
+		typedef typename Alloc::difference_type				difference_type;
+		typedef size_t										size_type;
+
+		typedef pointer										iterator;
+		typedef const_pointer								const_iterator;
+		typedef ft::reverse_iterator<iterator>				reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>		const_reverse_iterator;
+
+		static const size_type inline_capacity = N;
+
+	private:
+		allocator_type	_allocator;
+		pointer			_start;
+		pointer			_finish;
+		pointer			_end_of_storage;
+		alignas(T) unsigned char	_buffer[N * sizeof(T)];
+
+		pointer inlineStorage() {
+			return (reinterpret_cast<pointer>(_buffer));
+		}
+
+		void resetToInline() {
+			_start = inlineStorage();
+			_finish = _start;
+			_end_of_storage = _start + N;
+		}
+
+		void freeStorage() {
+			if (!is_inline())
+				_allocator.deallocate(_start, capacity());
+		}
+
+		// Frees the old storage for new_start, which holds the relocated
+		// elements and any appended ones past size().
+		void adoptStorage(pointer new_start, size_type new_max_size) {
+			size_type n = size();
+			freeStorage();
+			_start = new_start;
+			_finish = new_start + n;
+			_end_of_storage = new_start + new_max_size;
+		}
+
+		// Opens n raw slots at index, growing when full.
+		pointer openGap(size_type index, size_type n) {
+			if (n > capacity() - size())
+			{
+				size_type new_max_size = storage::growSize(_allocator, capacity(), size() + n, "small vector");
+				pointer new_start = _allocator.allocate(new_max_size);
+				size_type old_size = size();
+				try
+				{
+					storage::relocate(_allocator, _start, _finish, new_start, _start + index, n);
+				}
+				catch(...)
+				{
+					_allocator.deallocate(new_start, new_max_size);
+					throw;
+				}
+				freeStorage();
+				_start = new_start;
+				_finish = new_start + old_size;
+				_end_of_storage = new_start + new_max_size;
+			}
+			else if (index < size())
+			{
+				if constexpr (std::is_trivially_copyable<value_type>::value)
+					std::memmove((void*)(_start + index + n), (const void*)(_start + index),
+						(size() - index) * sizeof(value_type));
+				else
+				{
+					for (pointer p = _finish; p != _start + index; --p)
+					{
+						_allocator.construct(p - 1 + n, std::move(p[-1]));
+						_allocator.destroy(p - 1);
+					}
+				}
+			}
+			return (_start + index);
+		}
+
+		// Takes x's elements: its heap block if it has one, else a relocation
+		// into this object's inline storage. This must be empty and inline.
+		void steal(SmallVector& x) {
+			if (x.is_inline())
+			{
+				storage::relocate(_allocator, x._start, x._finish, _start);
+				_finish = _start + x.size();
+			}
+			else
+			{
+				_start = x._start;
+				_finish = x._finish;
+				_end_of_storage = x._end_of_storage;
+			}
+			x.resetToInline();
+		}
+
+	public:
+		explicit SmallVector (const allocator_type& alloc = allocator_type())
+		 : _allocator(alloc) {
+			resetToInline();
+		};
+
+		explicit SmallVector (size_type n, const value_type& val = value_type(),
+							const allocator_type& alloc = allocator_type())
+		 : _allocator(alloc) {
+			resetToInline();
+			assign(n, val);
+		};
+
+		template <class InputIterator>
+		SmallVector (InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0)
+		 : _allocator(alloc) {
+			resetToInline();
+			append(first, last);
+		};
+
+		SmallVector (const SmallVector& x) : _allocator(x._allocator) {
+			resetToInline();
+			append(x.begin(), x.end());
+		};
+
+		SmallVector (SmallVector&& x) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+		 : _allocator(x._allocator) {
+			resetToInline();
+			steal(x);
+		};
+
+		~SmallVector() {
+			storage::destroyRange(_allocator, _start, _finish);
+			freeStorage();
+		};
+
+		SmallVector& operator= (const SmallVector& x) {
+			if (this != &x)
+			{
+				clear();
+				append(x.begin(), x.end());
+			}
+			return (*this);
+		};
+
+		SmallVector& operator= (SmallVector&& x) noexcept(std::is_nothrow_move_constructible<value_type>::value) {
+			if (this != &x)
+			{
+				storage::destroyRange(_allocator, _start, _finish);
+				freeStorage();
+				resetToInline();
+				this->_allocator = x._allocator;
+				steal(x);
+			}
+			return (*this);
+		};
+
+		iterator begin() {
+			return (_start);
+		};
+
+		const_iterator begin() const {
+			return (_start);
+		};
+
+		iterator end() {
+			return (_finish);
+		};
+
+		const_iterator end() const {
+			return (_finish);
+		};
+
+		reverse_iterator rbegin() {
+			return (reverse_iterator(_finish));
+		};
+
+		const_reverse_iterator rbegin() const {
+			return (const_reverse_iterator(_finish));
+		};
+
+		reverse_iterator rend() {
+			return (reverse_iterator(_start));
+		};
+
+		const_reverse_iterator rend() const {
+			return (const_reverse_iterator(_start));
+		};
+
+		size_type size() const {
+			return (_finish - _start);
+		};
+
+		size_type max_size() const {
+			return (std::numeric_limits<size_type>::max() / sizeof(T));
+		};
+
+		size_type capacity() const {
+			return (_end_of_storage - _start);
+		};
+
+		bool empty() const {
+			return (_start == _finish);
+		};
+
+		/**
+		 * @brief True while the elements are in the inline buffer.
+		 */
+		bool is_inline() const {
+			return ((const void*)_start == (const void*)_buffer);
+		};
+
+		void reserve (size_type n) {
+			if (n > capacity())
+			{
+				if (n > _allocator.max_size())
+					throw std::length_error("small vector");
+				adoptStorage(storage::allocateRelocated(_allocator, n, _start, _finish, 0,
+					[](pointer) {}), n);
+			}
+		};
+
+		void resize (size_type n, value_type val = value_type()) {
+			if (n > size())
+				insert(end(), n - size(), val);
+			else
+				erase(begin() + n, end());
+		};
+
+		reference operator[] (size_type n) {
+			return (_start[n]);
+		};
+
+		const_reference operator[] (size_type n) const {
+			return (_start[n]);
+		};
+
+		reference at (size_type n) {
+			if (n >= size())
+				throw std::out_of_range("small vector");
+			return (_start[n]);
+		};
+
+		const_reference at (size_type n) const {
+			if (n >= size())
+				throw std::out_of_range("small vector");
+			return (_start[n]);
+		};
+
+		reference front() {
+			return (*_start);
+		};
+
+		const_reference front() const {
+			return (*_start);
+		};
+
+		reference back() {
+			return (_finish[-1]);
+		};
+
+		const_reference back() const {
+			return (_finish[-1]);
+		};
+
+		pointer data() {
+			return (_start);
+		};
+
+		const_pointer data() const {
+			return (_start);
+		};
+
+		template <class InputIterator>
+		void assign (InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			clear();
+			append(first, last);
+		};
+
+		void assign (size_type n, const value_type& val) {
+			value_type copy(val);
+			clear();
+			insert(end(), n, copy);
+		};
+
+		void push_back (const value_type& val) {
+			emplace_back(val);
+		};
+
+		void push_back (value_type&& val) {
+			emplace_back(std::move(val));
+		};
+
+		// When full, the new element is built in the new storage before the old
+		// ones are relocated, so args may refer into this vector.
+		template <class... Args>
+		reference emplace_back (Args&&... args) {
+			if (_finish == _end_of_storage)
+			{
+				size_type new_max_size = storage::growSize(_allocator, capacity(), size() + 1, "small vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, 1,
+					[&](pointer slot) { _allocator.construct(slot, std::forward<Args>(args)...); }), new_max_size);
+			}
+			else
+				_allocator.construct(_finish, std::forward<Args>(args)...);
+			return (*_finish++);
+		};
+
+		// Appends [first, last) with one capacity check; the range may come
+		// from this vector.
+		template <class InputIterator>
+		void append (InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			size_type n = last - first;
+			if (n == 0)
+				return ;
+			if (n > capacity() - size())
+			{
+				size_type new_max_size = storage::growSize(_allocator, capacity(), size() + n, "small vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, n,
+					[&](pointer slot) { storage::copyRange(_allocator, first, last, slot); }), new_max_size);
+			}
+			else
+				storage::copyRange(_allocator, first, last, _finish);
+			_finish += n;
+		};
+
+		// Appends n default-initialized elements and returns the first one, for
+		// the caller to fill in. Trivial types are left unwritten.
+		pointer append_uninitialized (size_type n) {
+			if (n > capacity() - size())
+			{
+				size_type new_max_size = storage::growSize(_allocator, capacity(), size() + n, "small vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, 0,
+					[](pointer) {}), new_max_size);
+			}
+			pointer first = _finish;
+			for (size_type i = 0; i < n; ++i)
+			{
+				::new((void*)_finish) value_type;
+				++_finish;
+			}
+			return (first);
+		};
+
+		void resize_for_overwrite (size_type n) {
+			if (n > size())
+			{
+				reserve(n);
+				append_uninitialized(n - size());
+			}
+			else
+				erase(begin() + n, end());
+		};
+
+		void pop_back() {
+			--_finish;
+			_allocator.destroy(_finish);
+		};
+
+		iterator insert (iterator position, const value_type& val) {
+			value_type copy(val);
+			pointer p = openGap(position - _start, 1);
+			_allocator.construct(p, std::move(copy));
+			++_finish;
+			return (p);
+		};
+
+		void insert (iterator position, size_type n, const value_type& val) {
+			if (n == 0)
+				return ;
+			value_type copy(val);
+			pointer p = openGap(position - _start, n);
+			for (size_type i = 0; i < n; ++i)
+				_allocator.construct(p + i, copy);
+			_finish += n;
+		};
+
+		template <class InputIterator>
+		void insert (iterator position, InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			size_type n = last - first;
+			if (n == 0)
+				return ;
+			pointer p = openGap(position - _start, n);
+			storage::copyRange(_allocator, first, last, p);
+			_finish += n;
+		};
+
+		iterator erase (iterator position) {
+			return (erase(position, position + 1));
+		};
+
+		iterator erase (iterator first, iterator last) {
+			if (first == last)
+				return (first);
+			pointer new_finish = std::move(last, _finish, first);
+			storage::destroyRange(_allocator, new_finish, _finish);
+			_finish = new_finish;
+			return (first);
+		};
+
+		void swap (SmallVector& x) {
+			if (!is_inline() && !x.is_inline())
+			{
+				std::swap(_start, x._start);
+				std::swap(_finish, x._finish);
+				std::swap(_end_of_storage, x._end_of_storage);
+				std::swap(_allocator, x._allocator);
+				return ;
+			}
+			SmallVector temp(std::move(x));
+			x = std::move(*this);
+			*this = std::move(temp);
+		};
+
+		void clear() {
+			storage::destroyRange(_allocator, _start, _finish);
+			_finish = _start;
+		};
+
+		allocator_type get_allocator() const {
+			return (_allocator);
+		};
+	};
+
+	template <class T, size_t N, class Alloc>
+	bool operator== (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		if (lhs.size() != rhs.size())
+			return (false);
+		for (size_t i = 0; i < lhs.size(); ++i)
+			if (!(lhs[i] == rhs[i]))
+				return (false);
+		return (true);
+	}
+
+	template <class T, size_t N, class Alloc>
+	bool operator!= (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		return (!(lhs == rhs));
+	}
+
+	template <class T, size_t N, class Alloc>
+	bool operator< (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		for (size_t i = 0; i < lhs.size() && i < rhs.size(); ++i)
+		{
+			if (lhs[i] < rhs[i])
+				return (true);
+			if (rhs[i] < lhs[i])
+				return (false);
+		}
+		return (lhs.size() < rhs.size());
+	}
+
+	template <class T, size_t N, class Alloc>
+	bool operator<= (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		return (!(rhs < lhs));
+	}
+
+	template <class T, size_t N, class Alloc>
+	bool operator> (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		return (rhs < lhs);
+	}
+
+	template <class T, size_t N, class Alloc>
+	bool operator>= (const SmallVector<T,N,Alloc>& lhs, const SmallVector<T,N,Alloc>& rhs) {
+		return (!(lhs < rhs));
+	}
+
+	template <class T, size_t N, class Alloc>
+	void swap (SmallVector<T,N,Alloc>& x, SmallVector<T,N,Alloc>& y) {
+		x.swap(y);
+	}
+}
+
+#endif // !SMALL_VECTOR_HPP
@@ -29,10 +29,20 @@ namespace ft
 		static const size_t npos = -1;
 
 	private:
+		// Strings up to LOCAL_CAPACITY chars live in local, inside the object,
+		// and never allocate; c_string points there or at a heap buffer of
+		// cap + 1 chars.
+		static const size_type LOCAL_CAPACITY = 3 * sizeof(size_type) / sizeof(charT) - 1;
+
 		size_type		len;
 		value_type		*c_string;
-		allocator_type	allocator;
 		value_type		*c_end;
+		union
+		{
+			size_type	cap;
+			value_type	local[LOCAL_CAPACITY + 1];
+		};
+		[[no_unique_address]] allocator_type	allocator;
 
 		size_type	strlen(const_pointer str) const
 		{
@@ -42,11 +52,28 @@ namespace ft
 			return (tail - str);
 		}
 
+		bool isLocal() const {
+			return (this->c_string == this->local);
+		}
+
+		// Points c_string at storage for n chars and the terminator; the
+		// contents are left to the caller.
+		void allocateCString(size_type n) {
+			if (n <= LOCAL_CAPACITY)
+				this->c_string = this->local;
+			else
+			{
+				this->c_string = this->allocator.allocate(n + 1);
+				this->cap = n;
+			}
+		}
+
 		void deleteBasicString() {
 			if (this->c_string)
 			{
 				destroyCString(this->c_string);
-				this->allocator.deallocate(this->c_string, 0);
+				if (!isLocal())
+					this->allocator.deallocate(this->c_string, this->cap + 1);
 				this->len = -1;
 				this->c_end = NULL;
 			}
@@ -69,7 +96,7 @@ namespace ft
 
 		void copyCString(const_pointer s, size_type n) {
 			this->len = n;
-			this->c_string = this->allocator.allocate(this->len + 1);
+			allocateCString(n);
 			pointer dst = this->c_string;
 			pointer src = const_cast<pointer>(s);
 			size_type i = 0;
@@ -81,8 +108,26 @@ namespace ft
 			this->c_end = dst + i;
 		}
 
+		// Replaces the contents with n chars from s, in place when they fit;
+		// s may point into this string.
+		void assignCString(const_pointer s, size_type n) {
+			if (n > capacity())
+			{
+				// built with our allocator, so the swap below keeps it
+				BasicString temp;
+				temp.allocator = this->allocator;
+				temp.copyCString(s, n);
+				swap(temp);
+				return;
+			}
+			this->memmove(this->c_string, s, n);
+			this->c_string[n] = '\0';
+			this->len = n;
+			this->c_end = this->c_string + n;
+		}
+
 		void copyNChars(size_type n, charT c) {
-			this->c_string = this->allocator.allocate(n + 1);
+			allocateCString(n);
 			this->len = n;
 			pointer dst = this->c_string;
 			size_type i = 0;
@@ -105,28 +150,39 @@ namespace ft
 			destroyCString(this->c_end + 1);
 		}
 
-		void resizeToGreater(size_type n) {
-			size_type new_len = n;
-			pointer new_str = allocator.allocate(this->len + n + 1);
+		// Moves the contents to a buffer for new_cap chars.
+		void reallocate(size_type new_cap) {
+			pointer new_str = allocator.allocate(new_cap + 1);
 			size_type i = 0;
-			while (i < this->len) {
+			while (i <= this->len) {
 				*(new_str + i) = *(this->c_string + i);
 				++i;
 			}
-			while (i < new_len) {
-				*(new_str + i) = '\0';
-				++i;
-			}
-			*(new_str + i) = '\0';
+			size_type old_len = this->len;
 			deleteBasicString();
 			this->c_string = new_str;
-			this->len = new_len;
+			this->cap = new_cap;
+			this->len = old_len;
+			this->c_end = c_string + this->len;
+		}
+
+		// Grows to n chars, the new ones '\0'. The buffer at least doubles
+		// when it has to move, so appending char by char is amortized O(1).
+		void resizeToGreater(size_type n) {
+			if (n > capacity())
+				reallocate(n > 2 * capacity() ? n : 2 * capacity());
+			size_type i = this->len;
+			while (i <= n) {
+				*(this->c_string + i) = '\0';
+				++i;
+			}
+			this->len = n;
 			this->c_end = c_string + this->len;
 		}
 
 		void initEmptyString() {
 			this->len = 0;
-			this->c_string = this->allocator.allocate(1);
+			this->c_string = this->local;
 			this->allocator.construct(this->c_string, '\0');
 			this->c_end = this->c_string;
 		};
@@ -144,7 +200,15 @@ namespace ft
 			size_type first_len = this->len;
 			size_type second_len = sublen;
 			size_type sum_len = first_len + second_len;
-			resizeToGreater(sum_len);
+			// appending part of this string: the buffer may move
+			if (substr >= this->c_string && substr <= this->c_end)
+			{
+				size_type offset = substr - this->c_string;
+				resizeToGreater(sum_len);
+				substr = this->c_string + offset;
+			}
+			else
+				resizeToGreater(sum_len);
 			size_type i = first_len;
 			while (i < sum_len) {
 				this->c_string[i] = *substr;
@@ -231,7 +295,7 @@ namespace ft
 
 		size_type	strncmp(const charT *s1, const charT *s2, size_type n1, size_type n2) const
 		{
-			int n = n1 > n2 ? n1 : n2;
+			size_type n = n1 > n2 ? n1 : n2;
 			for (size_type i = 0; i < n; ++i)
 				if (s1[i] != s2[i])
 					return (s1[i] - s2[i]);
@@ -351,14 +415,31 @@ namespace ft
 			copyCString(str.c_string, str.length());
 		};
 
+		BasicString(BasicString&& str) noexcept : allocator(str.allocator) {
+			this->len = str.len;
+			if (str.isLocal())
+			{
+				this->c_string = this->local;
+				for (size_type i = 0; i <= str.len; ++i)
+					this->local[i] = str.local[i];
+			}
+			else
+			{
+				this->c_string = str.c_string;
+				this->cap = str.cap;
+			}
+			this->c_end = this->c_string + this->len;
+			str.initEmptyString();
+		};
+
 		BasicString(const BasicString& str, size_t pos, size_t len = npos) {
 			if (pos > str.len)
 				throw std::out_of_range("pos > str length");
-			if (pos + len > str.len)
-				this->len = len - pos;
+			if (len > str.len - pos)
+				this->len = str.len - pos;
 			else
 				this->len = len;
-			this->c_string = this->allocator.allocate(this->len + 1);
+			allocateCString(this->len);
 			pointer dst = this->c_string;
 			pointer src = const_cast<pointer>(str.c_string + pos);
 			size_type i = 0;
@@ -375,7 +456,7 @@ namespace ft
 		};
 
 		BasicString(const charT* s, size_t n) {
-			this->c_string = this->allocator.allocate(n + 1);
+			allocateCString(n);
 			this->len = n;
 			pointer dst = this->c_string;
 			pointer src = const_cast<pointer>(s);
@@ -399,7 +480,7 @@ namespace ft
 			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0
 		) {
 			this->len = last - first;
-			this->c_string = this->allocator.allocate(this->len + 1);
+			allocateCString(this->len);
 			pointer dst = this->c_string;
 			while (first != last) {
 				this->allocator.construct(dst, *first);
@@ -415,22 +496,26 @@ namespace ft
 		};
 
 		BasicString& operator= (const BasicString& str) {
-			// if (*this == str)
-			// 	return *this;
-			deleteBasicString();
-			copyCString(str.c_string, str.length());
+			assignCString(str.c_string, str.length());
+			return *this;
+		};
+
+		BasicString& operator= (BasicString&& str) noexcept {
+			if (this != &str)
+			{
+				BasicString temp(static_cast<BasicString&&>(str));
+				swap(temp);
+			}
 			return *this;
 		};
 
 		BasicString& operator= (const charT* s) {
-			deleteBasicString();
-			copyCString(s);
+			assignCString(s, this->strlen(s));
 			return *this;
 		};
 
 		BasicString& operator= (charT c) {
-			deleteBasicString();
-			copyNChars(1, c);
+			assignCString(&c, 1);
 			return *this;
 		};
 
@@ -501,16 +586,20 @@ namespace ft
 		};
 
 		size_type capacity() const {
-			return this->len;
+			return (isLocal() ? LOCAL_CAPACITY : this->cap);
 		};
 
-		void reserve(size_type) {
-			return;
+		void reserve(size_type n) {
+			if (n > capacity())
+				reallocate(n);
 		};
 
+		// keeps the buffer, like std::string
 		void clear() {
-			deleteBasicString();
-			initEmptyString();
+			destroyCString(this->c_string);
+			this->len = 0;
+			this->allocator.construct(this->c_string, '\0');
+			this->c_end = this->c_string;
 		};
 
 		bool empty() const {
@@ -593,8 +682,7 @@ namespace ft
 		}
 
 		BasicString& assign (const BasicString& str) {
-			deleteBasicString();
-			copyCString(str.c_string);
+			assignCString(str.c_string, str.len);
 			return (*this);
 		};
 
@@ -608,14 +696,12 @@ namespace ft
 		};
 
 		BasicString& assign (const charT* s) {
-			deleteBasicString();
-			copyCString(s);
+			assignCString(s, this->strlen(s));
 			return (*this);
 		};
 
 		BasicString& assign (const charT* s, size_type n) {
-			deleteBasicString();
-			copyCString(s, n);
+			assignCString(s, n);
 			return (*this);
 		};
 
@@ -733,17 +819,47 @@ namespace ft
 		};
 
 		void swap(BasicString& str) {
-			charT *temp_str = str.c_string;
-			charT *temp_end = str.c_end;
+			if (!this->isLocal() && !str.isLocal())
+			{
+				charT *temp_str = str.c_string;
+				size_type temp_cap = str.cap;
+				str.c_string = this->c_string;
+				str.cap = this->cap;
+				this->c_string = temp_str;
+				this->cap = temp_cap;
+			}
+			else if (this->isLocal() && str.isLocal())
+			{
+				for (size_type i = 0; i <= LOCAL_CAPACITY; ++i)
+				{
+					charT temp = str.local[i];
+					str.local[i] = this->local[i];
+					this->local[i] = temp;
+				}
+			}
+			else
+			{
+				// the inline chars move into the other object's local, which
+				// overlaps its cap, so read the heap side first
+				BasicString &heap = this->isLocal() ? str : *this;
+				BasicString &inline_str = this->isLocal() ? *this : str;
+				charT *heap_str = heap.c_string;
+				size_type heap_cap = heap.cap;
+				for (size_type i = 0; i <= inline_str.len; ++i)
+					heap.local[i] = inline_str.local[i];
+				heap.c_string = heap.local;
+				inline_str.c_string = heap_str;
+				inline_str.cap = heap_cap;
+			}
 			size_type temp_len = str.len;
-
-			str.c_string = this->c_string;
-			str.c_end = this->c_end;
 			str.len = this->len;
-
-			this->c_string = temp_str;
-			this->c_end = temp_end;
 			this->len = temp_len;
+			str.c_end = str.c_string + str.len;
+			this->c_end = this->c_string + this->len;
+			// a heap buffer goes back to the allocator that made it
+			allocator_type temp_allocator = str.allocator;
+			str.allocator = this->allocator;
+			this->allocator = temp_allocator;
 		}
 
 		const char* c_str() const {
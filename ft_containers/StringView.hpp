@@ -0,0 +1,329 @@
+#ifndef FT_STRING_VIEW_HPP
+#define FT_STRING_VIEW_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include "reverse_iterator.hpp"
+#include "Pair.hpp"
+
+namespace ft
+{
+	template <class charT, class Alloc>
+	class BasicString;
+
+	/**
+	 * @brief Non-owning, read-only view of charT[size]. The characters are
+	 * not NUL-terminated in general, so data() must not be passed where a C
+	 * string is expected. The viewed buffer has to outlive the view.
+	 */
+	template <class charT>
+	class BasicStringView
+	{
+	public:
+		typedef charT									value_type;
+		typedef const charT&							reference;
+		typedef const charT&							const_reference;
+		typedef const charT*							pointer;
+		typedef const charT*							const_pointer;
+		typedef const_pointer							iterator;
+		typedef const_pointer							const_iterator;
+		typedef ft::reverse_iterator<const_iterator>	reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef std::ptrdiff_t							difference_type;
+		typedef size_t									size_type;
+
+		static const size_type npos = -1;
+
+	private:
+		const_pointer	str;
+		size_type		len;
+
+		static size_type strlen(const_pointer s) {
+			const_pointer tail = s;
+			while (*tail != '\0')
+				tail++;
+			return (tail - s);
+		}
+
+		static bool isSpace(charT c) {
+			return (c == ' ' || (c >= '\t' && c <= '\r'));
+		}
+
+		static bool contains(BasicStringView set, charT c) {
+			for (size_type i = 0; i < set.len; ++i)
+				if (set.str[i] == c)
+					return (true);
+			return (false);
+		}
+
+	public:
+		BasicStringView() : str(NULL), len(0) {};
+		BasicStringView(const_pointer s, size_type n) : str(s), len(n) {};
+		BasicStringView(const_pointer s) : str(s), len(strlen(s)) {};
+		BasicStringView(const_pointer first, const_pointer last) : str(first), len(last - first) {};
+
+		template <class Alloc>
+		BasicStringView(const BasicString<charT, Alloc>& s) : str(s.data()), len(s.size()) {};
+
+		const_iterator begin() const {
+			return (this->str);
+		};
+		const_iterator end() const {
+			return (this->str + this->len);
+		};
+		const_reverse_iterator rbegin() const {
+			return (const_reverse_iterator(end()));
+		};
+		const_reverse_iterator rend() const {
+			return (const_reverse_iterator(begin()));
+		};
+
+		size_type size() const {
+			return (this->len);
+		};
+		size_type length() const {
+			return (this->len);
+		};
+		bool empty() const {
+			return (this->len == 0);
+		};
+		const_pointer data() const {
+			return (this->str);
+		};
+
+		const_reference operator[] (size_type pos) const {
+			return (this->str[pos]);
+		};
+		const_reference at (size_type pos) const {
+			if (pos >= this->len)
+				throw std::out_of_range("pos > view length");
+			return (this->str[pos]);
+		};
+		const_reference front() const {
+			return (this->str[0]);
+		};
+		const_reference back() const {
+			return (this->str[this->len - 1]);
+		};
+
+		void remove_prefix(size_type n) {
+			this->str += n;
+			this->len -= n;
+		};
+		void remove_suffix(size_type n) {
+			this->len -= n;
+		};
+
+		BasicStringView substr(size_type pos = 0, size_type n = npos) const {
+			if (pos > this->len)
+				throw std::out_of_range("pos > view length");
+			if (n > this->len - pos)
+				n = this->len - pos;
+			return (BasicStringView(this->str + pos, n));
+		};
+
+		int compare(BasicStringView other) const {
+			size_type n = this->len < other.len ? this->len : other.len;
+			for (size_type i = 0; i < n; ++i)
+				if (this->str[i] != other.str[i])
+					return (this->str[i] < other.str[i] ? -1 : 1);
+			if (this->len == other.len)
+				return (0);
+			return (this->len < other.len ? -1 : 1);
+		};
+
+		bool starts_with(BasicStringView prefix) const {
+			return (this->len >= prefix.len && substr(0, prefix.len).compare(prefix) == 0);
+		};
+		bool starts_with(charT c) const {
+			return (this->len && this->str[0] == c);
+		};
+		bool ends_with(BasicStringView suffix) const {
+			return (this->len >= suffix.len && substr(this->len - suffix.len).compare(suffix) == 0);
+		};
+		bool ends_with(charT c) const {
+			return (this->len && this->str[this->len - 1] == c);
+		};
+
+		size_type find(BasicStringView s, size_type pos = 0) const {
+			if (s.len > this->len)
+				return (npos);
+			for (size_type i = pos; i <= this->len - s.len; ++i)
+				if (BasicStringView(this->str + i, s.len).compare(s) == 0)
+					return (i);
+			return (npos);
+		};
+		size_type find(charT c, size_type pos = 0) const {
+			for (size_type i = pos; i < this->len; ++i)
+				if (this->str[i] == c)
+					return (i);
+			return (npos);
+		};
+		size_type rfind(BasicStringView s, size_type pos = npos) const {
+			if (s.len > this->len)
+				return (npos);
+			size_type i = this->len - s.len;
+			if (pos < i)
+				i = pos;
+			for (; i != npos; --i)
+				if (BasicStringView(this->str + i, s.len).compare(s) == 0)
+					return (i);
+			return (npos);
+		};
+		size_type rfind(charT c, size_type pos = npos) const {
+			if (this->len == 0)
+				return (npos);
+			size_type i = pos < this->len ? pos : this->len - 1;
+			for (; i != npos; --i)
+				if (this->str[i] == c)
+					return (i);
+			return (npos);
+		};
+		size_type find_first_of(BasicStringView set, size_type pos = 0) const {
+			for (size_type i = pos; i < this->len; ++i)
+				if (contains(set, this->str[i]))
+					return (i);
+			return (npos);
+		};
+		size_type find_first_not_of(BasicStringView set, size_type pos = 0) const {
+			for (size_type i = pos; i < this->len; ++i)
+				if (!contains(set, this->str[i]))
+					return (i);
+			return (npos);
+		};
+
+		/**
+		 * @brief The parts before and after the first delim, which belongs to
+		 * neither; without a delim, the whole view and an empty one.
+		 */
+		Pair<BasicStringView, BasicStringView> split(charT delim) const {
+			size_type pos = find(delim);
+			if (pos == npos)
+				return (Pair<BasicStringView, BasicStringView>(*this, BasicStringView(end(), size_type(0))));
+			return (Pair<BasicStringView, BasicStringView>(BasicStringView(this->str, pos),
+				BasicStringView(this->str + pos + 1, this->len - pos - 1)));
+		};
+
+		BasicStringView trim_left() const {
+			size_type i = 0;
+			while (i < this->len && isSpace(this->str[i]))
+				++i;
+			return (BasicStringView(this->str + i, this->len - i));
+		};
+		BasicStringView trim_right() const {
+			size_type n = this->len;
+			while (n && isSpace(this->str[n - 1]))
+				--n;
+			return (BasicStringView(this->str, n));
+		};
+		BasicStringView trim() const {
+			return (trim_left().trim_right());
+		};
+
+		// Non-template friends, so a C string or BasicString on either side
+		// converts to a view.
+		friend bool operator== (BasicStringView lhs, BasicStringView rhs) {
+			return (lhs.len == rhs.len && lhs.compare(rhs) == 0);
+		}
+		friend bool operator!= (BasicStringView lhs, BasicStringView rhs) {
+			return (!(lhs == rhs));
+		}
+		friend bool operator< (BasicStringView lhs, BasicStringView rhs) {
+			return (lhs.compare(rhs) < 0);
+		}
+		friend bool operator<= (BasicStringView lhs, BasicStringView rhs) {
+			return (lhs.compare(rhs) <= 0);
+		}
+		friend bool operator> (BasicStringView lhs, BasicStringView rhs) {
+			return (lhs.compare(rhs) > 0);
+		}
+		friend bool operator>= (BasicStringView lhs, BasicStringView rhs) {
+			return (lhs.compare(rhs) >= 0);
+		}
+	};
+	typedef BasicStringView<char>	StringView;
+
+	template <class charT>
+	std::ostream& operator<< (std::ostream& os, BasicStringView<charT> view) {
+		os.write(view.data(), view.size());
+		return (os);
+	}
+
+	/**
+	 * @brief Cursor over a buffer that hands out tokens or lines as views
+	 * into it, without copying or allocating.
+	 *
+	 * next() skips delimiters and returns the following run of
+	 * non-delimiters; nextLine() returns everything up to the next '\n',
+	 * without the "\n" or "\r\n", empty lines included. Both can be mixed,
+	 * e.g. nextLine() and then a Tokenizer over the line.
+	 */
+	template <class charT>
+	class BasicTokenizer
+	{
+	public:
+		typedef BasicStringView<charT>	view_type;
+
+	private:
+		view_type		rest;
+		view_type		delims;
+		unsigned char	table[256];	// 1 for each delimiter below 256
+
+		bool isDelim(charT c) const {
+			unsigned long code = static_cast<unsigned long>(c);
+			if (code < 256)
+				return (this->table[code]);
+			return (this->delims.find(c) != view_type::npos);
+		}
+
+	public:
+		explicit BasicTokenizer(view_type text, view_type delims = view_type(" \t\n\v\f\r"))
+			: rest(text), delims(delims), table() {
+			for (size_t i = 0; i < delims.size(); ++i)
+			{
+				unsigned long code = static_cast<unsigned long>(delims[i]);
+				if (code < 256)
+					this->table[code] = 1;
+			}
+		};
+
+		bool next(view_type &token) {
+			const charT *p = this->rest.begin();
+			const charT *end = this->rest.end();
+			while (p != end && isDelim(*p))
+				++p;
+			const charT *start = p;
+			while (p != end && !isDelim(*p))
+				++p;
+			token = view_type(start, p);
+			this->rest = view_type(p, end);
+			return (start != end);
+		};
+
+		bool nextLine(view_type &line) {
+			if (this->rest.empty())
+			{
+				line = this->rest;
+				return (false);
+			}
+			Pair<view_type, view_type> parts = this->rest.split('\n');
+			line = parts.first;
+			if (line.ends_with('\r'))
+				line.remove_suffix(1);
+			this->rest = parts.second;
+			return (true);
+		};
+
+		view_type remaining() const {
+			return (this->rest);
+		};
+
+		bool done() const {
+			return (this->rest.empty());
+		};
+	};
+	typedef BasicTokenizer<char>	Tokenizer;
+}
+
+#endif // !FT_STRING_VIEW_HPP
@@ -0,0 +1,673 @@
+#ifndef UNORDERED_MAP_HPP
+#define UNORDERED_MAP_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+#include "iterator.hpp"
+#include "type_traits.hpp"
+#include "functional.hpp"
+#include "Pair.hpp"
+#include "Allocator.hpp"
+
+namespace ft
+{
+	/**
+	 * Control bytes of the SwissTable layout: one per slot, either a state or,
+	 * for a full slot, the low 7 bits of the key's hash.
+	 */
+	namespace swiss
+	{
+		typedef signed char	ctrl_t;
+
+		const ctrl_t	EMPTY = -128;
+		const ctrl_t	DELETED = -2;
+		const ctrl_t	SENTINEL = -1;	// after the last slot, stops iteration
+		const size_t	GROUP_WIDTH = 16;
+
+		/**
+		 * @brief 16 control bytes probed at once; each match returns a mask with
+		 * bit i set for byte i.
+		 */
+		class Group
+		{
+		private:
+#if defined(__SSE2__)
+			__m128i	ctrl;
+#else
+			ctrl_t	ctrl[GROUP_WIDTH];
+#endif
+
+		public:
+#if defined(__SSE2__)
+			explicit Group(const ctrl_t *p)
+				: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {};
+
+			unsigned match(ctrl_t h2) const {
+				return (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl)));
+			};
+
+			unsigned matchEmpty() const {
+				return (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(EMPTY), this->ctrl)));
+			};
+
+			unsigned matchEmptyOrDeleted() const {
+				return (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), this->ctrl)));
+			};
+#else
+			explicit Group(const ctrl_t *p) {
+				std::memcpy(this->ctrl, p, GROUP_WIDTH);
+			};
+
+			unsigned match(ctrl_t h2) const {
+				unsigned mask = 0;
+				for (size_t i = 0; i < GROUP_WIDTH; ++i)
+					mask |= (unsigned)(this->ctrl[i] == h2) << i;
+				return (mask);
+			};
+
+			unsigned matchEmpty() const {
+				return (match(EMPTY));
+			};
+
+			unsigned matchEmptyOrDeleted() const {
+				unsigned mask = 0;
+				for (size_t i = 0; i < GROUP_WIDTH; ++i)
+					mask |= (unsigned)(this->ctrl[i] < SENTINEL) << i;
+				return (mask);
+			};
+#endif
+		};
+
+		inline unsigned trailingZeros(unsigned mask) {
+			return (__builtin_ctz(mask));
+		}
+
+		// leading zeros of a 16-bit group mask
+		inline unsigned leadingZeros(unsigned mask) {
+			return (__builtin_clz(mask) - 16);
+		}
+
+		/**
+		 * @brief Control bytes of a table without slots: iteration stops at once.
+		 */
+		inline ctrl_t *emptyGroup() {
+			alignas(16) static ctrl_t group[GROUP_WIDTH] = {
+				SENTINEL, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+				EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY
+			};
+			return (group);
+		}
+	}
+
+	/**
+	 * @brief Open-addressing hash map in the SwissTable layout: values sit in
+	 * one flat slot array, and lookups compare 16 control bytes per step
+	 * (SSE2 where available) before touching any key.
+	 *
+	 * Capacity is 2^k - 1 slots, at most 7/8 full. Erase leaves a tombstone
+	 * unless the slot can never have been part of a longer probe; tombstones
+	 * are cleared by the next rehash. Insertions may rehash and invalidate
+	 * iterators; erase invalidates only the erased element.
+	 *
+	 * @tparam Alloc allocator of value_type; the control bytes use it rebound
+	 * to char.
+	 */
+	template < class Key, class T, class Hash = hash<Key>, class KeyEqual = equal_to<Key>,
+		class Alloc = Allocator<Pair<const Key,T> > >
+	class UnorderedMap
+	{
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef Pair<const key_type, mapped_type>		value_type;
+		typedef Hash									hasher;
+		typedef KeyEqual								key_equal;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef typename Alloc::difference_type			difference_type;
+		typedef size_t									size_type;
+
+		template <typename Tp, typename Ref, typename Ptr>
+		class _UnorderedMap_iterator;
+
+		typedef _UnorderedMap_iterator<value_type, value_type&, value_type*>				iterator;
+		typedef _UnorderedMap_iterator<value_type, const value_type&, const value_type*>	const_iterator;
+
+	private:
+		typedef swiss::ctrl_t									ctrl_t;
+		typedef typename Alloc::template rebind<char>::other	ctrl_allocator_type;
+
+		allocator_type		_allocator;
+		ctrl_allocator_type	_ctrl_allocator;
+		hasher				_hash;
+		key_equal			_eq;
+		ctrl_t				*_ctrl;
+		pointer				_slots;
+		size_type			_capacity;
+		size_type			_size;
+		size_type			_growth_left;	// empty slots to fill before a rehash
+
+		// murmur3 finalizer: identity hashes of integers become usable for both
+		// the probe start (high bits) and the control byte (low 7 bits)
+		size_t hashOf(const key_type &k) const {
+			unsigned long long h = this->_hash(k);
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			return (static_cast<size_t>(h));
+		}
+
+		static ctrl_t h2(size_t h) {
+			return (static_cast<ctrl_t>(h & 0x7F));
+		}
+
+		static size_type capacityToGrowth(size_type capacity) {
+			return (capacity - capacity / 8);
+		}
+
+		static size_type capacityFor(size_type n) {
+			size_type capacity = swiss::GROUP_WIDTH - 1;
+			while (capacityToGrowth(capacity) < n)
+				capacity = capacity * 2 + 1;
+			return (capacity);
+		}
+
+		// The first GROUP_WIDTH - 1 control bytes are mirrored after the
+		// sentinel so a group load never wraps.
+		void setCtrl(size_type i, ctrl_t value) {
+			this->_ctrl[i] = value;
+			this->_ctrl[((i - (swiss::GROUP_WIDTH - 1)) & this->_capacity) + (swiss::GROUP_WIDTH - 1)] = value;
+		}
+
+		// Index of k, or _capacity when absent.
+		size_type findIndex(const key_type &k, size_t h) const {
+			if (this->_size == 0)
+				return (this->_capacity);
+			size_type pos = (h >> 7) & this->_capacity;
+			size_type step = 0;
+			for (;;)
+			{
+				swiss::Group group(this->_ctrl + pos);
+				for (unsigned mask = group.match(h2(h)); mask; mask &= mask - 1)
+				{
+					size_type i = (pos + swiss::trailingZeros(mask)) & this->_capacity;
+					if (this->_eq(this->_slots[i].first, k))
+						return (i);
+				}
+				if (group.matchEmpty())
+					return (this->_capacity);
+				step += swiss::GROUP_WIDTH;
+				pos = (pos + step) & this->_capacity;
+			}
+		}
+
+		// First empty or deleted slot on the probe sequence of h.
+		size_type findInsertSlot(size_t h) const {
+			size_type pos = (h >> 7) & this->_capacity;
+			size_type step = 0;
+			for (;;)
+			{
+				unsigned mask = swiss::Group(this->_ctrl + pos).matchEmptyOrDeleted();
+				if (mask)
+					return ((pos + swiss::trailingZeros(mask)) & this->_capacity);
+				step += swiss::GROUP_WIDTH;
+				pos = (pos + step) & this->_capacity;
+			}
+		}
+
+		void allocateTable(size_type capacity) {
+			ctrl_t *ctrl = reinterpret_cast<ctrl_t*>(_ctrl_allocator.allocate(capacity + swiss::GROUP_WIDTH));
+			pointer slots;
+			try
+			{
+				slots = _allocator.allocate(capacity);
+			}
+			catch(...)
+			{
+				_ctrl_allocator.deallocate(reinterpret_cast<char*>(ctrl), capacity + swiss::GROUP_WIDTH);
+				throw;
+			}
+			std::memset(ctrl, swiss::EMPTY, capacity + swiss::GROUP_WIDTH);
+			ctrl[capacity] = swiss::SENTINEL;
+			this->_ctrl = ctrl;
+			this->_slots = slots;
+			this->_capacity = capacity;
+			this->_growth_left = capacityToGrowth(capacity);
+		}
+
+		void destroyTable() {
+			if (this->_capacity == 0)
+				return ;
+			for (size_type i = 0; i < this->_capacity; ++i)
+				if (this->_ctrl[i] >= 0)
+					_allocator.destroy(this->_slots + i);
+			_ctrl_allocator.deallocate(reinterpret_cast<char*>(this->_ctrl), this->_capacity + swiss::GROUP_WIDTH);
+			_allocator.deallocate(this->_slots, this->_capacity);
+		}
+
+		// Moves every element into a fresh table of capacity slots, which also
+		// drops the tombstones.
+		void resize(size_type capacity) {
+			ctrl_t *old_ctrl = this->_ctrl;
+			pointer old_slots = this->_slots;
+			size_type old_capacity = this->_capacity;
+			allocateTable(capacity);
+			for (size_type i = 0; i < old_capacity; ++i)
+			{
+				if (old_ctrl[i] < 0)
+					continue ;
+				size_t h = hashOf(old_slots[i].first);
+				size_type target = findInsertSlot(h);
+				_allocator.construct(this->_slots + target, std::move(old_slots[i]));
+				_allocator.destroy(old_slots + i);
+				setCtrl(target, h2(h));
+			}
+			this->_growth_left -= this->_size;
+			if (old_capacity)
+			{
+				_ctrl_allocator.deallocate(reinterpret_cast<char*>(old_ctrl), old_capacity + swiss::GROUP_WIDTH);
+				_allocator.deallocate(old_slots, old_capacity);
+			}
+		}
+
+		// Out of empty slots: rehash in place when tombstones hold at least half
+		// the room, otherwise double.
+		void rehashAndGrow() {
+			if (this->_capacity == 0)
+				resize(swiss::GROUP_WIDTH - 1);
+			else if (this->_size <= capacityToGrowth(this->_capacity) / 2)
+				resize(this->_capacity);
+			else
+				resize(this->_capacity * 2 + 1);
+		}
+
+		// Builds value_type(args...) for a key of hash h that findIndex did not
+		// find, growing first when out of room.
+		template <class... Args>
+		iterator constructAt(size_t h, Args&&... args) {
+			if (this->_capacity == 0)
+				rehashAndGrow();
+			size_type i = findInsertSlot(h);
+			if (this->_growth_left == 0 && this->_ctrl[i] != swiss::DELETED)
+			{
+				rehashAndGrow();
+				i = findInsertSlot(h);
+			}
+			_allocator.construct(this->_slots + i, std::forward<Args>(args)...);
+			if (this->_ctrl[i] == swiss::EMPTY)
+				--this->_growth_left;
+			setCtrl(i, h2(h));
+			++this->_size;
+			return (iteratorAt(i));
+		}
+
+		// A slot whose neighbourhood never filled a whole group can go back to
+		// EMPTY: no probe sequence ever moved past it.
+		void eraseAt(size_type i) {
+			_allocator.destroy(this->_slots + i);
+			--this->_size;
+			size_type before = (i - swiss::GROUP_WIDTH) & this->_capacity;
+			unsigned empty_after = swiss::Group(this->_ctrl + i).matchEmpty();
+			unsigned empty_before = swiss::Group(this->_ctrl + before).matchEmpty();
+			if (empty_before && empty_after
+				&& swiss::trailingZeros(empty_after) + swiss::leadingZeros(empty_before) < swiss::GROUP_WIDTH)
+			{
+				setCtrl(i, swiss::EMPTY);
+				++this->_growth_left;
+			}
+			else
+				setCtrl(i, swiss::DELETED);
+		}
+
+		iterator iteratorAt(size_type i) {
+			return (iterator(this->_ctrl + i, this->_slots + i));
+		}
+
+		const_iterator iteratorAt(size_type i) const {
+			return (const_iterator(this->_ctrl + i, this->_slots + i));
+		}
+
+	public:
+		explicit UnorderedMap (size_type bucket_count = 0, const hasher& hf = hasher(),
+			const key_equal& eql = key_equal(), const allocator_type& alloc = allocator_type())
+			: _allocator(alloc), _ctrl_allocator(alloc), _hash(hf), _eq(eql),
+			_ctrl(swiss::emptyGroup()), _slots(NULL), _capacity(0), _size(0), _growth_left(0)
+		{
+			if (bucket_count)
+				resize(capacityFor(bucket_count));
+		};
+
+		explicit UnorderedMap (const allocator_type& alloc)
+			: _allocator(alloc), _ctrl_allocator(alloc), _hash(), _eq(),
+			_ctrl(swiss::emptyGroup()), _slots(NULL), _capacity(0), _size(0), _growth_left(0) {};
+
+		template <class InputIterator>
+		UnorderedMap (InputIterator first, InputIterator last, size_type bucket_count = 0,
+			const hasher& hf = hasher(), const key_equal& eql = key_equal(),
+			const allocator_type& alloc = allocator_type(),
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0)
+			: _allocator(alloc), _ctrl_allocator(alloc), _hash(hf), _eq(eql),
+			_ctrl(swiss::emptyGroup()), _slots(NULL), _capacity(0), _size(0), _growth_left(0)
+		{
+			if (bucket_count)
+				resize(capacityFor(bucket_count));
+			insert(first, last);
+		};
+
+		// Same capacity and slot positions as x, so nothing is rehashed.
+		UnorderedMap (const UnorderedMap& x)
+			: _allocator(x._allocator), _ctrl_allocator(x._ctrl_allocator), _hash(x._hash), _eq(x._eq),
+			_ctrl(swiss::emptyGroup()), _slots(NULL), _capacity(0), _size(0), _growth_left(0)
+		{
+			if (x._capacity == 0)
+				return ;
+			allocateTable(x._capacity);
+			for (size_type i = 0; i < x._capacity; ++i)
+			{
+				if (x._ctrl[i] < 0)
+					continue ;
+				_allocator.construct(this->_slots + i, x._slots[i]);
+			}
+			this->_size = x._size;
+			this->_growth_left = x._growth_left;
+			std::memcpy(this->_ctrl, x._ctrl, this->_capacity + swiss::GROUP_WIDTH);
+		};
+
+		UnorderedMap (UnorderedMap&& x) noexcept
+			: _allocator(x._allocator), _ctrl_allocator(x._ctrl_allocator), _hash(x._hash), _eq(x._eq),
+			_ctrl(x._ctrl), _slots(x._slots), _capacity(x._capacity), _size(x._size), _growth_left(x._growth_left)
+		{
+			x._ctrl = swiss::emptyGroup();
+			x._slots = NULL;
+			x._capacity = 0;
+			x._size = 0;
+			x._growth_left = 0;
+		};
+
+		~UnorderedMap() {
+			destroyTable();
+		};
+
+		UnorderedMap& operator= (const UnorderedMap& x) {
+			if (this != &x)
+			{
+				UnorderedMap copy(x);
+				swap(copy);
+			}
+			return (*this);
+		};
+
+		UnorderedMap& operator= (UnorderedMap&& x) noexcept {
+			if (this != &x)
+				swap(x);
+			return (*this);
+		};
+
+		iterator begin() {
+			iterator it(this->_ctrl, this->_slots);
+			it.skipFree();
+			return (it);
+		};
+
+		const_iterator begin() const {
+			const_iterator it(this->_ctrl, this->_slots);
+			it.skipFree();
+			return (it);
+		};
+
+		iterator end() {
+			return (iteratorAt(this->_capacity));
+		};
+
+		const_iterator end() const {
+			return (iteratorAt(this->_capacity));
+		};
+
+		bool empty() const {
+			return (this->_size == 0);
+		};
+
+		size_type size() const {
+			return (this->_size);
+		};
+
+		size_type max_size() const {
+			return (_allocator.max_size());
+		};
+
+		mapped_type& operator[] (const key_type& k) {
+			return (try_emplace(k).first->second);
+		};
+
+		mapped_type& at (const key_type& k) {
+			size_type i = findIndex(k, hashOf(k));
+			if (i == this->_capacity)
+				throw std::out_of_range("unordered_map");
+			return (this->_slots[i].second);
+		};
+
+		const mapped_type& at (const key_type& k) const {
+			size_type i = findIndex(k, hashOf(k));
+			if (i == this->_capacity)
+				throw std::out_of_range("unordered_map");
+			return (this->_slots[i].second);
+		};
+
+		iterator find (const key_type& k) {
+			return (iteratorAt(findIndex(k, hashOf(k))));
+		};
+
+		const_iterator find (const key_type& k) const {
+			return (iteratorAt(findIndex(k, hashOf(k))));
+		};
+
+		size_type count (const key_type& k) const {
+			return (findIndex(k, hashOf(k)) != this->_capacity);
+		};
+
+		Pair<iterator, bool> insert (const value_type& val) {
+			size_t h = hashOf(val.first);
+			size_type i = findIndex(val.first, h);
+			if (i != this->_capacity)
+				return (Pair<iterator, bool>(iteratorAt(i), false));
+			return (Pair<iterator, bool>(constructAt(h, val), true));
+		};
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			while (first != last)
+			{
+				insert(*first);
+				++first;
+			}
+		};
+
+		/**
+		 * @brief Inserts value_type(k, args...) unless k is present; args are
+		 * untouched then.
+		 */
+		template <class... Args>
+		Pair<iterator, bool> try_emplace (const key_type& k, Args&&... args) {
+			size_t h = hashOf(k);
+			size_type i = findIndex(k, h);
+			if (i != this->_capacity)
+				return (Pair<iterator, bool>(iteratorAt(i), false));
+			return (Pair<iterator, bool>(constructAt(h, k, mapped_type(std::forward<Args>(args)...)), true));
+		};
+
+		// position stays valid for ++, so erasing while iterating works
+		void erase (iterator position) {
+			eraseAt(position.slot() - this->_slots);
+		};
+
+		size_type erase (const key_type& k) {
+			size_type i = findIndex(k, hashOf(k));
+			if (i == this->_capacity)
+				return (0);
+			eraseAt(i);
+			return (1);
+		};
+
+		void erase (iterator first, iterator last) {
+			while (first != last)
+			{
+				erase(first);
+				++first;
+			}
+		};
+
+		void swap (UnorderedMap& x) {
+			std::swap(this->_allocator, x._allocator);
+			std::swap(this->_ctrl_allocator, x._ctrl_allocator);
+			std::swap(this->_hash, x._hash);
+			std::swap(this->_eq, x._eq);
+			std::swap(this->_ctrl, x._ctrl);
+			std::swap(this->_slots, x._slots);
+			std::swap(this->_capacity, x._capacity);
+			std::swap(this->_size, x._size);
+			std::swap(this->_growth_left, x._growth_left);
+		};
+
+		// keeps the capacity
+		void clear() {
+			if (this->_capacity == 0)
+				return ;
+			for (size_type i = 0; i < this->_capacity; ++i)
+				if (this->_ctrl[i] >= 0)
+					_allocator.destroy(this->_slots + i);
+			std::memset(this->_ctrl, swiss::EMPTY, this->_capacity + swiss::GROUP_WIDTH);
+			this->_ctrl[this->_capacity] = swiss::SENTINEL;
+			this->_size = 0;
+			this->_growth_left = capacityToGrowth(this->_capacity);
+		};
+
+		/**
+		 * @brief Room for n elements without a rehash.
+		 */
+		void reserve (size_type n) {
+			if (n > this->_size + this->_growth_left)
+				resize(capacityFor(n));
+		};
+
+		size_type bucket_count() const {
+			return (this->_capacity);
+		};
+
+		float load_factor() const {
+			return (this->_capacity ? static_cast<float>(this->_size) / this->_capacity : 0.0f);
+		};
+
+		hasher hash_function() const {
+			return (this->_hash);
+		};
+
+		key_equal key_eq() const {
+			return (this->_eq);
+		};
+
+		allocator_type get_allocator() const {
+			return (_allocator);
+		};
+
+		template <typename Tp, typename Ref, typename Ptr>
+		class _UnorderedMap_iterator
+		{
+			private:
+				const ctrl_t	*_ctrl;
+				Tp				*_slot;
+
+			public:
+				typedef _UnorderedMap_iterator<Tp, Tp&, Tp*>	iterator;
+				typedef _UnorderedMap_iterator<Tp, Ref, Ptr>	self;
+
+				typedef forward_iterator_tag					iterator_category;
+				typedef Tp										value_type;
+				typedef std::ptrdiff_t							difference_type;
+				typedef Ptr										pointer;
+				typedef Ref										reference;
+
+				_UnorderedMap_iterator() : _ctrl(NULL), _slot(NULL) {};
+				_UnorderedMap_iterator(const ctrl_t *ctrl, Tp *slot) : _ctrl(ctrl), _slot(slot) {};
+				_UnorderedMap_iterator(const iterator& other) : _ctrl(other.ctrl()), _slot(other.slot()) {};
+				~_UnorderedMap_iterator() {};
+				self& operator= (const iterator& rhs) {
+					this->_ctrl = rhs.ctrl();
+					this->_slot = rhs.slot();
+					return (*this);
+				};
+
+				const ctrl_t *ctrl() const {return (this->_ctrl);};
+				Tp *slot() const {return (this->_slot);};
+
+				// moves to the next full slot or the sentinel
+				void skipFree() {
+					while (*this->_ctrl < swiss::SENTINEL)
+					{
+						++this->_ctrl;
+						++this->_slot;
+					}
+				};
+
+				self& operator++ () {
+					++this->_ctrl;
+					++this->_slot;
+					skipFree();
+					return (*this);
+				};
+
+				self operator++ (int) {
+					self tmp(*this);
+					++(*this);
+					return (tmp);
+				};
+
+				reference operator*() const {
+					return (*this->_slot);
+				};
+
+				pointer operator->() const {
+					return (this->_slot);
+				};
+
+				bool operator== (const self& other) const {return (this->_ctrl == other._ctrl);};
+				bool operator!= (const self& other) const {return (this->_ctrl != other._ctrl);};
+		};
+	};
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	bool operator== (const UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& lhs,
+		const UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& rhs) {
+		if (lhs.size() != rhs.size())
+			return (false);
+		typename UnorderedMap<Key,T,Hash,KeyEqual,Alloc>::const_iterator it = lhs.begin();
+		for (; it != lhs.end(); ++it)
+		{
+			typename UnorderedMap<Key,T,Hash,KeyEqual,Alloc>::const_iterator match = rhs.find(it->first);
+			if (match == rhs.end() || !(match->second == it->second))
+				return (false);
+		}
+		return (true);
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	bool operator!= (const UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& lhs,
+		const UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& rhs) {
+		return (!(lhs == rhs));
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void swap (UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& x, UnorderedMap<Key,T,Hash,KeyEqual,Alloc>& y) {
+		x.swap(y);
+	}
+}
+
+#endif // !UNORDERED_MAP_HPP
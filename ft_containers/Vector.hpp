@@ -14,10 +14,14 @@
 #define VECTOR_HPP
 
 #include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include "iterator.hpp"
 #include "reverse_iterator.hpp"
 #include "type_traits.hpp"
 #include "Allocator.hpp"
+#include "vector_storage.hpp"
 
 namespace ft
 {
@@ -56,6 +60,18 @@ namespace ft
 			}
 		}
 
+		// Frees the old storage for new_start, which holds the relocated
+		// elements and any appended ones past size().
+		void adoptStorage(pointer new_start, size_type new_max_size)
+		{
+			size_type n = size();
+			if (_start)
+				_allocator.deallocate(_start, capacity());
+			_start = new_start;
+			_finish = new_start + n;
+			_end_of_storage = new_start + new_max_size;
+		}
+
 		void realloc(size_type new_max_size = 0)
 		{
 			if (new_max_size == 0)
@@ -67,26 +83,8 @@ namespace ft
 			}
 			if (new_max_size > _allocator.max_size())
 				return ;
-			pointer new_start;
-			try
-			{
-				new_start = _allocator.allocate(new_max_size);
-			}
-			catch(...)
-			{
-				throw;
-			}
-			pointer new_finish = new_start;
-			pointer new_end_of_storage = new_start + new_max_size;
-			for (size_type i = 0; i < size(); ++i)
-			{
-				_allocator.construct(new_finish, _start[i]);
-				++new_finish;
-			}
-			deleteArray();
-			_start = new_start;
-			_finish = new_finish;
-			_end_of_storage = new_end_of_storage;
+			adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, 0,
+				[](pointer) {}), new_max_size);
 		}
 
 	public:
@@ -168,22 +166,34 @@ namespace ft
 			}
 		};
 
+		Vector (Vector&& x) noexcept
+		 : _allocator(x._allocator), _start(x._start), _finish(x._finish), _end_of_storage(x._end_of_storage) {
+			x._start = NULL;
+			x._finish = NULL;
+			x._end_of_storage = NULL;
+		};
+
 		~Vector() {
 			deleteArray();
 		};
 
 		Vector& operator= (const Vector& x) {
+			if (this == &x)
+				return (*this);
+			// the new storage comes from x's allocator, the old one goes back
+			// to ours
+			allocator_type alloc = x._allocator;
 			pointer temp;
 			try
 			{
-				temp = _allocator.allocate(x.size());
+				temp = alloc.allocate(x.size());
 			}
 			catch(...)
 			{
 				throw;
 			}
 			deleteArray();
-			this->_allocator = x._allocator;
+			this->_allocator = alloc;
 			this->_start = temp;
 			this->_finish = this->_start;
 			this->_end_of_storage = this->_start + x.size();
@@ -197,6 +207,21 @@ namespace ft
 			return (*this);
 		};
 
+		Vector& operator= (Vector&& x) noexcept {
+			if (this != &x)
+			{
+				deleteArray();
+				this->_allocator = x._allocator;
+				this->_start = x._start;
+				this->_finish = x._finish;
+				this->_end_of_storage = x._end_of_storage;
+				x._start = NULL;
+				x._finish = NULL;
+				x._end_of_storage = NULL;
+			}
+			return (*this);
+		};
+
 		iterator begin() {
 			return (_start);
 		};
@@ -271,7 +296,7 @@ namespace ft
 		};
 
 		void reserve (size_type n) {
-			if (n > size())
+			if (n > capacity())
 			{
 				try
 				{
@@ -367,21 +392,76 @@ namespace ft
 		};
 
 		void push_back (const value_type& val) {
+			emplace_back(val);
+		};
+
+		void push_back (value_type&& val) {
+			emplace_back(std::move(val));
+		};
+
+		// When full, the new element is built in the new storage before the old
+		// ones are relocated, so args may refer into this vector.
+		template <class... Args>
+		reference emplace_back (Args&&... args) {
 			if (_finish == _end_of_storage)
 			{
-				if (size() + 1 > _allocator.max_size())
-					return ;
-				try
-				{
-					realloc();
-				}
-				catch(...)
-				{
-					throw;
-				}
+				size_type new_max_size = storage::growSize(_allocator, size(), size() + 1, "vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, 1,
+					[&](pointer slot) { _allocator.construct(slot, std::forward<Args>(args)...); }), new_max_size);
 			}
-			_allocator.construct(_finish, val);
-			++_finish;
+			else
+				_allocator.construct(_finish, std::forward<Args>(args)...);
+			return (*_finish++);
+		};
+
+		// Appends [first, last) with one capacity check; the range may come
+		// from this vector.
+		template <class InputIterator>
+		void append (InputIterator first, InputIterator last,
+			typename ft::enable_if< !ft::is_integral<InputIterator>::value >::type* = 0) {
+			size_type n = last - first;
+			if (n == 0)
+				return ;
+			if (n > capacity() - size())
+			{
+				size_type new_max_size = storage::growSize(_allocator, size(), size() + n, "vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, n,
+					[&](pointer slot) { storage::copyRange(_allocator, first, last, slot); }), new_max_size);
+			}
+			else
+				storage::copyRange(_allocator, first, last, _finish);
+			_finish += n;
+		};
+
+		// Appends n default-initialized elements and returns the first one, for
+		// the caller to fill in. Trivial types are left unwritten.
+		pointer append_uninitialized (size_type n) {
+			if (n > capacity() - size())
+			{
+				size_type new_max_size = storage::growSize(_allocator, size(), size() + n, "vector");
+				adoptStorage(storage::allocateRelocated(_allocator, new_max_size, _start, _finish, 0,
+					[](pointer) {}), new_max_size);
+			}
+			pointer first = _finish;
+			for (size_type i = 0; i < n; ++i)
+			{
+				::new((void*)_finish) value_type;
+				++_finish;
+			}
+			return (first);
+		};
+
+		// resize without value-initialization: new elements are meant to be
+		// overwritten, capacity is exactly n when it grows.
+		void resize_for_overwrite (size_type n) {
+			if (n > size())
+			{
+				reserve(n);
+				append_uninitialized(n - size());
+			}
+			else
+				while (n < size())
+					pop_back();
 		};
 
 		void pop_back() {
@@ -407,7 +487,7 @@ namespace ft
 			{
 				if ((p - 1) >= _start)
 				{
-					_allocator.construct(p, *(p - 1));
+					_allocator.construct(p, std::move(*(p - 1)));
 					_allocator.destroy(p - 1);
 				}
 				--p;
@@ -436,7 +516,7 @@ namespace ft
 			pointer p = _finish + n - 1;
 			while (p - n >= _start + index)
 			{
-				_allocator.construct(p, *(p - n));
+				_allocator.construct(p, std::move(*(p - n)));
 				_allocator.destroy(p - n);
 				--p;
 			}
@@ -470,7 +550,7 @@ namespace ft
 			pointer p = _finish + n - 1;
 			while (p - n >= _start + index)
 			{
-				_allocator.construct(p, *(p - n));
+				_allocator.construct(p, std::move(*(p - n)));
 				_allocator.destroy(p - n);
 				--p;
 			}
@@ -488,7 +568,7 @@ namespace ft
 			_allocator.destroy(position);
 			while (position + 1 != _finish)
 			{
-				_allocator.construct(position, position[1]);
+				_allocator.construct(position, std::move(position[1]));
 				_allocator.destroy(position + 1);
 				++position;
 			}
@@ -509,7 +589,7 @@ namespace ft
 				}
 				if (first + len < _finish)
 				{
-					_allocator.construct(first, first[len]);
+					_allocator.construct(first, std::move(first[len]));
 					_allocator.destroy(first + len);
 					if (result == NULL)
 						result = first;
@@ -523,6 +603,9 @@ namespace ft
 		};
 
 		void swap (Vector& x) {
+			allocator_type temp_allocator = _allocator;
+			_allocator = x._allocator;
+			x._allocator = temp_allocator;
 			pointer temp_start = _start;
 			pointer temp_finish = _finish;
 			pointer temp_end_of_storage = _end_of_storage;
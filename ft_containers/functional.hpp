@@ -0,0 +1,129 @@
+#ifndef FUNCTIONAL_HPP
+#define FUNCTIONAL_HPP
+
+#include <cstddef>
+
+namespace ft
+{
+	template <class charT, class Alloc>
+	class BasicString;
+
+	template <class charT>
+	class BasicStringView;
+
+	/**
+	 * @brief FNV-1a over n bytes.
+	 */
+	inline size_t hashBytes(const void *data, size_t n) {
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		unsigned long long h = 14695981039346656037ull;
+		for (size_t i = 0; i < n; ++i)
+		{
+			h ^= bytes[i];
+			h *= 1099511628211ull;
+		}
+		return (static_cast<size_t>(h));
+	}
+
+	/**
+	 * @brief Hash functor for UnorderedMap. Integers and pointers hash to
+	 * themselves; the table mixes the bits before use.
+	 */
+	template <class T>
+	struct hash;
+
+	#define FT_HASH_INTEGRAL(T)								\
+		template<> struct hash<T>							\
+		{													\
+			size_t operator()(T value) const {				\
+				return (static_cast<size_t>(value));		\
+			}												\
+		};
+
+	FT_HASH_INTEGRAL(bool)
+	FT_HASH_INTEGRAL(char)
+	FT_HASH_INTEGRAL(signed char)
+	FT_HASH_INTEGRAL(unsigned char)
+	FT_HASH_INTEGRAL(wchar_t)
+	FT_HASH_INTEGRAL(char16_t)
+	FT_HASH_INTEGRAL(char32_t)
+	FT_HASH_INTEGRAL(short)
+	FT_HASH_INTEGRAL(unsigned short)
+	FT_HASH_INTEGRAL(int)
+	FT_HASH_INTEGRAL(unsigned int)
+	FT_HASH_INTEGRAL(long)
+	FT_HASH_INTEGRAL(unsigned long)
+	FT_HASH_INTEGRAL(long long)
+	FT_HASH_INTEGRAL(unsigned long long)
+
+	#undef FT_HASH_INTEGRAL
+
+	template <class T>
+	struct hash<T*>
+	{
+		size_t operator()(T *value) const {
+			return (reinterpret_cast<size_t>(value));
+		}
+	};
+
+	// +0.0 and -0.0 compare equal, so they must hash alike
+	template <>
+	struct hash<float>
+	{
+		size_t operator()(float value) const {
+			if (value == 0.0f)
+				value = 0.0f;
+			return (hashBytes(&value, sizeof(value)));
+		}
+	};
+
+	template <>
+	struct hash<double>
+	{
+		size_t operator()(double value) const {
+			if (value == 0.0)
+				value = 0.0;
+			return (hashBytes(&value, sizeof(value)));
+		}
+	};
+
+	template <class charT, class Alloc>
+	struct hash< BasicString<charT, Alloc> >
+	{
+		size_t operator()(const BasicString<charT, Alloc> &value) const {
+			return (hashBytes(value.data(), value.size() * sizeof(charT)));
+		}
+	};
+
+	// a view and the string it shows hash alike
+	template <class charT>
+	struct hash< BasicStringView<charT> >
+	{
+		size_t operator()(BasicStringView<charT> value) const {
+			return (hashBytes(value.data(), value.size() * sizeof(charT)));
+		}
+	};
+
+	template <class Arg1, class Arg2, class Result>
+	struct binary_function {
+		typedef Arg1 first_argument_type;
+		typedef Arg2 second_argument_type;
+		typedef Result result_type;
+	};
+
+	template <class T>
+	struct less : ft::binary_function <T,T,bool>
+	{
+		bool operator() (const T& x, const T& y) const { return x<y; }
+	};
+
+	template <class T>
+	struct equal_to
+	{
+		bool operator()(const T &x, const T &y) const {
+			return (x == y);
+		}
+	};
+}
+
+#endif // !FUNCTIONAL_HPP
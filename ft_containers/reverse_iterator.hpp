@@ -13,6 +13,7 @@
 #ifndef REVERSE_ITERATOR_HPP
 # define REVERSE_ITERATOR_HPP
 
+# include <type_traits>
 # include "iterator_traits.hpp"
 
 namespace ft
@@ -81,8 +82,15 @@ namespace ft
 				return (*this);
 			};
 
+			// Same element as operator*; class iterators may return a proxy
+			// from their own operator->, so that is forwarded as is.
 			pointer operator->() const {
-				return (&(*_base));
+				iterator_type temp = _base;
+				--temp;
+				if constexpr (std::is_pointer<iterator_type>::value)
+					return (temp);
+				else
+					return (temp.operator->());
 			};
 
 			reference operator[] (difference_type n) const {
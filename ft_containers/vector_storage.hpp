@@ -0,0 +1,152 @@
+#ifndef VECTOR_STORAGE_HPP
+#define VECTOR_STORAGE_HPP
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ft
+{
+	/**
+	 * Element moves and growth shared by Vector and SmallVector, on raw
+	 * storage from alloc. Each container keeps its own layout and decides
+	 * how old storage is freed.
+	 */
+	namespace storage
+	{
+		template <class Alloc, class T>
+		void destroyRange(Alloc &alloc, T *first, T *last) {
+			if constexpr (!std::is_trivially_destructible<T>::value)
+				for (; first != last; ++first)
+					alloc.destroy(first);
+		}
+
+		/**
+		 * @brief Moves [first, last) into the raw storage at dest, the elements
+		 * from split on landing gap slots further, and destroys the source.
+		 * Trivially copyable types go as memcpy. When a copy throws (a type
+		 * whose move may throw is copied), the elements built at dest are
+		 * destroyed and the source is left as it was.
+		 */
+		template <class Alloc, class T>
+		void relocate(Alloc &alloc, T *first, T *last, T *dest, T *split, size_t gap) {
+			if constexpr (std::is_trivially_copyable<T>::value)
+			{
+				if (first != split)
+					std::memcpy((void*)dest, (const void*)first, (split - first) * sizeof(T));
+				if (split != last)
+					std::memcpy((void*)(dest + (split - first) + gap), (const void*)split, (last - split) * sizeof(T));
+			}
+			else
+			{
+				T *p = first;
+				T *out = dest;
+				try
+				{
+					for (; p != last; ++p, ++out)
+					{
+						if (p == split)
+							out += gap;
+						alloc.construct(out, std::move_if_noexcept(*p));
+					}
+				}
+				catch(...)
+				{
+					out = dest;
+					for (T *q = first; q != p; ++q, ++out)
+					{
+						if (q == split)
+							out += gap;
+						alloc.destroy(out);
+					}
+					throw;
+				}
+				destroyRange(alloc, first, last);
+			}
+		}
+
+		template <class Alloc, class T>
+		void relocate(Alloc &alloc, T *first, T *last, T *dest) {
+			relocate(alloc, first, last, dest, last, 0);
+		}
+
+		/**
+		 * @brief Copies [first, last) into the raw storage at dest; a pointer
+		 * range of a trivially copyable type is one memcpy. If a copy throws,
+		 * the ones already built are destroyed.
+		 */
+		template <class Alloc, class T, class InputIterator>
+		void copyRange(Alloc &alloc, InputIterator first, InputIterator last, T *dest) {
+			if constexpr (std::is_pointer<InputIterator>::value
+				&& std::is_same<typename std::remove_cv<typename std::remove_pointer<InputIterator>::type>::type, T>::value
+				&& std::is_trivially_copyable<T>::value)
+			{
+				if (first != last)
+					std::memcpy((void*)dest, (const void*)first, (last - first) * sizeof(T));
+			}
+			else
+			{
+				T *out = dest;
+				try
+				{
+					for (; first != last; ++first, ++out)
+						alloc.construct(out, *first);
+				}
+				catch(...)
+				{
+					destroyRange(alloc, dest, out);
+					throw;
+				}
+			}
+		}
+
+		/**
+		 * @brief Capacity to grow to: twice current, or exactly min_size when
+		 * that is larger. Throws length_error(what) past alloc.max_size().
+		 */
+		template <class Alloc>
+		size_t growSize(const Alloc &alloc, size_t current, size_t min_size, const char *what) {
+			if (min_size > alloc.max_size())
+				throw std::length_error(what);
+			size_t grown = 2 * current;
+			return (grown > min_size ? grown : min_size);
+		}
+
+		/**
+		 * @brief Allocates n elements, has fill(slot) build filled elements at
+		 * slot, just past where [first, last) goes, then relocates [first,
+		 * last) to the front of the block. Filling first lets the new elements
+		 * refer into [first, last). If either step throws, what was built is
+		 * destroyed, the block freed and the exception rethrown, with
+		 * [first, last) left as it was.
+		 */
+		template <class Alloc, class T, class Fill>
+		T *allocateRelocated(Alloc &alloc, size_t n, T *first, T *last, size_t filled, Fill fill) {
+			T *new_start = alloc.allocate(n);
+			T *slot = new_start + (last - first);
+			try
+			{
+				fill(slot);
+			}
+			catch(...)
+			{
+				alloc.deallocate(new_start, n);
+				throw;
+			}
+			try
+			{
+				relocate(alloc, first, last, new_start);
+			}
+			catch(...)
+			{
+				destroyRange(alloc, slot, slot + filled);
+				alloc.deallocate(new_start, n);
+				throw;
+			}
+			return (new_start);
+		}
+	}
+}
+
+#endif // !VECTOR_STORAGE_HPP
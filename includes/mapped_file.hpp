@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include "StringView.hpp"
+
+namespace Scop
+{
+	/**
+	 * @brief Read-only memory map of a whole file. Parsers take views of it
+	 * with getView() instead of reading into strings; the views are valid
+	 * while the MappedFile lives.
+	 */
+	class MappedFile
+	{
+	private:
+		const char	*data;
+		size_t		size;
+		bool		opened;
+
+		MappedFile(const MappedFile &rhs);
+		MappedFile &operator=(const MappedFile &rhs);
+
+	public:
+		explicit MappedFile(const char *path);
+		~MappedFile();
+
+		bool isOpen() const;
+		ft::StringView getView() const;
+		size_t getSize() const;
+	};
+}
+
+#endif
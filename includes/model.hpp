@@ -0,0 +1,77 @@
+#ifndef MODEL_HPP
+#define MODEL_HPP
+
+#include <iostream>
+#include "String.hpp"
+#include "Vector.hpp"
+#include "rt_vector.hpp"
+
+namespace Scop
+{
+	/**
+	 * @brief What happens to the CPU copy of the geometry after it has been
+	 * uploaded to the GPU.
+	 */
+	enum ResidencyPolicy
+	{
+		RESIDENCY_KEEP,		// keep interleaved vertices and indices
+		RESIDENCY_DROP,		// release everything, GPU buffers are the only copy
+		RESIDENCY_PICKING	// keep positions and indices only (picking structures)
+	};
+
+	ResidencyPolicy parseResidencyPolicy(const char *str);
+	const char *residencyPolicyName(ResidencyPolicy policy);
+
+	struct MemoryReport
+	{
+		ft::String	name;
+		size_t		cpuVertexBytes;
+		size_t		cpuIndexBytes;
+		size_t		gpuVertexBytes;
+		size_t		gpuIndexBytes;
+
+		size_t cpuBytes() const { return cpuVertexBytes + cpuIndexBytes; };
+		size_t gpuBytes() const { return gpuVertexBytes + gpuIndexBytes; };
+	};
+
+	std::ostream& operator<<(std::ostream& os, const MemoryReport& report);
+
+	class Model
+	{
+	public:
+		ft::String			name;
+		ft::Vector<float>	vertices;	// x y z r g b per vertex
+		ft::Vector<int>		indices;
+		ft::Vector<float>	positions;	// x y z per vertex, RESIDENCY_PICKING only
+		rt::RTVector<float>	center;
+		float				radius;		// bounding sphere around center, set by upload()
+
+	private:
+		unsigned int		VAO;
+		unsigned int		VBO;
+		unsigned int		EBO;
+		size_t				indexCount;
+		ResidencyPolicy		residency;
+
+		Model(const Model &rhs);
+		Model& operator=(const Model &rhs);
+
+	public:
+		Model(ft::String name);
+		~Model();
+
+		/**
+		 * @brief Create VAO/VBO/EBO from vertices and indices, then apply the
+		 * residency policy to the CPU copy.
+		 */
+		void upload(ResidencyPolicy policy);
+		void draw() const;
+		void release();
+
+		MemoryReport memoryReport() const;
+		ResidencyPolicy getResidency() const;
+		size_t getIndexCount() const;
+	};
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <exception>
 #include "String.hpp"
+#include "StringView.hpp"
 
 namespace Scop
 {
@@ -0,0 +1,203 @@
+#ifndef RT_BATCH_HPP
+#define RT_BATCH_HPP
+
+#include <cstddef>
+#include "rt_simd.hpp"
+#include "rt_parallel.hpp"
+#include "rt_mat.hpp"
+
+/**
+ * Batch transform of positions by a row-major 4x4 affine matrix: each
+ * point (x, y, z, 1) becomes m * p, the bottom row of m is ignored.
+ *
+ * Positions come either as SoA arrays or interleaved with a stride (in
+ * floats), e.g. stride 6 for the x y z r g b layout of loadOBJ. Output may
+ * alias input when both use the same layout. With threads != 1 the range
+ * is split into contiguous chunks, threads == 0 uses
+ * std::thread::hardware_concurrency().
+ */
+namespace rt
+{
+namespace batch
+{
+	typedef void (*TransformSoaFn)(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count);
+
+	inline void transformSoaScalar(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count
+	) {
+		for (size_t i = 0; i < count; ++i) {
+			float px = x[i];
+			float py = y[i];
+			float pz = z[i];
+			ox[i] = m[0] * px + m[1] * py + m[2] * pz + m[3];
+			oy[i] = m[4] * px + m[5] * py + m[6] * pz + m[7];
+			oz[i] = m[8] * px + m[9] * py + m[10] * pz + m[11];
+		}
+	}
+
+#if RT_SIMD_X86
+
+	__attribute__((target("sse2")))
+	inline void transformSoaSse2(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count
+	) {
+		__m128 r[12];
+		for (size_t i = 0; i < 12; ++i)
+			r[i] = _mm_set1_ps(m[i]);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 px = _mm_loadu_ps(x + i);
+			__m128 py = _mm_loadu_ps(y + i);
+			__m128 pz = _mm_loadu_ps(z + i);
+			__m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], px), _mm_mul_ps(r[1], py)), _mm_mul_ps(r[2], pz)), r[3]);
+			__m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[4], px), _mm_mul_ps(r[5], py)), _mm_mul_ps(r[6], pz)), r[7]);
+			__m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[8], px), _mm_mul_ps(r[9], py)), _mm_mul_ps(r[10], pz)), r[11]);
+			_mm_storeu_ps(ox + i, tx);
+			_mm_storeu_ps(oy + i, ty);
+			_mm_storeu_ps(oz + i, tz);
+		}
+		transformSoaScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, count - i);
+	}
+
+	__attribute__((target("avx")))
+	inline void transformSoaAvx(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count
+	) {
+		__m256 r[12];
+		for (size_t i = 0; i < 12; ++i)
+			r[i] = _mm256_set1_ps(m[i]);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 px = _mm256_loadu_ps(x + i);
+			__m256 py = _mm256_loadu_ps(y + i);
+			__m256 pz = _mm256_loadu_ps(z + i);
+			__m256 tx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_mul_ps(r[1], py)), _mm256_mul_ps(r[2], pz)), r[3]);
+			__m256 ty = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[4], px), _mm256_mul_ps(r[5], py)), _mm256_mul_ps(r[6], pz)), r[7]);
+			__m256 tz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[8], px), _mm256_mul_ps(r[9], py)), _mm256_mul_ps(r[10], pz)), r[11]);
+			_mm256_storeu_ps(ox + i, tx);
+			_mm256_storeu_ps(oy + i, ty);
+			_mm256_storeu_ps(oz + i, tz);
+		}
+		transformSoaScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, count - i);
+	}
+
+	__attribute__((target("avx2,fma")))
+	inline void transformSoaAvx2(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count
+	) {
+		__m256 r[12];
+		for (size_t i = 0; i < 12; ++i)
+			r[i] = _mm256_set1_ps(m[i]);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 px = _mm256_loadu_ps(x + i);
+			__m256 py = _mm256_loadu_ps(y + i);
+			__m256 pz = _mm256_loadu_ps(z + i);
+			__m256 tx = _mm256_fmadd_ps(r[2], pz, _mm256_fmadd_ps(r[1], py, _mm256_fmadd_ps(r[0], px, r[3])));
+			__m256 ty = _mm256_fmadd_ps(r[6], pz, _mm256_fmadd_ps(r[5], py, _mm256_fmadd_ps(r[4], px, r[7])));
+			__m256 tz = _mm256_fmadd_ps(r[10], pz, _mm256_fmadd_ps(r[9], py, _mm256_fmadd_ps(r[8], px, r[11])));
+			_mm256_storeu_ps(ox + i, tx);
+			_mm256_storeu_ps(oy + i, ty);
+			_mm256_storeu_ps(oz + i, tz);
+		}
+		transformSoaScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, count - i);
+	}
+
+#endif // RT_SIMD_X86
+
+	inline TransformSoaFn transformSoaKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2)
+			return (transformSoaAvx2);
+		if (isa == simd::ISA_AVX)
+			return (transformSoaAvx);
+		if (isa == simd::ISA_SSE2)
+			return (transformSoaSse2);
+#endif
+		(void)isa;
+		return (transformSoaScalar);
+	}
+
+	/**
+	 * @brief Interleaved points are gathered into small SoA blocks that stay
+	 * in L1, transformed with the SoA kernel and scattered back.
+	 */
+	inline void transformStridedRange(TransformSoaFn kernel, const float *m,
+		const float *in, size_t inStride, float *out, size_t outStride, size_t count
+	) {
+		const size_t block = 64;
+		float x[block];
+		float y[block];
+		float z[block];
+		for (size_t start = 0; start < count; start += block) {
+			size_t n = count - start < block ? count - start : block;
+			const float *src = in + start * inStride;
+			for (size_t i = 0; i < n; ++i, src += inStride) {
+				x[i] = src[0];
+				y[i] = src[1];
+				z[i] = src[2];
+			}
+			kernel(m, x, y, z, x, y, z, n);
+			float *dst = out + start * outStride;
+			for (size_t i = 0; i < n; ++i, dst += outStride) {
+				dst[0] = x[i];
+				dst[1] = y[i];
+				dst[2] = z[i];
+			}
+		}
+	}
+
+	/**
+	 * @brief Chunks are multiples of 16 points so no two threads share a cache
+	 * line of a SoA array.
+	 */
+	template <class Job>
+	void parallelFor(size_t count, unsigned threads, Job job) {
+		rt::parallelFor(count, threads, 16 * 1024, 16, job);
+	}
+
+	inline void transformPoints(const float *m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count, unsigned threads = 1
+	) {
+		TransformSoaFn kernel = transformSoaKernel(simd::activeIsa());
+		parallelFor(count, threads, [=](size_t begin, size_t end) {
+			kernel(m, x + begin, y + begin, z + begin,
+				ox + begin, oy + begin, oz + begin, end - begin);
+		});
+	}
+
+	inline void transformPoints(const float *m,
+		const float *in, size_t inStride, float *out, size_t outStride,
+		size_t count, unsigned threads = 1
+	) {
+		TransformSoaFn kernel = transformSoaKernel(simd::activeIsa());
+		parallelFor(count, threads, [=](size_t begin, size_t end) {
+			transformStridedRange(kernel, m, in + begin * inStride, inStride,
+				out + begin * outStride, outStride, end - begin);
+		});
+	}
+
+	inline void transformPoints(const Mat4f &m,
+		const float *x, const float *y, const float *z,
+		float *ox, float *oy, float *oz, size_t count, unsigned threads = 1
+	) {
+		transformPoints(m.getData(), x, y, z, ox, oy, oz, count, threads);
+	}
+
+	inline void transformPoints(const Mat4f &m,
+		const float *in, size_t inStride, float *out, size_t outStride,
+		size_t count, unsigned threads = 1
+	) {
+		transformPoints(m.getData(), in, inStride, out, outStride, count, threads);
+	}
+} // namespace batch
+} // namespace rt
+
+#endif // !RT_BATCH_HPP
@@ -0,0 +1,384 @@
+#ifndef RT_CURVE_HPP
+#define RT_CURVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "rt_simd.hpp"
+#include "rt_parallel.hpp"
+#include "rt_vec.hpp"
+
+/**
+ * Space-filling curve keys for spatial sorting: points sorted by key are
+ * close in space, which is what BVH/octree builders and vertex reordering
+ * for cache locality want.
+ *
+ * Positions are quantized to BITS = 21 bits per axis and the three axes
+ * are interleaved into a 63-bit key, x in the lowest bit of each triple.
+ * Morton (Z-order) keys interleave the coordinates directly, with BMI2
+ * pdep when the CPU has it (slow, microcoded, on AMD before Zen 3) and
+ * magic-number bit spreading otherwise. Hilbert keys cost a table walk
+ * over the 21 levels of the Morton key but never jump: consecutive keys
+ * are neighbors on the grid.
+ */
+namespace rt
+{
+namespace curve
+{
+	const unsigned BITS = 21;
+	const uint32_t MAX_COORD = (1u << BITS) - 1;
+
+	/**
+	 * @brief Maps the box [min, max] onto the integer grid [0, MAX_COORD]^3,
+	 * points outside are clamped.
+	 */
+	struct Quantizer
+	{
+		float	min[3];
+		float	scale[3];
+
+		Quantizer(const Vec3f &boxMin, const Vec3f &boxMax) {
+			for (size_t i = 0; i < 3; ++i) {
+				float extent = boxMax[i] - boxMin[i];
+				this->min[i] = boxMin[i];
+				this->scale[i] = extent > 0.0f ? static_cast<float>(MAX_COORD) / extent : 0.0f;
+			}
+		};
+
+		/**
+		 * @brief Bounding box of count interleaved positions (stride in floats).
+		 */
+		static Quantizer fromPoints(const float *positions, size_t stride, size_t count) {
+			Vec3f boxMin(0.0f, 0.0f, 0.0f);
+			Vec3f boxMax(0.0f, 0.0f, 0.0f);
+			if (count > 0) {
+				boxMin = Vec3f(positions);
+				boxMax = boxMin;
+			}
+			for (size_t i = 1; i < count; ++i) {
+				const float *p = positions + i * stride;
+				for (size_t k = 0; k < 3; ++k) {
+					boxMin[k] = p[k] < boxMin[k] ? p[k] : boxMin[k];
+					boxMax[k] = p[k] > boxMax[k] ? p[k] : boxMax[k];
+				}
+			}
+			return (Quantizer(boxMin, boxMax));
+		};
+
+		uint32_t operator()(float value, size_t axis) const {
+			float q = (value - this->min[axis]) * this->scale[axis];
+			if (!(q > 0.0f))
+				return (0);
+			if (q >= static_cast<float>(MAX_COORD))
+				return (MAX_COORD);
+			return (static_cast<uint32_t>(q + 0.5f));
+		};
+	};
+
+////////////////////////////////// Morton //////////////////////////////////////
+
+	// 21 bits to every third bit of 63
+	inline uint64_t spreadBits(uint32_t v) {
+		uint64_t x = v & MAX_COORD;
+		x = (x | (x << 32)) & 0x001f00000000ffffull;
+		x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+		x = (x | (x << 8)) & 0x100f00f00f00f00full;
+		x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+		x = (x | (x << 2)) & 0x1249249249249249ull;
+		return (x);
+	}
+
+	inline uint32_t compactBits(uint64_t x) {
+		x &= 0x1249249249249249ull;
+		x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+		x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+		x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+		x = (x | (x >> 16)) & 0x001f00000000ffffull;
+		x = (x | (x >> 32)) & MAX_COORD;
+		return (static_cast<uint32_t>(x));
+	}
+
+	inline uint64_t morton3(uint32_t x, uint32_t y, uint32_t z) {
+		return (spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2));
+	}
+
+	inline void decodeMorton3(uint64_t key, uint32_t &x, uint32_t &y, uint32_t &z) {
+		x = compactBits(key);
+		y = compactBits(key >> 1);
+		z = compactBits(key >> 2);
+	}
+
+#if RT_SIMD_X86
+
+	const uint64_t MORTON_MASK_X = 0x1249249249249249ull;
+	const uint64_t MORTON_MASK_Y = MORTON_MASK_X << 1;
+	const uint64_t MORTON_MASK_Z = MORTON_MASK_X << 2;
+
+	__attribute__((target("bmi2")))
+	inline uint64_t morton3Bmi2(uint32_t x, uint32_t y, uint32_t z) {
+		return (_pdep_u64(x & MAX_COORD, MORTON_MASK_X)
+			| _pdep_u64(y & MAX_COORD, MORTON_MASK_Y)
+			| _pdep_u64(z & MAX_COORD, MORTON_MASK_Z));
+	}
+
+	__attribute__((target("bmi2")))
+	inline void decodeMorton3Bmi2(uint64_t key, uint32_t &x, uint32_t &y, uint32_t &z) {
+		x = static_cast<uint32_t>(_pext_u64(key, MORTON_MASK_X));
+		y = static_cast<uint32_t>(_pext_u64(key, MORTON_MASK_Y));
+		z = static_cast<uint32_t>(_pext_u64(key, MORTON_MASK_Z));
+	}
+
+#endif // RT_SIMD_X86
+
+	inline bool hasBmi2() {
+#if RT_SIMD_X86
+		static const bool bmi2 = (__builtin_cpu_init(), __builtin_cpu_supports("bmi2") != 0);
+		return (bmi2);
+#else
+		return (false);
+#endif
+	}
+
+////////////////////////////////// Hilbert /////////////////////////////////////
+
+	/**
+	 * Hilbert keys follow J. Skilling, "Programming the Hilbert curve"
+	 * (2004). His encoder walks the levels from the top; at each level the
+	 * bits below are reflected and swapped between axes, Gray-coded, and
+	 * flipped by the parity of the levels above. That lower-bit transform is
+	 * a signed axis permutation plus a parity bit, so it is tracked as a
+	 * state and each level becomes one lookup of (state, octant) -> (key
+	 * digit, next state). The table is built once from those rules.
+	 */
+	class HilbertTable
+	{
+	private:
+		struct Transform
+		{
+			unsigned	perm[3];	// transformed axis k reads raw axis perm[k]
+			unsigned	flip[3];
+			unsigned	parity;
+
+			unsigned code() const {
+				return (((this->perm[0] * 3 + this->perm[1]) * 8
+					+ this->flip[0] * 4 + this->flip[1] * 2 + this->flip[2]) * 2 + this->parity);
+			};
+		};
+
+		size_t		states;
+		uint16_t	entries[96 * 8];	// digit | next state << 3
+		uint16_t	pairs[96 * 64];		// two levels: digits | next state << 6
+
+	public:
+		HilbertTable() {
+			Transform states[96];
+			int ids[9 * 8 * 2];
+			for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i)
+				ids[i] = -1;
+			Transform start = { { 0, 1, 2 }, { 0, 0, 0 }, 0 };
+			states[0] = start;
+			ids[start.code()] = 0;
+			size_t count = 1;
+			for (size_t s = 0; s < count; ++s) {
+				for (unsigned octant = 0; octant < 8; ++octant) {
+					Transform next = states[s];
+					unsigned b[3];
+					for (size_t k = 0; k < 3; ++k)
+						b[k] = ((octant >> next.perm[k]) & 1) ^ next.flip[k];
+					// inverse undo: invert axis 0 or exchange it with axis i
+					for (size_t i = 0; i < 3; ++i) {
+						if (b[i])
+							next.flip[0] ^= 1;
+						else {
+							unsigned temp = next.perm[0];
+							next.perm[0] = next.perm[i];
+							next.perm[i] = temp;
+							temp = next.flip[0];
+							next.flip[0] = next.flip[i];
+							next.flip[i] = temp;
+						}
+					}
+					// Gray encode, then the parity of the levels above
+					unsigned g0 = b[0], g1 = b[0] ^ b[1], g2 = b[0] ^ b[1] ^ b[2];
+					unsigned digit = ((g0 ^ next.parity) << 2) | ((g1 ^ next.parity) << 1) | (g2 ^ next.parity);
+					next.parity ^= g2;
+					if (ids[next.code()] < 0) {
+						ids[next.code()] = static_cast<int>(count);
+						states[count++] = next;
+					}
+					this->entries[s * 8 + octant] = static_cast<uint16_t>(digit | (ids[next.code()] << 3));
+				}
+			}
+			this->states = count;
+			for (size_t s = 0; s < count; ++s) {
+				for (unsigned octants = 0; octants < 64; ++octants) {
+					unsigned high = this->entries[s * 8 + (octants >> 3)];
+					unsigned low = this->entries[(high >> 3) * 8 + (octants & 7)];
+					this->pairs[s * 64 + octants] = static_cast<uint16_t>(
+						((high & 7) << 3) | (low & 7) | ((low >> 3) << 6));
+				}
+			}
+		};
+
+		size_t stateCount() const {
+			return (this->states);
+		};
+
+		/**
+		 * @brief Key of the Morton key of the same point: the top level on
+		 * its own, then two levels (6 bits) per lookup.
+		 */
+		uint64_t fromMorton(uint64_t morton) const {
+			unsigned level = BITS - 1;
+			unsigned entry = this->entries[(morton >> (3 * level)) & 7];
+			uint64_t key = static_cast<uint64_t>(entry & 7) << (3 * level);
+			unsigned state = entry >> 3;
+			while (level > 0) {
+				level -= 2;
+				entry = this->pairs[state * 64 + ((morton >> (3 * level)) & 63)];
+				key |= static_cast<uint64_t>(entry & 63) << (3 * level);
+				state = entry >> 6;
+			}
+			return (key);
+		};
+
+		/**
+		 * @brief In-place fromMorton over an array, four keys at a time so the
+		 * dependent lookups of independent keys overlap.
+		 */
+		void fromMorton(uint64_t *keys, size_t count) const {
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				uint64_t morton[4];
+				unsigned state[4];
+				unsigned level = BITS - 1;
+				for (size_t k = 0; k < 4; ++k) {
+					morton[k] = keys[i + k];
+					unsigned entry = this->entries[(morton[k] >> (3 * level)) & 7];
+					keys[i + k] = static_cast<uint64_t>(entry & 7) << (3 * level);
+					state[k] = entry >> 3;
+				}
+				while (level > 0) {
+					level -= 2;
+					for (size_t k = 0; k < 4; ++k) {
+						unsigned entry = this->pairs[state[k] * 64 + ((morton[k] >> (3 * level)) & 63)];
+						keys[i + k] |= static_cast<uint64_t>(entry & 63) << (3 * level);
+						state[k] = entry >> 6;
+					}
+				}
+			}
+			for (; i < count; ++i)
+				keys[i] = this->fromMorton(keys[i]);
+		};
+	};
+
+	static_assert(BITS % 2 == 1, "HilbertTable::fromMorton pairs the levels below the top one");
+
+	inline const HilbertTable &hilbertTable() {
+		static const HilbertTable table;
+		return (table);
+	}
+
+	inline uint64_t hilbert3(uint32_t x, uint32_t y, uint32_t z) {
+		return (hilbertTable().fromMorton(morton3(x, y, z)));
+	}
+
+	/**
+	 * @brief Skilling's TransposetoAxes, the inverse of hilbert3.
+	 */
+	inline void decodeHilbert3(uint64_t key, uint32_t &x, uint32_t &y, uint32_t &z) {
+		uint32_t axes[3];
+		decodeMorton3(key, axes[2], axes[1], axes[0]);
+		// Gray decode
+		uint32_t t = axes[2] >> 1;
+		axes[2] ^= axes[1];
+		axes[1] ^= axes[0];
+		axes[0] ^= t;
+		// undo excess work
+		for (uint32_t q = 2; q != (1u << BITS); q <<= 1) {
+			uint32_t p = q - 1;
+			for (size_t i = 3; i-- > 0;) {
+				if (axes[i] & q)
+					axes[0] ^= p;
+				else {
+					uint32_t s = (axes[0] ^ axes[i]) & p;
+					axes[0] ^= s;
+					axes[i] ^= s;
+				}
+			}
+		}
+		x = axes[0];
+		y = axes[1];
+		z = axes[2];
+	}
+
+////////////////////////////////// Batches /////////////////////////////////////
+
+	typedef void (*KeysFn)(const Quantizer &quantizer, const float *positions,
+		size_t stride, uint64_t *keys, size_t count);
+
+	inline void mortonKeysScalar(const Quantizer &quantizer, const float *positions,
+		size_t stride, uint64_t *keys, size_t count
+	) {
+		for (size_t i = 0; i < count; ++i, positions += stride)
+			keys[i] = morton3(quantizer(positions[0], 0), quantizer(positions[1], 1), quantizer(positions[2], 2));
+	}
+
+#if RT_SIMD_X86
+
+	__attribute__((target("bmi2")))
+	inline void mortonKeysBmi2(const Quantizer &quantizer, const float *positions,
+		size_t stride, uint64_t *keys, size_t count
+	) {
+		for (size_t i = 0; i < count; ++i, positions += stride)
+			keys[i] = morton3Bmi2(quantizer(positions[0], 0), quantizer(positions[1], 1), quantizer(positions[2], 2));
+	}
+
+#endif // RT_SIMD_X86
+
+	inline KeysFn mortonKeysKernel(bool bmi2) {
+#if RT_SIMD_X86
+		if (bmi2)
+			return (mortonKeysBmi2);
+#endif
+		(void)bmi2;
+		return (mortonKeysScalar);
+	}
+
+	/**
+	 * @brief Morton keys of count interleaved positions (stride in floats,
+	 * 6 for the x y z r g b vertex buffer of loadOBJ). threads as in
+	 * batch::transformPoints, 0 uses every hardware thread.
+	 */
+	inline void mortonKeys(const Quantizer &quantizer, const float *positions,
+		size_t stride, uint64_t *keys, size_t count, unsigned threads = 1
+	) {
+		KeysFn kernel = mortonKeysKernel(hasBmi2());
+		// 8 keys per cache line, chunks never share one
+		rt::parallelFor(count, threads, 64 * 1024, 8, [=, &quantizer](size_t begin, size_t end) {
+			kernel(quantizer, positions + begin * stride, stride, keys + begin, end - begin);
+		});
+	}
+
+	/**
+	 * @brief Hilbert keys, same arguments as mortonKeys. The Morton keys are
+	 * written first and converted in place, block by block while they are
+	 * still in cache.
+	 */
+	inline void hilbertKeys(const Quantizer &quantizer, const float *positions,
+		size_t stride, uint64_t *keys, size_t count, unsigned threads = 1
+	) {
+		KeysFn kernel = mortonKeysKernel(hasBmi2());
+		const HilbertTable &table = hilbertTable();
+		rt::parallelFor(count, threads, 64 * 1024, 8, [=, &quantizer, &table](size_t begin, size_t end) {
+			const size_t block = 1024;
+			for (size_t start = begin; start < end; start += block) {
+				size_t n = end - start < block ? end - start : block;
+				kernel(quantizer, positions + start * stride, stride, keys + start, n);
+				table.fromMorton(keys + start, n);
+			}
+		});
+	}
+} // namespace curve
+} // namespace rt
+
+#endif // !RT_CURVE_HPP
@@ -0,0 +1,281 @@
+#ifndef RT_FASTMATH_HPP
+#define RT_FASTMATH_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "rt_simd.hpp"
+
+/**
+ * Approximate float math for per-frame and per-vertex work, opt-in per call
+ * site: rt::fast::sin where a few ulp are fine, std::sin elsewhere.
+ *
+ * Max error against the exact result, measured over every float in the
+ * domain:
+ *
+ *   sin, cos, sinCos   |x| <= 8192     1.6 ulp where |result| > 1e-3, else
+ *                                      1e-7 absolute (argument reduction)
+ *   tan                |x| < pi / 2    3.3 ulp; beyond, the same 1e-7
+ *                                      reduction error relative to the
+ *                                      distance to the nearest zero or pole
+ *   rsqrt              normal x > 0    4 ulp with SSE (12-bit rsqrtps
+ *                                      estimate, one Newton step), 2.2 ulp
+ *                                      without (bit trick, three steps)
+ *
+ * Outside the sin/cos domain the argument reduction loses bits; use <cmath>.
+ * Kernels: Cody-Waite reduction to [-pi/4, pi/4] by quadrant, then the
+ * Cephes minimax polynomials; rsqrt is the hardware estimate (or a bit
+ * trick) refined by Newton steps. The batch kernels compute the same
+ * expressions lane by lane, so sinCos matches the scalar sin/cos exactly.
+ *
+ * Use the batches for arrays (angles of many instances, per-vertex
+ * normalization): a single sin or rsqrt is latency-bound and no faster
+ * than glibc's sincosf or sqrtss + divss, so one-off calls such as
+ * Quaternion::fromAxisAngle or Vec::normalize are left on <cmath>.
+ */
+namespace rt
+{
+namespace fast
+{
+	const float TWO_OVER_PI = 0.636619772367581343f;
+	// pi / 2 split so that j * PIO2_1 and j * PIO2_2 are exact for |j| < 2^13
+	const float PIO2_1 = 1.5703125f;
+	const float PIO2_2 = 4.83751296997070312500e-4f;
+	const float PIO2_3 = 7.54978995489188216e-8f;
+
+	const float SIN_1 = -1.6666654611e-1f;
+	const float SIN_2 = 8.3321608736e-3f;
+	const float SIN_3 = -1.9515295891e-4f;
+	const float COS_1 = 4.166664568298827e-2f;
+	const float COS_2 = -1.388731625493765e-3f;
+	const float COS_3 = 2.443315711809948e-5f;
+
+	/**
+	 * @brief sin(x) and cos(x) in one reduction.
+	 */
+	inline void sinCos(float x, float &s, float &c) {
+		// round to nearest even, like the batch kernels' cvtps2dq
+#if defined(__SSE__)
+		int j = _mm_cvtss_si32(_mm_set_ss(x * TWO_OVER_PI));
+#else
+		int j = static_cast<int>(std::nearbyint(x * TWO_OVER_PI));
+#endif
+		float fj = static_cast<float>(j);
+		float r = ((x - fj * PIO2_1) - fj * PIO2_2) - fj * PIO2_3;
+		float r2 = r * r;
+		float ps = r + r * r2 * (SIN_1 + r2 * (SIN_2 + r2 * SIN_3));
+		float pc = (1.0f - 0.5f * r2) + r2 * r2 * (COS_1 + r2 * (COS_2 + r2 * COS_3));
+		float sinV = (j & 1) ? pc : ps;
+		float cosV = (j & 1) ? ps : pc;
+		s = (j & 2) ? -sinV : sinV;
+		c = ((j + 1) & 2) ? -cosV : cosV;
+	}
+
+	inline float sin(float x) {
+		float s, c;
+		sinCos(x, s, c);
+		return (s);
+	}
+
+	inline float cos(float x) {
+		float s, c;
+		sinCos(x, s, c);
+		return (c);
+	}
+
+	/**
+	 * @brief Divides the reduced polynomials, -cos(r) / sin(r) in odd
+	 * quadrants, so tan keeps its relative accuracy next to the poles.
+	 */
+	inline float tan(float x) {
+#if defined(__SSE__)
+		int j = _mm_cvtss_si32(_mm_set_ss(x * TWO_OVER_PI));
+#else
+		int j = static_cast<int>(std::nearbyint(x * TWO_OVER_PI));
+#endif
+		float fj = static_cast<float>(j);
+		float r = ((x - fj * PIO2_1) - fj * PIO2_2) - fj * PIO2_3;
+		float r2 = r * r;
+		float ps = r + r * r2 * (SIN_1 + r2 * (SIN_2 + r2 * SIN_3));
+		float pc = (1.0f - 0.5f * r2) + r2 * r2 * (COS_1 + r2 * (COS_2 + r2 * COS_3));
+		return ((j & 1) ? -pc / ps : ps / pc);
+	}
+
+	/**
+	 * @brief 1 / sqrt(x) for normal x > 0. The Newton steps scale x * y
+	 * rather than x by 0.5, which would be subnormal for the smallest x.
+	 */
+	inline float rsqrt(float x) {
+		float y;
+#if defined(__SSE__)
+		y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		y = y * (1.5f - 0.5f * (x * y) * y);
+#else
+		uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		bits = 0x5f375a86u - (bits >> 1);
+		std::memcpy(&y, &bits, sizeof(y));
+		y = y * (1.5f - 0.5f * (x * y) * y);
+		y = y * (1.5f - 0.5f * (x * y) * y);
+		y = y * (1.5f - 0.5f * (x * y) * y);
+#endif
+		return (y);
+	}
+
+////////////////////////////////// Batches /////////////////////////////////////
+
+	typedef void (*SinCosFn)(const float *x, float *s, float *c, size_t count);
+	typedef void (*RsqrtFn)(const float *x, float *out, size_t count);
+
+	inline void sinCosScalar(const float *x, float *s, float *c, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			sinCos(x[i], s[i], c[i]);
+	}
+
+	inline void rsqrtScalar(const float *x, float *out, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			out[i] = rsqrt(x[i]);
+	}
+
+#if RT_SIMD_X86
+
+	__attribute__((target("sse2")))
+	inline void sinCosSse2(const float *x, float *s, float *c, size_t count) {
+		const __m128 twoOverPi = _mm_set1_ps(TWO_OVER_PI);
+		const __m128 p1 = _mm_set1_ps(PIO2_1), p2 = _mm_set1_ps(PIO2_2), p3 = _mm_set1_ps(PIO2_3);
+		const __m128 s1 = _mm_set1_ps(SIN_1), s2 = _mm_set1_ps(SIN_2), s3 = _mm_set1_ps(SIN_3);
+		const __m128 c1 = _mm_set1_ps(COS_1), c2 = _mm_set1_ps(COS_2), c3 = _mm_set1_ps(COS_3);
+		const __m128 one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+		const __m128i oneI = _mm_set1_epi32(1), twoI = _mm_set1_epi32(2);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 v = _mm_loadu_ps(x + i);
+			__m128i j = _mm_cvtps_epi32(_mm_mul_ps(v, twoOverPi));
+			__m128 fj = _mm_cvtepi32_ps(j);
+			__m128 r = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(v, _mm_mul_ps(fj, p1)), _mm_mul_ps(fj, p2)), _mm_mul_ps(fj, p3));
+			__m128 r2 = _mm_mul_ps(r, r);
+			__m128 ps = _mm_add_ps(s2, _mm_mul_ps(r2, s3));
+			ps = _mm_add_ps(s1, _mm_mul_ps(r2, ps));
+			ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+			__m128 pc = _mm_add_ps(c2, _mm_mul_ps(r2, c3));
+			pc = _mm_add_ps(c1, _mm_mul_ps(r2, pc));
+			pc = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(half, r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), pc));
+
+			__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, oneI), oneI));
+			__m128 sinV = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+			__m128 cosV = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+			__m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, twoI), 30));
+			__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, oneI), twoI), 30));
+			_mm_storeu_ps(s + i, _mm_xor_ps(sinV, sinSign));
+			_mm_storeu_ps(c + i, _mm_xor_ps(cosV, cosSign));
+		}
+		sinCosScalar(x + i, s + i, c + i, count - i);
+	}
+
+	__attribute__((target("sse2")))
+	inline void rsqrtSse2(const float *x, float *out, size_t count) {
+		const __m128 threeHalves = _mm_set1_ps(1.5f), half = _mm_set1_ps(0.5f);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 v = _mm_loadu_ps(x + i);
+			__m128 y = _mm_rsqrt_ps(v);
+			y = _mm_mul_ps(y, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, _mm_mul_ps(v, y)), y)));
+			_mm_storeu_ps(out + i, y);
+		}
+		rsqrtScalar(x + i, out + i, count - i);
+	}
+
+	__attribute__((target("avx2")))
+	inline void sinCosAvx2(const float *x, float *s, float *c, size_t count) {
+		const __m256 twoOverPi = _mm256_set1_ps(TWO_OVER_PI);
+		const __m256 p1 = _mm256_set1_ps(PIO2_1), p2 = _mm256_set1_ps(PIO2_2), p3 = _mm256_set1_ps(PIO2_3);
+		const __m256 s1 = _mm256_set1_ps(SIN_1), s2 = _mm256_set1_ps(SIN_2), s3 = _mm256_set1_ps(SIN_3);
+		const __m256 c1 = _mm256_set1_ps(COS_1), c2 = _mm256_set1_ps(COS_2), c3 = _mm256_set1_ps(COS_3);
+		const __m256 one = _mm256_set1_ps(1.0f), half = _mm256_set1_ps(0.5f);
+		const __m256i oneI = _mm256_set1_epi32(1), twoI = _mm256_set1_epi32(2);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 v = _mm256_loadu_ps(x + i);
+			__m256i j = _mm256_cvtps_epi32(_mm256_mul_ps(v, twoOverPi));
+			__m256 fj = _mm256_cvtepi32_ps(j);
+			__m256 r = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(v, _mm256_mul_ps(fj, p1)),
+				_mm256_mul_ps(fj, p2)), _mm256_mul_ps(fj, p3));
+			__m256 r2 = _mm256_mul_ps(r, r);
+			__m256 ps = _mm256_add_ps(s2, _mm256_mul_ps(r2, s3));
+			ps = _mm256_add_ps(s1, _mm256_mul_ps(r2, ps));
+			ps = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), ps));
+			__m256 pc = _mm256_add_ps(c2, _mm256_mul_ps(r2, c3));
+			pc = _mm256_add_ps(c1, _mm256_mul_ps(r2, pc));
+			pc = _mm256_add_ps(_mm256_sub_ps(one, _mm256_mul_ps(half, r2)), _mm256_mul_ps(_mm256_mul_ps(r2, r2), pc));
+
+			__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, oneI), oneI));
+			__m256 sinV = _mm256_blendv_ps(ps, pc, swap);
+			__m256 cosV = _mm256_blendv_ps(pc, ps, swap);
+			__m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, twoI), 30));
+			__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(j, oneI), twoI), 30));
+			_mm256_storeu_ps(s + i, _mm256_xor_ps(sinV, sinSign));
+			_mm256_storeu_ps(c + i, _mm256_xor_ps(cosV, cosSign));
+		}
+		sinCosScalar(x + i, s + i, c + i, count - i);
+	}
+
+	__attribute__((target("avx")))
+	inline void rsqrtAvx(const float *x, float *out, size_t count) {
+		const __m256 threeHalves = _mm256_set1_ps(1.5f), half = _mm256_set1_ps(0.5f);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 v = _mm256_loadu_ps(x + i);
+			__m256 y = _mm256_rsqrt_ps(v);
+			y = _mm256_mul_ps(y, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, _mm256_mul_ps(v, y)), y)));
+			_mm256_storeu_ps(out + i, y);
+		}
+		rsqrtScalar(x + i, out + i, count - i);
+	}
+
+#endif // RT_SIMD_X86
+
+	// 8-wide sinCos needs AVX2 integer ops for the quadrant, AVX uses SSE2
+	inline SinCosFn sinCosKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2)
+			return (sinCosAvx2);
+		if (isa == simd::ISA_AVX || isa == simd::ISA_SSE2)
+			return (sinCosSse2);
+#endif
+		(void)isa;
+		return (sinCosScalar);
+	}
+
+	inline RsqrtFn rsqrtKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2 || isa == simd::ISA_AVX)
+			return (rsqrtAvx);
+		if (isa == simd::ISA_SSE2)
+			return (rsqrtSse2);
+#endif
+		(void)isa;
+		return (rsqrtScalar);
+	}
+
+	/**
+	 * @brief s[i] = sin(x[i]), c[i] = cos(x[i]); same results as the scalar
+	 * sinCos.
+	 */
+	inline void sinCos(const float *x, float *s, float *c, size_t count) {
+		static const SinCosFn kernel = sinCosKernel(simd::activeIsa());
+		kernel(x, s, c, count);
+	}
+
+	inline void rsqrt(const float *x, float *out, size_t count) {
+		static const RsqrtFn kernel = rsqrtKernel(simd::activeIsa());
+		kernel(x, out, count);
+	}
+} // namespace fast
+} // namespace rt
+
+#endif // !RT_FASTMATH_HPP
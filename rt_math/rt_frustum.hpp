@@ -0,0 +1,411 @@
+#ifndef RT_FRUSTUM_HPP
+#define RT_FRUSTUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "rt_simd.hpp"
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+#include "rt_transform.hpp"
+
+namespace rt
+{
+	/**
+	 * View frustum as six inward-facing planes (a, b, c, d) with unit normals:
+	 * a point p is inside a plane when a * px + b * py + c * pz + d >= 0.
+	 *
+	 * fromMatrix extracts the planes from a clip matrix (Gribb & Hartmann) in
+	 * the Mat convention clip = m * p with clip z in [-w, w]. Pass
+	 * projection * view for world-space bounds or projection * view * model
+	 * for object-space ones.
+	 */
+	template <class T>
+	class Frustum
+	{
+	public:
+		enum Plane
+		{
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		Vec<T, 4> planes[PLANE_COUNT];
+
+		static constexpr Frustum<T> fromMatrix(const Mat<T, 4, 4>& m) {
+			Frustum<T> frustum;
+			for (size_t j = 0; j < 4; ++j) {
+				frustum.planes[PLANE_LEFT][j] = m[3][j] + m[0][j];
+				frustum.planes[PLANE_RIGHT][j] = m[3][j] - m[0][j];
+				frustum.planes[PLANE_BOTTOM][j] = m[3][j] + m[1][j];
+				frustum.planes[PLANE_TOP][j] = m[3][j] - m[1][j];
+				frustum.planes[PLANE_NEAR][j] = m[3][j] + m[2][j];
+				frustum.planes[PLANE_FAR][j] = m[3][j] - m[2][j];
+			}
+			for (size_t i = 0; i < PLANE_COUNT; ++i) {
+				Vec<T, 4> &p = frustum.planes[i];
+				T len = ct::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+				if (len > static_cast<T>(0.0))
+					p = p * (static_cast<T>(1.0) / len);
+			}
+			return (frustum);
+		};
+
+		constexpr bool intersectsSphere(const Vec<T, 3>& center, T radius) const {
+			for (size_t i = 0; i < PLANE_COUNT; ++i) {
+				const Vec<T, 4> &p = this->planes[i];
+				if (p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3] < -radius)
+					return (false);
+			}
+			return (true);
+		};
+
+		/**
+		 * @brief Conservative: a box crossing two planes outside a corner of the
+		 * frustum is reported visible.
+		 */
+		constexpr bool intersectsAabb(const Vec<T, 3>& min, const Vec<T, 3>& max) const {
+			for (size_t i = 0; i < PLANE_COUNT; ++i) {
+				const Vec<T, 4> &p = this->planes[i];
+				// the corner furthest along the normal
+				T x = p[0] >= static_cast<T>(0.0) ? max[0] : min[0];
+				T y = p[1] >= static_cast<T>(0.0) ? max[1] : min[1];
+				T z = p[2] >= static_cast<T>(0.0) ? max[2] : min[2];
+				if (p[0] * x + p[1] * y + p[2] * z + p[3] < static_cast<T>(0.0))
+					return (false);
+			}
+			return (true);
+		};
+	};
+
+	typedef Frustum<float>	Frustumf;
+	typedef Frustum<double>	Frustumd;
+
+	static_assert(Frustumd::fromMatrix(perspective(radians(90.0), 1.0, 1.0, 3.0))
+		.intersectsSphere(Vec3d(0.0, 0.0, -2.0), 0.1));
+	static_assert(!Frustumd::fromMatrix(perspective(radians(90.0), 1.0, 1.0, 3.0))
+		.intersectsSphere(Vec3d(0.0, 0.0, 2.0), 0.1));
+
+/**
+ * Batch culling of SoA bounds against a Frustumf. The result is a bitmask,
+ * bit i % 64 of mask[i / 64] set when bound i is (possibly) visible; the
+ * caller provides (count + 63) / 64 words and bits past count are zero.
+ * Kernels test 8 bounds per step with AVX, 4 with SSE2, and sum the plane
+ * terms in the order Frustum does, so every kernel gives the same bits as
+ * intersectsSphere and intersectsAabb.
+ */
+namespace cull
+{
+	/**
+	 * Frustum planes transposed for broadcasting: nx[6], ny[6], nz[6], d[6].
+	 */
+	struct Planes
+	{
+		float data[4 * Frustumf::PLANE_COUNT];
+
+		explicit Planes(const Frustumf& frustum) {
+			const size_t n = Frustumf::PLANE_COUNT;
+			for (size_t i = 0; i < n; ++i)
+				for (size_t j = 0; j < 4; ++j)
+					this->data[j * n + i] = frustum.planes[i][j];
+		};
+	};
+
+	typedef void (*SpheresFn)(const Planes &planes,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t count, uint64_t *mask);
+	typedef void (*AabbsFn)(const Planes &planes,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t count, uint64_t *mask);
+
+	inline bool sphereVisible(const float *p, float x, float y, float z, float r) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		bool visible = true;
+		for (size_t i = 0; i < n; ++i)
+			visible &= p[i] * x + p[n + i] * y + p[2 * n + i] * z + p[3 * n + i] >= -r;
+		return (visible);
+	}
+
+	// Tests the corner furthest along each normal, as intersectsAabb does.
+	inline bool aabbVisible(const float *p,
+		float minX, float minY, float minZ, float maxX, float maxY, float maxZ
+	) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		bool visible = true;
+		for (size_t i = 0; i < n; ++i) {
+			float x = p[i] >= 0.0f ? maxX : minX;
+			float y = p[n + i] >= 0.0f ? maxY : minY;
+			float z = p[2 * n + i] >= 0.0f ? maxZ : minZ;
+			visible &= p[i] * x + p[n + i] * y + p[2 * n + i] * z + p[3 * n + i] >= 0.0f;
+		}
+		return (visible);
+	}
+
+	/**
+	 * @brief Per plane, the bound arrays holding its furthest corner.
+	 */
+	struct Corners
+	{
+		const float *x[Frustumf::PLANE_COUNT];
+		const float *y[Frustumf::PLANE_COUNT];
+		const float *z[Frustumf::PLANE_COUNT];
+
+		Corners(const Planes &planes,
+			const float *minX, const float *minY, const float *minZ,
+			const float *maxX, const float *maxY, const float *maxZ
+		) {
+			const size_t n = Frustumf::PLANE_COUNT;
+			for (size_t k = 0; k < n; ++k) {
+				this->x[k] = planes.data[k] >= 0.0f ? maxX : minX;
+				this->y[k] = planes.data[n + k] >= 0.0f ? maxY : minY;
+				this->z[k] = planes.data[2 * n + k] >= 0.0f ? maxZ : minZ;
+			}
+		};
+	};
+
+	inline void cullSpheresScalar(const Planes &planes,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t count, uint64_t *mask
+	) {
+		for (size_t w = 0; w < (count + 63) / 64; ++w)
+			mask[w] = 0;
+		for (size_t i = 0; i < count; ++i)
+			if (sphereVisible(planes.data, x[i], y[i], z[i], radius[i]))
+				mask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+	}
+
+	inline void cullAabbsScalar(const Planes &planes,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t count, uint64_t *mask
+	) {
+		for (size_t w = 0; w < (count + 63) / 64; ++w)
+			mask[w] = 0;
+		for (size_t i = 0; i < count; ++i)
+			if (aabbVisible(planes.data, minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i]))
+				mask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+	}
+
+#if RT_SIMD_X86
+
+	/**
+	 * @brief Sets the bits of the tail [done, count) with the scalar tests.
+	 */
+	inline void cullSpheresTail(const Planes &planes,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t done, size_t count, uint64_t *mask
+	) {
+		for (size_t i = done; i < count; ++i) {
+			if (i % 64 == 0)
+				mask[i / 64] = 0;
+			if (sphereVisible(planes.data, x[i], y[i], z[i], radius[i]))
+				mask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+		}
+	}
+
+	inline void cullAabbsTail(const Planes &planes,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t done, size_t count, uint64_t *mask
+	) {
+		for (size_t i = done; i < count; ++i) {
+			if (i % 64 == 0)
+				mask[i / 64] = 0;
+			if (aabbVisible(planes.data, minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i]))
+				mask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+		}
+	}
+
+	__attribute__((target("sse2")))
+	inline void cullSpheresSse2(const Planes &planes,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t count, uint64_t *mask
+	) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		__m128 p[4 * n];
+		for (size_t i = 0; i < 4 * n; ++i)
+			p[i] = _mm_set1_ps(planes.data[i]);
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+		size_t i = 0;
+		for (; i + 64 <= count; i += 64) {
+			uint64_t word = 0;
+			for (size_t g = 0; g < 64; g += 4) {
+				__m128 px = _mm_loadu_ps(x + i + g);
+				__m128 py = _mm_loadu_ps(y + i + g);
+				__m128 pz = _mm_loadu_ps(z + i + g);
+				__m128 negR = _mm_xor_ps(_mm_loadu_ps(radius + i + g), signBit);
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (size_t k = 0; k < n; ++k) {
+					__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[k], px),
+						_mm_mul_ps(p[n + k], py)), _mm_mul_ps(p[2 * n + k], pz)), p[3 * n + k]);
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negR));
+				}
+				word |= static_cast<uint64_t>(_mm_movemask_ps(inside)) << g;
+			}
+			mask[i / 64] = word;
+		}
+		cullSpheresTail(planes, x, y, z, radius, i, count, mask);
+	}
+
+	__attribute__((target("sse2")))
+	inline void cullAabbsSse2(const Planes &planes,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t count, uint64_t *mask
+	) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		__m128 p[4 * n];
+		for (size_t i = 0; i < 4 * n; ++i)
+			p[i] = _mm_set1_ps(planes.data[i]);
+		const Corners corners(planes, minX, minY, minZ, maxX, maxY, maxZ);
+		const __m128 zero = _mm_setzero_ps();
+		size_t i = 0;
+		for (; i + 64 <= count; i += 64) {
+			uint64_t word = 0;
+			for (size_t g = 0; g < 64; g += 4) {
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (size_t k = 0; k < n; ++k) {
+					__m128 cx = _mm_loadu_ps(corners.x[k] + i + g);
+					__m128 cy = _mm_loadu_ps(corners.y[k] + i + g);
+					__m128 cz = _mm_loadu_ps(corners.z[k] + i + g);
+					__m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[k], cx),
+						_mm_mul_ps(p[n + k], cy)), _mm_mul_ps(p[2 * n + k], cz)), p[3 * n + k]);
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, zero));
+				}
+				word |= static_cast<uint64_t>(_mm_movemask_ps(inside)) << g;
+			}
+			mask[i / 64] = word;
+		}
+		cullAabbsTail(planes, minX, minY, minZ, maxX, maxY, maxZ, i, count, mask);
+	}
+
+	__attribute__((target("avx")))
+	inline void cullSpheresAvx(const Planes &planes,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t count, uint64_t *mask
+	) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		__m256 p[4 * n];
+		for (size_t i = 0; i < 4 * n; ++i)
+			p[i] = _mm256_set1_ps(planes.data[i]);
+		const __m256 signBit = _mm256_set1_ps(-0.0f);
+		size_t i = 0;
+		for (; i + 64 <= count; i += 64) {
+			uint64_t word = 0;
+			for (size_t g = 0; g < 64; g += 8) {
+				__m256 px = _mm256_loadu_ps(x + i + g);
+				__m256 py = _mm256_loadu_ps(y + i + g);
+				__m256 pz = _mm256_loadu_ps(z + i + g);
+				__m256 negR = _mm256_xor_ps(_mm256_loadu_ps(radius + i + g), signBit);
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (size_t k = 0; k < n; ++k) {
+					__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p[k], px),
+						_mm256_mul_ps(p[n + k], py)), _mm256_mul_ps(p[2 * n + k], pz)), p[3 * n + k]);
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+				}
+				word |= static_cast<uint64_t>(_mm256_movemask_ps(inside)) << g;
+			}
+			mask[i / 64] = word;
+		}
+		cullSpheresTail(planes, x, y, z, radius, i, count, mask);
+	}
+
+	__attribute__((target("avx")))
+	inline void cullAabbsAvx(const Planes &planes,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t count, uint64_t *mask
+	) {
+		const size_t n = Frustumf::PLANE_COUNT;
+		__m256 p[4 * n];
+		for (size_t i = 0; i < 4 * n; ++i)
+			p[i] = _mm256_set1_ps(planes.data[i]);
+		const Corners corners(planes, minX, minY, minZ, maxX, maxY, maxZ);
+		const __m256 zero = _mm256_setzero_ps();
+		size_t i = 0;
+		for (; i + 64 <= count; i += 64) {
+			uint64_t word = 0;
+			for (size_t g = 0; g < 64; g += 8) {
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (size_t k = 0; k < n; ++k) {
+					__m256 cx = _mm256_loadu_ps(corners.x[k] + i + g);
+					__m256 cy = _mm256_loadu_ps(corners.y[k] + i + g);
+					__m256 cz = _mm256_loadu_ps(corners.z[k] + i + g);
+					__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p[k], cx),
+						_mm256_mul_ps(p[n + k], cy)), _mm256_mul_ps(p[2 * n + k], cz)), p[3 * n + k]);
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, zero, _CMP_GE_OQ));
+				}
+				word |= static_cast<uint64_t>(_mm256_movemask_ps(inside)) << g;
+			}
+			mask[i / 64] = word;
+		}
+		cullAabbsTail(planes, minX, minY, minZ, maxX, maxY, maxZ, i, count, mask);
+	}
+
+#endif // RT_SIMD_X86
+
+	inline SpheresFn cullSpheresKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		// compare-bound, FMA gains nothing: AVX2 reuses AVX
+		if (isa == simd::ISA_AVX2 || isa == simd::ISA_AVX)
+			return (cullSpheresAvx);
+		if (isa == simd::ISA_SSE2)
+			return (cullSpheresSse2);
+#endif
+		(void)isa;
+		return (cullSpheresScalar);
+	}
+
+	inline AabbsFn cullAabbsKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2 || isa == simd::ISA_AVX)
+			return (cullAabbsAvx);
+		if (isa == simd::ISA_SSE2)
+			return (cullAabbsSse2);
+#endif
+		(void)isa;
+		return (cullAabbsScalar);
+	}
+
+	inline size_t countVisible(const uint64_t *mask, size_t count) {
+		size_t visible = 0;
+		for (size_t w = 0; w < (count + 63) / 64; ++w)
+			visible += __builtin_popcountll(mask[w]);
+		return (visible);
+	}
+
+	/**
+	 * @brief Tests count spheres (center, radius) and returns how many are
+	 * visible.
+	 */
+	inline size_t cullSpheres(const Frustumf& frustum,
+		const float *x, const float *y, const float *z, const float *radius,
+		size_t count, uint64_t *mask
+	) {
+		static const SpheresFn kernel = cullSpheresKernel(simd::activeIsa());
+		kernel(Planes(frustum), x, y, z, radius, count, mask);
+		return (countVisible(mask, count));
+	}
+
+	/**
+	 * @brief Tests count boxes (min, max corners) and returns how many are
+	 * visible.
+	 */
+	inline size_t cullAabbs(const Frustumf& frustum,
+		const float *minX, const float *minY, const float *minZ,
+		const float *maxX, const float *maxY, const float *maxZ,
+		size_t count, uint64_t *mask
+	) {
+		static const AabbsFn kernel = cullAabbsKernel(simd::activeIsa());
+		kernel(Planes(frustum), minX, minY, minZ, maxX, maxY, maxZ, count, mask);
+		return (countVisible(mask, count));
+	}
+} // namespace cull
+} // namespace rt
+
+#endif // !RT_FRUSTUM_HPP
@@ -0,0 +1,401 @@
+#ifndef RT_GEMM_HPP
+#define RT_GEMM_HPP
+
+#include <cstddef>
+#include "rt_simd.hpp"
+#include "rt_parallel.hpp"
+
+/**
+ * Cache-blocked matrix product for large row-major matrices:
+ * C += alpha * A * B, with A m x k, B k x n and C m x n, each with its own
+ * leading dimension (distance between rows, in elements).
+ *
+ * Loop order and packing follow the usual GotoBLAS scheme: a kc x nc panel
+ * of B is packed to stay in L3/L2, an mc x kc block of A is packed to stay
+ * in L2, and an MR x NR micro-kernel keeps a tile of C in registers while
+ * streaming both packed buffers. Rows of C are split across threads, each
+ * thread packing its own copy of B. C must not overlap A or B.
+ *
+ * float and double have AVX and AVX2+FMA micro-kernels picked from
+ * simd::activeIsa(); anything else (and non-x86) uses the scalar one.
+ */
+namespace rt
+{
+namespace gemm
+{
+	template <class T>
+	struct Blocking
+	{
+		static const size_t MR = 4;
+		static const size_t NR = 4;
+		static const size_t KC = 256;
+		static const size_t MC = 64;
+		static const size_t NC = 1024;
+	};
+
+	template <>
+	struct Blocking<float>
+	{
+		static const size_t MR = 6;
+		static const size_t NR = 16;
+		static const size_t KC = 256;
+		static const size_t MC = 96;
+		static const size_t NC = 2048;
+	};
+
+	template <>
+	struct Blocking<double>
+	{
+		static const size_t MR = 6;
+		static const size_t NR = 8;
+		static const size_t KC = 256;
+		static const size_t MC = 96;
+		static const size_t NC = 1024;
+	};
+
+	/**
+	 * c[MR x NR] (row stride ldc) += sum over p < kc of a[p][.] (x) b[p][.],
+	 * a packed as kc columns of MR, b as kc rows of NR.
+	 */
+	template <class T>
+	struct MicroKernel
+	{
+		typedef void (*Fn)(size_t kc, const T *a, const T *b, T *c, size_t ldc);
+	};
+
+	template <class T>
+	void microKernelScalar(size_t kc, const T *a, const T *b, T *c, size_t ldc) {
+		const size_t MR = Blocking<T>::MR;
+		const size_t NR = Blocking<T>::NR;
+		T acc[MR][NR];
+		for (size_t i = 0; i < MR; ++i)
+			for (size_t j = 0; j < NR; ++j)
+				acc[i][j] = static_cast<T>(0.0);
+		for (size_t p = 0; p < kc; ++p, a += MR, b += NR)
+			for (size_t i = 0; i < MR; ++i)
+				for (size_t j = 0; j < NR; ++j)
+					acc[i][j] += a[i] * b[j];
+		for (size_t i = 0; i < MR; ++i)
+			for (size_t j = 0; j < NR; ++j)
+				c[i * ldc + j] += acc[i][j];
+	}
+
+#if RT_SIMD_X86
+
+	__attribute__((target("avx")))
+	inline void microKernelAvx(size_t kc, const float *a, const float *b, float *c, size_t ldc) {
+		__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+		__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+		__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+		__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+		__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+		for (size_t p = 0; p < kc; ++p, a += 6, b += 16) {
+			__m256 b0 = _mm256_loadu_ps(b);
+			__m256 b1 = _mm256_loadu_ps(b + 8);
+			__m256 ai;
+			ai = _mm256_broadcast_ss(a + 0);
+			c00 = _mm256_add_ps(c00, _mm256_mul_ps(ai, b0));
+			c01 = _mm256_add_ps(c01, _mm256_mul_ps(ai, b1));
+			ai = _mm256_broadcast_ss(a + 1);
+			c10 = _mm256_add_ps(c10, _mm256_mul_ps(ai, b0));
+			c11 = _mm256_add_ps(c11, _mm256_mul_ps(ai, b1));
+			ai = _mm256_broadcast_ss(a + 2);
+			c20 = _mm256_add_ps(c20, _mm256_mul_ps(ai, b0));
+			c21 = _mm256_add_ps(c21, _mm256_mul_ps(ai, b1));
+			ai = _mm256_broadcast_ss(a + 3);
+			c30 = _mm256_add_ps(c30, _mm256_mul_ps(ai, b0));
+			c31 = _mm256_add_ps(c31, _mm256_mul_ps(ai, b1));
+			ai = _mm256_broadcast_ss(a + 4);
+			c40 = _mm256_add_ps(c40, _mm256_mul_ps(ai, b0));
+			c41 = _mm256_add_ps(c41, _mm256_mul_ps(ai, b1));
+			ai = _mm256_broadcast_ss(a + 5);
+			c50 = _mm256_add_ps(c50, _mm256_mul_ps(ai, b0));
+			c51 = _mm256_add_ps(c51, _mm256_mul_ps(ai, b1));
+		}
+		__m256 acc[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+		for (size_t i = 0; i < 6; ++i) {
+			float *row = c + i * ldc;
+			_mm256_storeu_ps(row, _mm256_add_ps(_mm256_loadu_ps(row), acc[2 * i]));
+			_mm256_storeu_ps(row + 8, _mm256_add_ps(_mm256_loadu_ps(row + 8), acc[2 * i + 1]));
+		}
+	}
+
+	__attribute__((target("avx2,fma")))
+	inline void microKernelAvx2(size_t kc, const float *a, const float *b, float *c, size_t ldc) {
+		__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+		__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+		__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+		__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+		__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+		for (size_t p = 0; p < kc; ++p, a += 6, b += 16) {
+			__m256 b0 = _mm256_loadu_ps(b);
+			__m256 b1 = _mm256_loadu_ps(b + 8);
+			__m256 ai;
+			ai = _mm256_broadcast_ss(a + 0);
+			c00 = _mm256_fmadd_ps(ai, b0, c00);
+			c01 = _mm256_fmadd_ps(ai, b1, c01);
+			ai = _mm256_broadcast_ss(a + 1);
+			c10 = _mm256_fmadd_ps(ai, b0, c10);
+			c11 = _mm256_fmadd_ps(ai, b1, c11);
+			ai = _mm256_broadcast_ss(a + 2);
+			c20 = _mm256_fmadd_ps(ai, b0, c20);
+			c21 = _mm256_fmadd_ps(ai, b1, c21);
+			ai = _mm256_broadcast_ss(a + 3);
+			c30 = _mm256_fmadd_ps(ai, b0, c30);
+			c31 = _mm256_fmadd_ps(ai, b1, c31);
+			ai = _mm256_broadcast_ss(a + 4);
+			c40 = _mm256_fmadd_ps(ai, b0, c40);
+			c41 = _mm256_fmadd_ps(ai, b1, c41);
+			ai = _mm256_broadcast_ss(a + 5);
+			c50 = _mm256_fmadd_ps(ai, b0, c50);
+			c51 = _mm256_fmadd_ps(ai, b1, c51);
+		}
+		__m256 acc[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+		for (size_t i = 0; i < 6; ++i) {
+			float *row = c + i * ldc;
+			_mm256_storeu_ps(row, _mm256_add_ps(_mm256_loadu_ps(row), acc[2 * i]));
+			_mm256_storeu_ps(row + 8, _mm256_add_ps(_mm256_loadu_ps(row + 8), acc[2 * i + 1]));
+		}
+	}
+
+	__attribute__((target("avx")))
+	inline void microKernelAvx(size_t kc, const double *a, const double *b, double *c, size_t ldc) {
+		__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+		__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+		__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+		__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+		__m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+		__m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+		for (size_t p = 0; p < kc; ++p, a += 6, b += 8) {
+			__m256d b0 = _mm256_loadu_pd(b);
+			__m256d b1 = _mm256_loadu_pd(b + 4);
+			__m256d ai;
+			ai = _mm256_broadcast_sd(a + 0);
+			c00 = _mm256_add_pd(c00, _mm256_mul_pd(ai, b0));
+			c01 = _mm256_add_pd(c01, _mm256_mul_pd(ai, b1));
+			ai = _mm256_broadcast_sd(a + 1);
+			c10 = _mm256_add_pd(c10, _mm256_mul_pd(ai, b0));
+			c11 = _mm256_add_pd(c11, _mm256_mul_pd(ai, b1));
+			ai = _mm256_broadcast_sd(a + 2);
+			c20 = _mm256_add_pd(c20, _mm256_mul_pd(ai, b0));
+			c21 = _mm256_add_pd(c21, _mm256_mul_pd(ai, b1));
+			ai = _mm256_broadcast_sd(a + 3);
+			c30 = _mm256_add_pd(c30, _mm256_mul_pd(ai, b0));
+			c31 = _mm256_add_pd(c31, _mm256_mul_pd(ai, b1));
+			ai = _mm256_broadcast_sd(a + 4);
+			c40 = _mm256_add_pd(c40, _mm256_mul_pd(ai, b0));
+			c41 = _mm256_add_pd(c41, _mm256_mul_pd(ai, b1));
+			ai = _mm256_broadcast_sd(a + 5);
+			c50 = _mm256_add_pd(c50, _mm256_mul_pd(ai, b0));
+			c51 = _mm256_add_pd(c51, _mm256_mul_pd(ai, b1));
+		}
+		__m256d acc[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+		for (size_t i = 0; i < 6; ++i) {
+			double *row = c + i * ldc;
+			_mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), acc[2 * i]));
+			_mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), acc[2 * i + 1]));
+		}
+	}
+
+	__attribute__((target("avx2,fma")))
+	inline void microKernelAvx2(size_t kc, const double *a, const double *b, double *c, size_t ldc) {
+		__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+		__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+		__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+		__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+		__m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+		__m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+		for (size_t p = 0; p < kc; ++p, a += 6, b += 8) {
+			__m256d b0 = _mm256_loadu_pd(b);
+			__m256d b1 = _mm256_loadu_pd(b + 4);
+			__m256d ai;
+			ai = _mm256_broadcast_sd(a + 0);
+			c00 = _mm256_fmadd_pd(ai, b0, c00);
+			c01 = _mm256_fmadd_pd(ai, b1, c01);
+			ai = _mm256_broadcast_sd(a + 1);
+			c10 = _mm256_fmadd_pd(ai, b0, c10);
+			c11 = _mm256_fmadd_pd(ai, b1, c11);
+			ai = _mm256_broadcast_sd(a + 2);
+			c20 = _mm256_fmadd_pd(ai, b0, c20);
+			c21 = _mm256_fmadd_pd(ai, b1, c21);
+			ai = _mm256_broadcast_sd(a + 3);
+			c30 = _mm256_fmadd_pd(ai, b0, c30);
+			c31 = _mm256_fmadd_pd(ai, b1, c31);
+			ai = _mm256_broadcast_sd(a + 4);
+			c40 = _mm256_fmadd_pd(ai, b0, c40);
+			c41 = _mm256_fmadd_pd(ai, b1, c41);
+			ai = _mm256_broadcast_sd(a + 5);
+			c50 = _mm256_fmadd_pd(ai, b0, c50);
+			c51 = _mm256_fmadd_pd(ai, b1, c51);
+		}
+		__m256d acc[12] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+		for (size_t i = 0; i < 6; ++i) {
+			double *row = c + i * ldc;
+			_mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), acc[2 * i]));
+			_mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), acc[2 * i + 1]));
+		}
+	}
+
+#endif // RT_SIMD_X86
+
+	template <class T>
+	typename MicroKernel<T>::Fn microKernel(simd::Isa isa) {
+		(void)isa;
+		return (microKernelScalar<T>);
+	}
+
+	template <>
+	inline MicroKernel<float>::Fn microKernel<float>(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2)
+			return (microKernelAvx2);
+		if (isa == simd::ISA_AVX)
+			return (microKernelAvx);
+#endif
+		(void)isa;
+		return (microKernelScalar<float>);
+	}
+
+	template <>
+	inline MicroKernel<double>::Fn microKernel<double>(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2)
+			return (microKernelAvx2);
+		if (isa == simd::ISA_AVX)
+			return (microKernelAvx);
+#endif
+		(void)isa;
+		return (microKernelScalar<double>);
+	}
+
+	/**
+	 * @brief Packs alpha * A[0:mc][0:kc] into MR-row panels, zero-padding the
+	 * last one.
+	 */
+	template <class T>
+	void packA(size_t mc, size_t kc, T alpha, const T *a, size_t lda, T *packed) {
+		const size_t MR = Blocking<T>::MR;
+		for (size_t i0 = 0; i0 < mc; i0 += MR) {
+			size_t rows = mc - i0 < MR ? mc - i0 : MR;
+			for (size_t p = 0; p < kc; ++p) {
+				for (size_t r = 0; r < rows; ++r)
+					packed[r] = alpha * a[(i0 + r) * lda + p];
+				for (size_t r = rows; r < MR; ++r)
+					packed[r] = static_cast<T>(0.0);
+				packed += MR;
+			}
+		}
+	}
+
+	/**
+	 * @brief Packs B[0:kc][0:nc] into NR-column panels, zero-padding the last
+	 * one.
+	 */
+	template <class T>
+	void packB(size_t kc, size_t nc, const T *b, size_t ldb, T *packed) {
+		const size_t NR = Blocking<T>::NR;
+		for (size_t j0 = 0; j0 < nc; j0 += NR) {
+			size_t cols = nc - j0 < NR ? nc - j0 : NR;
+			for (size_t p = 0; p < kc; ++p) {
+				const T *row = b + p * ldb + j0;
+				for (size_t j = 0; j < cols; ++j)
+					packed[j] = row[j];
+				for (size_t j = cols; j < NR; ++j)
+					packed[j] = static_cast<T>(0.0);
+				packed += NR;
+			}
+		}
+	}
+
+	/**
+	 * @brief Single-threaded blocked C += alpha * A * B over all rows of C.
+	 */
+	template <class T>
+	void multiplyAddRange(typename MicroKernel<T>::Fn kernel, size_t m, size_t n, size_t k, T alpha,
+		const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc
+	) {
+		const size_t MR = Blocking<T>::MR;
+		const size_t NR = Blocking<T>::NR;
+		const size_t KC = Blocking<T>::KC;
+		const size_t MC = Blocking<T>::MC;
+		const size_t NC = Blocking<T>::NC;
+
+		// panels only as large as this product needs, not the full blocking
+		size_t mcMax = m < MC ? m : MC;
+		size_t kcMax = k < KC ? k : KC;
+		size_t ncMax = n < NC ? n : NC;
+		T *packedA = new T[(mcMax + MR - 1) / MR * MR * kcMax];
+		T *packedB = new T[kcMax * ((ncMax + NR - 1) / NR) * NR];
+		T tile[MR * NR];
+
+		for (size_t jc = 0; jc < n; jc += NC) {
+			size_t nc = n - jc < NC ? n - jc : NC;
+			for (size_t pc = 0; pc < k; pc += KC) {
+				size_t kc = k - pc < KC ? k - pc : KC;
+				packB(kc, nc, b + pc * ldb + jc, ldb, packedB);
+				for (size_t ic = 0; ic < m; ic += MC) {
+					size_t mc = m - ic < MC ? m - ic : MC;
+					packA(mc, kc, alpha, a + ic * lda + pc, lda, packedA);
+					for (size_t jr = 0; jr < nc; jr += NR) {
+						size_t nr = nc - jr < NR ? nc - jr : NR;
+						for (size_t ir = 0; ir < mc; ir += MR) {
+							size_t mr = mc - ir < MR ? mc - ir : MR;
+							T *out = c + (ic + ir) * ldc + jc + jr;
+							if (mr == MR && nr == NR) {
+								kernel(kc, packedA + ir * kc, packedB + jr * kc, out, ldc);
+								continue;
+							}
+							// edge tile: run the full kernel on a scratch tile
+							for (size_t i = 0; i < MR * NR; ++i)
+								tile[i] = static_cast<T>(0.0);
+							kernel(kc, packedA + ir * kc, packedB + jr * kc, tile, NR);
+							for (size_t i = 0; i < mr; ++i)
+								for (size_t j = 0; j < nr; ++j)
+									out[i * ldc + j] += tile[i * NR + j];
+						}
+					}
+				}
+			}
+		}
+		delete[] packedA;
+		delete[] packedB;
+	}
+
+	/**
+	 * @brief C += alpha * A * B. threads == 0 uses every hardware thread;
+	 * products under ~2M multiply-adds always run on the calling thread.
+	 */
+	template <class T>
+	void multiplyAdd(size_t m, size_t n, size_t k, T alpha,
+		const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc, unsigned threads = 0
+	) {
+		if (m == 0 || n == 0 || k == 0)
+			return ;
+		typename MicroKernel<T>::Fn kernel = microKernel<T>(simd::activeIsa());
+		if (m * n * k < (static_cast<size_t>(1) << 21))
+			threads = 1;
+		const size_t MR = Blocking<T>::MR;
+		parallelFor(m, threads, 4 * MR, MR, [=](size_t begin, size_t end) {
+			multiplyAddRange<T>(kernel, end - begin, n, k, alpha,
+				a + begin * lda, lda, b, ldb, c + begin * ldc, ldc);
+		});
+	}
+
+	/**
+	 * @brief C = A * B.
+	 */
+	template <class T>
+	void multiply(size_t m, size_t n, size_t k,
+		const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc, unsigned threads = 0
+	) {
+		for (size_t i = 0; i < m; ++i)
+			for (size_t j = 0; j < n; ++j)
+				c[i * ldc + j] = static_cast<T>(0.0);
+		multiplyAdd(m, n, k, static_cast<T>(1.0), a, lda, b, ldb, c, ldc, threads);
+	}
+} // namespace gemm
+} // namespace rt
+
+#endif // !RT_GEMM_HPP
@@ -0,0 +1,154 @@
+#ifndef RT_INVERSE_HPP
+#define RT_INVERSE_HPP
+
+#include <stdexcept>
+
+/**
+ * Closed-form inverses for small row-major matrices (element (i, j) at
+ * m[i * n + j]). Used by RTMatrix::inverse() and the Mat wrappers in
+ * rt_mat.hpp. All of them throw on a zero determinant, allow out to
+ * alias m and are usable in constant expressions.
+ */
+namespace rt
+{
+namespace inv
+{
+	template <class T>
+	constexpr T determinant3(const T *m) {
+		return m[0] * (m[4] * m[8] - m[5] * m[7])
+			- m[1] * (m[3] * m[8] - m[5] * m[6])
+			+ m[2] * (m[3] * m[7] - m[4] * m[6]);
+	}
+
+	/**
+	 * @brief Cofactor matrix of a 3x3, cof[i][j] = (-1)^(i+j) * minor(i, j).
+	 * inverse = transpose(cof) / det, inverse-transpose = cof / det.
+	 */
+	template <class T>
+	constexpr void cofactor3(const T *m, T *cof) {
+		T c[9];
+		c[0] = m[4] * m[8] - m[5] * m[7];
+		c[1] = m[5] * m[6] - m[3] * m[8];
+		c[2] = m[3] * m[7] - m[4] * m[6];
+		c[3] = m[2] * m[7] - m[1] * m[8];
+		c[4] = m[0] * m[8] - m[2] * m[6];
+		c[5] = m[1] * m[6] - m[0] * m[7];
+		c[6] = m[1] * m[5] - m[2] * m[4];
+		c[7] = m[2] * m[3] - m[0] * m[5];
+		c[8] = m[0] * m[4] - m[1] * m[3];
+		for (int i = 0; i < 9; ++i)
+			cof[i] = c[i];
+	}
+
+	template <class T>
+	constexpr void inverse3(const T *m, T *out) {
+		T c[9];
+		cofactor3(m, c);
+		T det = m[0] * c[0] + m[1] * c[1] + m[2] * c[2];
+		if (det == static_cast<T>(0.0))
+			throw std::runtime_error("Matrix is singular!");
+		T invDet = static_cast<T>(1.0) / det;
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+				out[i * 3 + j] = c[j * 3 + i] * invDet;
+	}
+
+	/**
+	 * @brief General 4x4 inverse by Laplace expansion over 2x2 sub-determinants
+	 * of the top two and bottom two rows.
+	 */
+	template <class T>
+	constexpr void inverse4(const T *m, T *out) {
+		T a00 = m[0], a01 = m[1], a02 = m[2], a03 = m[3];
+		T a10 = m[4], a11 = m[5], a12 = m[6], a13 = m[7];
+		T a20 = m[8], a21 = m[9], a22 = m[10], a23 = m[11];
+		T a30 = m[12], a31 = m[13], a32 = m[14], a33 = m[15];
+
+		T s0 = a00 * a11 - a10 * a01;
+		T s1 = a00 * a12 - a10 * a02;
+		T s2 = a00 * a13 - a10 * a03;
+		T s3 = a01 * a12 - a11 * a02;
+		T s4 = a01 * a13 - a11 * a03;
+		T s5 = a02 * a13 - a12 * a03;
+
+		T c5 = a22 * a33 - a32 * a23;
+		T c4 = a21 * a33 - a31 * a23;
+		T c3 = a21 * a32 - a31 * a22;
+		T c2 = a20 * a33 - a30 * a23;
+		T c1 = a20 * a32 - a30 * a22;
+		T c0 = a20 * a31 - a30 * a21;
+
+		T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		if (det == static_cast<T>(0.0))
+			throw std::runtime_error("Matrix is singular!");
+		T invDet = static_cast<T>(1.0) / det;
+
+		out[0] = (a11 * c5 - a12 * c4 + a13 * c3) * invDet;
+		out[1] = (-a01 * c5 + a02 * c4 - a03 * c3) * invDet;
+		out[2] = (a31 * s5 - a32 * s4 + a33 * s3) * invDet;
+		out[3] = (-a21 * s5 + a22 * s4 - a23 * s3) * invDet;
+
+		out[4] = (-a10 * c5 + a12 * c2 - a13 * c1) * invDet;
+		out[5] = (a00 * c5 - a02 * c2 + a03 * c1) * invDet;
+		out[6] = (-a30 * s5 + a32 * s2 - a33 * s1) * invDet;
+		out[7] = (a20 * s5 - a22 * s2 + a23 * s1) * invDet;
+
+		out[8] = (a10 * c4 - a11 * c2 + a13 * c0) * invDet;
+		out[9] = (-a00 * c4 + a01 * c2 - a03 * c0) * invDet;
+		out[10] = (a30 * s4 - a31 * s2 + a33 * s0) * invDet;
+		out[11] = (-a20 * s4 + a21 * s2 - a23 * s0) * invDet;
+
+		out[12] = (-a10 * c3 + a11 * c1 - a12 * c0) * invDet;
+		out[13] = (a00 * c3 - a01 * c1 + a02 * c0) * invDet;
+		out[14] = (-a30 * s3 + a31 * s1 - a32 * s0) * invDet;
+		out[15] = (a20 * s3 - a21 * s1 + a22 * s0) * invDet;
+	}
+
+	/**
+	 * @brief Inverse of an affine 4x4 [A t; 0 0 0 1]: [A^-1, -A^-1 t; 0 0 0 1].
+	 * The bottom row of m is not read.
+	 */
+	template <class T>
+	constexpr void affineInverse4(const T *m, T *out) {
+		T a[9] = {
+			m[0], m[1], m[2],
+			m[4], m[5], m[6],
+			m[8], m[9], m[10]
+		};
+		T t[3] = { m[3], m[7], m[11] };
+		inverse3(a, a);
+		for (int i = 0; i < 3; ++i) {
+			out[i * 4 + 0] = a[i * 3 + 0];
+			out[i * 4 + 1] = a[i * 3 + 1];
+			out[i * 4 + 2] = a[i * 3 + 2];
+			out[i * 4 + 3] = -(a[i * 3 + 0] * t[0] + a[i * 3 + 1] * t[1] + a[i * 3 + 2] * t[2]);
+		}
+		out[12] = static_cast<T>(0.0);
+		out[13] = static_cast<T>(0.0);
+		out[14] = static_cast<T>(0.0);
+		out[15] = static_cast<T>(1.0);
+	}
+
+	/**
+	 * @brief Normal matrix: inverse-transpose of the upper-left 3x3 of a 4x4.
+	 */
+	template <class T>
+	constexpr void normalMatrix4(const T *m, T *out) {
+		T a[9] = {
+			m[0], m[1], m[2],
+			m[4], m[5], m[6],
+			m[8], m[9], m[10]
+		};
+		T c[9];
+		cofactor3(a, c);
+		T det = a[0] * c[0] + a[1] * c[1] + a[2] * c[2];
+		if (det == static_cast<T>(0.0))
+			throw std::runtime_error("Matrix is singular!");
+		T invDet = static_cast<T>(1.0) / det;
+		for (int i = 0; i < 9; ++i)
+			out[i] = c[i] * invDet;
+	}
+} // namespace inv
+} // namespace rt
+
+#endif // !RT_INVERSE_HPP
@@ -0,0 +1,149 @@
+#ifndef RT_LINALG_HPP
+#define RT_LINALG_HPP
+
+#include <stdexcept>
+#include "Vector.hpp"
+#include "rt_vector.hpp"
+#include "rt_matrix.hpp"
+#include "rt_gemm.hpp"
+#include "rt_solve.hpp"
+
+/**
+ * RTMatrix front end for large problems, e.g. fitting a transform to
+ * thousands of point pairs. Unlike RTMatrix::operator*, multiply() is the
+ * ordinary product of any compatible shapes. Factor once with LU or
+ * Cholesky and call solve() per right-hand side instead of inverting.
+ */
+namespace rt
+{
+	/**
+	 * @brief a * b, (a * b)[i][j] = sum over k of a[i][k] * b[k][j].
+	 */
+	template <class T>
+	RTMatrix<T> multiply(const RTMatrix<T>& a, const RTMatrix<T>& b, unsigned threads = 0) {
+		if (a.getCols() != b.getRows())
+			throw std::runtime_error("Matrixies are not the same size!");
+		RTMatrix<T> result(a.getRows(), b.getCols());
+		gemm::multiplyAdd(a.getRows(), b.getCols(), a.getCols(), static_cast<T>(1.0),
+			a.getData(), a.getCols(), b.getData(), b.getCols(), result.getData(), result.getCols(), threads);
+		return result;
+	}
+
+	template <class T>
+	RTMatrix<T> transposed(const RTMatrix<T>& a) {
+		RTMatrix<T> result(a.getCols(), a.getRows());
+		for (size_t i = 0; i < a.getRows(); ++i)
+			for (size_t j = 0; j < a.getCols(); ++j)
+				result[j][i] = a[i][j];
+		return result;
+	}
+
+	/**
+	 * @brief P * A = L * U of a square matrix.
+	 */
+	template <class T>
+	class LU
+	{
+	private:
+		RTMatrix<T>			lu;
+		ft::Vector<size_t>	pivots;
+
+	public:
+		explicit LU(const RTMatrix<T>& a, unsigned threads = 0) : lu(a), pivots(a.getRows()) {
+			if (a.getRows() != a.getCols())
+				throw std::runtime_error("LU needs a square matrix!");
+			solve::luDecompose(this->lu.getData(), a.getRows(), a.getCols(), &this->pivots[0], threads);
+		};
+
+		RTMatrix<T> solve(const RTMatrix<T>& b) const {
+			if (b.getRows() != this->lu.getRows())
+				throw std::runtime_error("Dimensions isn't equal!");
+			RTMatrix<T> x(b);
+			solve::luSolve(this->lu.getData(), this->lu.getRows(), this->lu.getCols(), &this->pivots[0],
+				x.getData(), x.getCols(), x.getCols());
+			return x;
+		};
+		RTVector<T> solve(const RTVector<T>& b) const {
+			if (b.getDims() != this->lu.getRows())
+				throw std::runtime_error("Dimensions isn't equal!");
+			RTVector<T> x(b);
+			solve::luSolve(this->lu.getData(), this->lu.getRows(), this->lu.getCols(), &this->pivots[0],
+				x.getData(), 1, 1);
+			return x;
+		};
+
+		T determinant() const {
+			T det = static_cast<T>(1.0);
+			for (size_t i = 0; i < this->lu.getRows(); ++i) {
+				det *= this->lu[i][i];
+				if (this->pivots[i] != i)
+					det = -det;
+			}
+			return det;
+		};
+	};
+
+	/**
+	 * @brief A = L * L^T of a symmetric positive definite matrix (only the
+	 * lower triangle of A is read).
+	 */
+	template <class T>
+	class Cholesky
+	{
+	private:
+		RTMatrix<T>	l;
+
+	public:
+		explicit Cholesky(const RTMatrix<T>& a, unsigned threads = 0) : l(a) {
+			if (a.getRows() != a.getCols())
+				throw std::runtime_error("Cholesky needs a square matrix!");
+			solve::choleskyDecompose(this->l.getData(), a.getRows(), a.getCols(), threads);
+		};
+
+		const RTMatrix<T>& getL() const {
+			return this->l;
+		};
+
+		RTMatrix<T> solve(const RTMatrix<T>& b) const {
+			if (b.getRows() != this->l.getRows())
+				throw std::runtime_error("Dimensions isn't equal!");
+			RTMatrix<T> x(b);
+			solve::choleskySolve(this->l.getData(), this->l.getRows(), this->l.getCols(),
+				x.getData(), x.getCols(), x.getCols());
+			return x;
+		};
+		RTVector<T> solve(const RTVector<T>& b) const {
+			if (b.getDims() != this->l.getRows())
+				throw std::runtime_error("Dimensions isn't equal!");
+			RTVector<T> x(b);
+			solve::choleskySolve(this->l.getData(), this->l.getRows(), this->l.getCols(),
+				x.getData(), 1, 1);
+			return x;
+		};
+	};
+
+	/**
+	 * @brief x minimizing |a * x - b| for a tall a (rows >= cols) of full
+	 * column rank, through the normal equations a^T a x = a^T b. The
+	 * condition number is squared, use double for poorly scaled data.
+	 */
+	template <class T>
+	RTMatrix<T> leastSquares(const RTMatrix<T>& a, const RTMatrix<T>& b, unsigned threads = 0) {
+		if (a.getRows() != b.getRows())
+			throw std::runtime_error("Dimensions isn't equal!");
+		RTMatrix<T> at = transposed(a);
+		Cholesky<T> normal(multiply(at, a, threads), threads);
+		return normal.solve(multiply(at, b, threads));
+	}
+
+	template <class T>
+	RTVector<T> leastSquares(const RTMatrix<T>& a, const RTVector<T>& b, unsigned threads = 0) {
+		RTMatrix<T> x = leastSquares(a, RTMatrix<T>(b.getDims(), 1, b.getData()), threads);
+		T *data = new T[x.getRows()];
+		for (size_t i = 0; i < x.getRows(); ++i)
+			data[i] = x[i][0];
+		return RTVector<T>(data, x.getRows());
+	}
+} // namespace rt
+
+#endif // !RT_LINALG_HPP
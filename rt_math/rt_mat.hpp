@@ -0,0 +1,222 @@
+#ifndef RT_MAT_HPP
+#define RT_MAT_HPP
+
+#include <stdexcept>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include "rt_vec.hpp"
+#include "rt_matrix.hpp"
+#include "rt_simd.hpp"
+#include "rt_inverse.hpp"
+
+namespace rt
+{
+	/**
+	 * Fixed-size row-major matrix with inline storage. Element (i, j) is
+	 * m[i][j], as in RTMatrix, so getData() can be passed to
+	 * glUniformMatrix4fv with transpose = GL_TRUE.
+	 *
+	 * Unlike RTMatrix, operator* is the ordinary product: (a * b)[i][j] is
+	 * the sum over k of a[i][k] * b[k][j]. Mat4f products go through the
+	 * runtime-dispatched kernels in rt_simd.hpp, except in constant
+	 * evaluation, where the scalar loop is used.
+	 */
+	template <class T, size_t R, size_t C>
+	class Mat
+	{
+		static_assert(R > 0 && C > 0, "Mat dimensions must be positive");
+
+	private:
+		T data[R * C];
+
+	public:
+		constexpr Mat() {
+			for (size_t i = 0; i < R * C; ++i)
+				this->data[i] = static_cast<T>(0.0);
+		};
+		constexpr explicit Mat(const T *data) {
+			for (size_t i = 0; i < R * C; ++i)
+				this->data[i] = data[i];
+		};
+		/**
+		 * @brief Element type conversion, e.g. a double model-view to float.
+		 */
+		template <class U>
+		constexpr explicit Mat(const Mat<U, R, C>& rhs) {
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					this->data[i * C + j] = static_cast<T>(rhs[i][j]);
+		};
+		explicit Mat(const RTMatrix<T>& rhs) {
+			if (rhs.getRows() != R || rhs.getCols() != C)
+				throw std::runtime_error("Matrixies are not the same size!");
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					(*this)[i][j] = rhs[i][j];
+		};
+
+		RTMatrix<T> toRTMatrix() const {
+			return (RTMatrix<T>(R, C, this->data));
+		};
+
+		static constexpr Mat<T, R, C> identity() {
+			Mat<T, R, C> result;
+			result.toIdentity();
+			return (result);
+		};
+
+		constexpr void toIdentity() {
+			static_assert(R == C, "Identity matrix must be square!");
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					(*this)[i][j] = (i == j) ? static_cast<T>(1.0) : static_cast<T>(0.0);
+		};
+
+		constexpr Mat<T, C, R> transposed() const {
+			Mat<T, C, R> result;
+			for (size_t i = 0; i < R; ++i)
+				for (size_t j = 0; j < C; ++j)
+					result[j][i] = (*this)[i][j];
+			return (result);
+		};
+
+		constexpr T* getData() {
+			return this->data;
+		};
+		constexpr const T* getData() const {
+			return this->data;
+		};
+
+		static constexpr size_t getRows() {return R;};
+		static constexpr size_t getCols() {return C;};
+
+		constexpr T* operator[](size_t i) {
+			return (this->data + i * C);
+		};
+		constexpr const T* operator[](size_t i) const {
+			return (this->data + i * C);
+		};
+
+		constexpr Mat<T, R, C> operator+ (const Mat<T, R, C>& rhs) const {
+			Mat<T, R, C> result;
+			for (size_t i = 0; i < R * C; ++i)
+				result.data[i] = this->data[i] + rhs.data[i];
+			return (result);
+		};
+		constexpr Mat<T, R, C> operator- (const Mat<T, R, C>& rhs) const {
+			Mat<T, R, C> result;
+			for (size_t i = 0; i < R * C; ++i)
+				result.data[i] = this->data[i] - rhs.data[i];
+			return (result);
+		};
+		constexpr Mat<T, R, C> operator* (const T& rhs) const {
+			Mat<T, R, C> result;
+			for (size_t i = 0; i < R * C; ++i)
+				result.data[i] = this->data[i] * rhs;
+			return (result);
+		};
+
+		template <size_t K>
+		constexpr Mat<T, R, K> operator* (const Mat<T, C, K>& rhs) const {
+			Mat<T, R, K> result;
+			if constexpr (std::is_same<T, float>::value && R == 4 && C == 4 && K == 4) {
+				if (!std::is_constant_evaluated()) {
+					simd::mat4Mul(this->data, rhs.getData(), result.getData());
+					return (result);
+				}
+			}
+			for (size_t i = 0; i < R; ++i) {
+				for (size_t k = 0; k < C; ++k) {
+					T a = (*this)[i][k];
+					for (size_t j = 0; j < K; ++j)
+						result[i][j] += a * rhs[k][j];
+				}
+			}
+			return (result);
+		};
+
+		constexpr Vec<T, R> operator* (const Vec<T, C>& rhs) const {
+			Vec<T, R> result;
+			if constexpr (std::is_same<T, float>::value && R == 4 && C == 4) {
+				if (!std::is_constant_evaluated()) {
+					simd::mat4MulVec4(this->data, rhs.getData(), result.getData());
+					return (result);
+				}
+			}
+			for (size_t i = 0; i < R; ++i) {
+				T sum = static_cast<T>(0.0);
+				for (size_t j = 0; j < C; ++j)
+					sum += (*this)[i][j] * rhs[j];
+				result[i] = sum;
+			}
+			return (result);
+		};
+
+		constexpr bool operator== (const Mat<T, R, C>& rhs) const {
+			for (size_t i = 0; i < R * C; ++i)
+				if (this->data[i] != rhs.data[i])
+					return (false);
+			return (true);
+		};
+		constexpr bool operator!= (const Mat<T, R, C>& rhs) const {
+			return !(*this == rhs);
+		};
+	};
+
+	template <class T, size_t R, size_t C>
+	constexpr Mat<T, R, C> operator* (const T& lhs, const Mat<T, R, C>& rhs) {
+		return (rhs * lhs);
+	};
+
+	template <class T>
+	constexpr Mat<T, 3, 3> inverse(const Mat<T, 3, 3>& m) {
+		Mat<T, 3, 3> result;
+		inv::inverse3(m.getData(), result.getData());
+		return (result);
+	};
+
+	template <class T>
+	constexpr Mat<T, 4, 4> inverse(const Mat<T, 4, 4>& m) {
+		Mat<T, 4, 4> result;
+		inv::inverse4(m.getData(), result.getData());
+		return (result);
+	};
+
+	/**
+	 * @brief Inverse of a matrix whose bottom row is (0, 0, 0, 1), e.g. any
+	 * combination of translate, rotate and scale.
+	 */
+	template <class T>
+	constexpr Mat<T, 4, 4> affineInverse(const Mat<T, 4, 4>& m) {
+		Mat<T, 4, 4> result;
+		inv::affineInverse4(m.getData(), result.getData());
+		return (result);
+	};
+
+	template <class T>
+	constexpr Mat<T, 3, 3> normalMatrix(const Mat<T, 4, 4>& m) {
+		Mat<T, 3, 3> result;
+		inv::normalMatrix4(m.getData(), result.getData());
+		return (result);
+	};
+
+	template <class T, size_t R, size_t C>
+	std::ostream& operator<<(std::ostream& os, const Mat<T, R, C>& matrix) {
+		for (size_t i = 0; i < R; i++) {
+			os << "[ ";
+			for (size_t j = 0; j < C; j++) {
+				os << matrix[i][j] << " ";
+			}
+			os << "]\n";
+		}
+		return os;
+	}
+
+	typedef Mat<float, 3, 3>	Mat3f;
+	typedef Mat<float, 4, 4>	Mat4f;
+	typedef Mat<double, 3, 3>	Mat3d;
+	typedef Mat<double, 4, 4>	Mat4d;
+} // namespace rt
+
+#endif // !RT_MAT_HPP
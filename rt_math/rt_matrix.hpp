@@ -2,7 +2,12 @@
 #define RT_MATRIX_HPP
 
 #include <stdexcept>
+#include <type_traits>
 #include "rt_vector.hpp"
+#include "rt_simd.hpp"
+#include "rt_inverse.hpp"
+#include "rt_gemm.hpp"
+#include "rt_solve.hpp"
 
 namespace rt
 {
@@ -56,21 +61,55 @@ namespace rt
 			for (size_t i = 0; i < n; ++i)
 				this->data[i] = rhs.data[i];
 		};
-		RTMatrix& operator=(const RTMatrix<T>& rhs) {
-			if (*this == rhs)
-				return (*this);
+		RTMatrix(RTMatrix<T>&& rhs) noexcept {
 			this->rows = rhs.rows;
 			this->cols = rhs.cols;
 			this->n = rhs.n;
-			this->data = new T[n];
-			for (size_t i = 0; i < n; ++i)
-				this->data[i] = rhs.data[i];
+			this->data = rhs.data;
+			rhs.rows = 0;
+			rhs.cols = 0;
+			rhs.n = 0;
+			rhs.data = NULL;
+		};
+		RTMatrix& operator=(const RTMatrix<T>& rhs) {
+			if (this == &rhs)
+				return (*this);
+			// same size: reuse the buffer, otherwise copy-and-swap
+			if (this->rows == rhs.rows && this->cols == rhs.cols && this->data != NULL) {
+				for (size_t i = 0; i < n; ++i)
+					this->data[i] = rhs.data[i];
+				return (*this);
+			}
+			RTMatrix<T> copy(rhs);
+			swap(copy);
 			return (*this);
 		};
+		RTMatrix& operator=(RTMatrix<T>&& rhs) noexcept {
+			swap(rhs);
+			return (*this);
+		};
+
+		void swap(RTMatrix<T>& rhs) noexcept {
+			T *tempData = this->data;
+			size_t tempN = this->n;
+			size_t tempRows = this->rows;
+			size_t tempCols = this->cols;
+			this->data = rhs.data;
+			this->n = rhs.n;
+			this->rows = rhs.rows;
+			this->cols = rhs.cols;
+			rhs.data = tempData;
+			rhs.n = tempN;
+			rhs.rows = tempRows;
+			rhs.cols = tempCols;
+		};
 
 		T* getData() {
 			return this->data;
 		}
+		const T* getData() const {
+			return this->data;
+		}
 
 		void toIdentity() {
 			if (this->rows != this->cols)
@@ -87,39 +126,30 @@ namespace rt
 			if (this->rows != this->cols)
 				throw std::runtime_error("Can't invese not square matrix!");
 
-			RTMatrix<T> identity = RTMatrix<T>(this->rows, this->cols);
-			identity.toIdentity();
-			join(identity);
-
-			// Двигаемся по диагонали (прямой ход)
-			for (size_t diag = 0; diag < this->rows; ++diag)
-			{
-				// Переставляет на первую строку подматрицы самое большое число
-				size_t max = findRowWithMaxElement(diag, diag);
-				if (max != diag)
-					swapRow(diag, max);
-				if ((*this)[diag][diag] == static_cast<T>(0.0))
-					throw std::runtime_error("Matrix is singular!");
-				// Приводим диагональный элемент к 1
-				if ((*this)[diag][diag] != 0)
-					multRow(diag, static_cast<T>(1.0)/(*this)[diag][diag]);
-				// Обрабатываем все строки ниже диагональной
-				for (size_t i = diag + 1; i < this->rows; ++i)
-					multAdd(i, diag, (*this)[i][diag] > 0 ? -(*this)[i][diag] : (*this)[i][diag]);
+			if (this->rows == 3) {
+				inv::inverse3(this->data, this->data);
+				return ;
 			}
-			// Обратный ход
-			for (size_t diag = this->rows - 1; diag > 0; --diag)
-			{
-				for (size_t i = diag - 1; i > 0; --i)
-				{
-					if ((*this)[i][diag] != 0)
-						multAdd(i, diag, (*this)[i][diag] > 0 ? -(*this)[i][diag] : (*this)[i][diag]);
-				}
-				if ((*this)[0][diag] != 0)
-					multAdd(0, diag, (*this)[0][diag] > 0 ? -(*this)[0][diag] : (*this)[0][diag]);
+			if (this->rows == 4) {
+				inv::inverse4(this->data, this->data);
+				return ;
 			}
 
-			*this = separate(this->cols / 2);
+			// larger sizes: LU with partial pivoting, then solve A * X = I
+			RTMatrix<T> lu(*this);
+			RTMatrix<T> result(this->rows, this->cols);
+			result.toIdentity();
+			size_t *pivots = new size_t[this->rows];
+			try {
+				solve::luDecompose(lu.data, lu.rows, lu.cols, pivots);
+			}
+			catch (...) {
+				delete[] pivots;
+				throw;
+			}
+			solve::luSolve(lu.data, lu.rows, lu.cols, pivots, result.data, result.cols, result.cols);
+			delete[] pivots;
+			swap(result);
 		}
 
 		T* operator[](size_t i) {
@@ -128,8 +158,8 @@ namespace rt
 		T* operator[](size_t i) const {
 			return (this->data + i * this->cols);
 		};
-		size_t getRows() {return this->rows;};
-		size_t getCols() {return this->cols;};
+		size_t getRows() const {return this->rows;};
+		size_t getCols() const {return this->cols;};
 
 		bool operator== (const RTMatrix<T>& rhs) {
 			return (compare(rhs, static_cast<T>(1e-9)));
@@ -156,7 +186,7 @@ namespace rt
 						m1[i][j] = (*this)[i][j];
 					else
 						m2[i][j - col_index] = (*this)[i][j];
-			*this = m1;
+			swap(m1);
 			return (m2);
 		};
 
@@ -187,58 +217,6 @@ namespace rt
 		template <class U>
 		friend std::ostream& operator<<(std::ostream& os, const RTMatrix<U>& dt);
 
-	private:
-		void swapRow(size_t i_1, size_t i_2) {
-			T *temp = new T[this->cols];
-			for (size_t k = 0; k < this->cols; ++k)
-				temp[k] = (*this)[i_1][k];
-			for (size_t k = 0; k < this->cols; ++k)
-				(*this)[i_1][k] = (*this)[i_2][k];
-			for (size_t k = 0; k < this->cols; ++k)
-				(*this)[i_2][k] = temp[k];
-			delete[] temp;
-		};
-		void multAdd(size_t i, size_t j, T multiplier) {
-			for (size_t k = 0; k < this->cols; ++k)
-				(*this)[i][k] += (*this)[j][k] * multiplier;
-		};
-		void multRow(size_t i, T multiplier) {
-			for (size_t k = 0; k < this->cols; ++k)
-				(*this)[i][k] *= multiplier;
-		};
-		void join(const RTMatrix<T>& rhs) {
-			if (this->rows != rhs.rows)
-				throw std::runtime_error("Join failed due to rows are not equal!");
-			size_t new_cols = this->cols + rhs.cols;
-			T *new_data = new T[this->rows * (new_cols)];
-			for (size_t i = 0; i < rows; ++i) {
-				size_t k = 0;
-				for (size_t j = 0; j < new_cols; ++j)
-				{
-					if (j < cols)
-						new_data[i * new_cols + j] = (*this)[i][j];
-					else {
-						new_data[i * new_cols + j] = rhs[i][k];
-						++k;
-					}
-				}
-			}
-			this->cols = new_cols;
-			this->n = this->cols * this->rows;
-			delete[] this->data;
-			this->data = new_data;
-		};
-		int findRowWithMaxElement(int col, size_t startingRow) {
-			T max = (*this)[startingRow][col];
-			size_t index = startingRow;
-			for (size_t i = startingRow + 1; i < this->rows; ++i)
-				if (fabs((*this)[i][col]) > fabs(max))
-				{
-					index = i;
-					max = (*this)[i][col];
-				}
-			return index;
-		};
 	};
 
 	template <class U>
@@ -307,23 +285,38 @@ namespace rt
 		return RTMatrix<U>(rows, cols, n, data);
 	};
 
+	/**
+	 * @brief rhs * lhs, in that order for every shape: rhs.cols must equal
+	 * lhs.rows and the result is rhs.rows x lhs.cols. rt::multiply is the
+	 * product in the usual order.
+	 */
 	template <class U>
 	RTMatrix<U> operator* (const RTMatrix<U>& lhs, const RTMatrix<U>& rhs) {
-		if (lhs.cols != rhs.rows)
+		if (rhs.cols != lhs.rows)
 			throw std::runtime_error("Matrixies are not the same size!");
-		size_t rows = lhs.rows;
-		size_t cols = lhs.cols;
-		size_t n = lhs.n;
-		//U *data = new U[n];
-		rt::RTMatrix<U> result(lhs.rows, rhs.cols);
-		for (size_t j = 0; j < lhs.rows; ++j) {
-			for (size_t i = 0; i < rhs.cols; ++i) {
-				result[i][j] = 0;
-				for (size_t k = 0; k < lhs.rows; ++k) {
-					result[i][j] += lhs[k][j] * rhs[i][k];
+		rt::RTMatrix<U> result(rhs.rows, lhs.cols);
+		if constexpr (std::is_same<U, float>::value) {
+			if (lhs.rows == 4 && lhs.cols == 4 && rhs.rows == 4) {
+				simd::mat4Mul(rhs.data, lhs.data, result.data);
+				return result;
+			}
+		}
+		// below 32 on every side packing costs more than it saves
+		if (rhs.rows < 32 && rhs.cols < 32 && lhs.cols < 32) {
+			for (size_t i = 0; i < rhs.rows; ++i) {
+				U *out = result.data + i * result.cols;
+				for (size_t k = 0; k < rhs.cols; ++k) {
+					U r = rhs.data[i * rhs.cols + k];
+					const U *row = lhs.data + k * lhs.cols;
+					for (size_t j = 0; j < lhs.cols; ++j)
+						out[j] += r * row[j];
 				}
 			}
+			return result;
 		}
+		// result is zeroed, gemm adds into it
+		gemm::multiplyAdd(rhs.rows, lhs.cols, rhs.cols, static_cast<U>(1.0),
+			rhs.data, rhs.cols, lhs.data, lhs.cols, result.data, result.cols);
 		return result;
 	};
 	template <class U>
@@ -373,6 +366,11 @@ namespace rt
 		return rt::RTVector<U>(result, lhs.rows);
 	};
 
+	template <class T>
+	void swap(RTMatrix<T>& x, RTMatrix<T>& y) noexcept {
+		x.swap(y);
+	}
+
 	template <class U>
 	std::ostream& operator<<(std::ostream& os, const RTMatrix<U>& matrix) {
 		for (size_t i = 0; i < matrix.rows; i++) {
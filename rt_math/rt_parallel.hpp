@@ -0,0 +1,51 @@
+#ifndef RT_PARALLEL_HPP
+#define RT_PARALLEL_HPP
+
+#include <cstddef>
+#include <thread>
+
+namespace rt
+{
+	/**
+	 * @brief Runs job(begin, end) over [0, count) on up to threads threads,
+	 * threads == 0 uses std::thread::hardware_concurrency(). At most
+	 * count / minChunk threads are used and every chunk boundary is a
+	 * multiple of align. The calling thread takes the last chunk; if its
+	 * share throws, the workers are joined before the exception propagates.
+	 */
+	template <class Job>
+	void parallelFor(size_t count, unsigned threads, size_t minChunk, size_t align, Job job) {
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency();
+		if (minChunk == 0)
+			minChunk = 1;
+		if (threads > count / minChunk)
+			threads = count / minChunk;
+		if (threads <= 1) {
+			job(static_cast<size_t>(0), count);
+			return ;
+		}
+		if (align == 0)
+			align = 1;
+		size_t chunk = (count / threads + align - 1) / align * align;
+		std::thread *workers = new std::thread[threads - 1];
+		size_t begin = 0;
+		unsigned started = 0;
+		for (; started + 1 < threads && begin + chunk < count; ++started, begin += chunk)
+			workers[started] = std::thread(job, begin, begin + chunk);
+		try {
+			job(begin, count);
+		} catch (...) {
+			// joinable threads terminate on destruction, wait for them first
+			for (unsigned t = 0; t < started; ++t)
+				workers[t].join();
+			delete[] workers;
+			throw;
+		}
+		for (unsigned t = 0; t < started; ++t)
+			workers[t].join();
+		delete[] workers;
+	}
+} // namespace rt
+
+#endif // !RT_PARALLEL_HPP
@@ -0,0 +1,193 @@
+#ifndef RT_QUATERNION_HPP
+#define RT_QUATERNION_HPP
+
+#include <stdexcept>
+#include <cmath>
+#include <ostream>
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+
+namespace rt
+{
+	/**
+	 * Rotation quaternion w + xi + yj + zk. Composition follows the matrix
+	 * convention: (a * b) rotates by b first, then by a, and
+	 * (a * b).toMat4() == a.toMat4() * b.toMat4().
+	 */
+	template <class T>
+	class Quaternion
+	{
+	private:
+		T data[4];	// x y z w
+
+	public:
+		constexpr Quaternion() {
+			this->data[0] = static_cast<T>(0.0);
+			this->data[1] = static_cast<T>(0.0);
+			this->data[2] = static_cast<T>(0.0);
+			this->data[3] = static_cast<T>(1.0);
+		};
+		constexpr Quaternion(T w, T x, T y, T z) {
+			this->data[0] = x;
+			this->data[1] = y;
+			this->data[2] = z;
+			this->data[3] = w;
+		};
+
+		/**
+		 * @brief Rotation by rad around axis (normalized here).
+		 */
+		static Quaternion<T> fromAxisAngle(const Vec<T, 3>& axis, T rad) {
+			Vec<T, 3> n = axis.get_normalized();
+			T s = std::sin(rad / 2);
+			return Quaternion<T>(std::cos(rad / 2), n['x'] * s, n['y'] * s, n['z'] * s);
+		};
+
+		constexpr T& operator[] (char c) {
+			return (this->data[component(c)]);
+		};
+		constexpr const T& operator[] (char c) const {
+			return (this->data[component(c)]);
+		};
+
+		T norm() const {
+			return std::sqrt(dot(*this, *this));
+		};
+		void normalize() {
+			T norm = this->norm();
+			if (norm == static_cast<T>(0.0))
+				throw std::runtime_error("try to normalize zero quaternion!");
+			T inv = static_cast<T>(1.0) / norm;
+			for (size_t i = 0; i < 4; ++i)
+				this->data[i] *= inv;
+		};
+		Quaternion<T> get_normalized() const {
+			Quaternion<T> result(*this);
+			result.normalize();
+			return (result);
+		};
+		/**
+		 * @brief Inverse of a unit quaternion.
+		 */
+		constexpr Quaternion<T> conjugate() const {
+			return Quaternion<T>(this->data[3], -this->data[0], -this->data[1], -this->data[2]);
+		};
+
+		constexpr Quaternion<T> operator* (const Quaternion<T>& rhs) const {
+			T ax = this->data[0], ay = this->data[1], az = this->data[2], aw = this->data[3];
+			T bx = rhs.data[0], by = rhs.data[1], bz = rhs.data[2], bw = rhs.data[3];
+			return Quaternion<T>(
+				aw * bw - ax * bx - ay * by - az * bz,
+				aw * bx + ax * bw + ay * bz - az * by,
+				aw * by - ax * bz + ay * bw + az * bx,
+				aw * bz + ax * by - ay * bx + az * bw
+			);
+		};
+
+		/**
+		 * @brief Rotates v by this (unit) quaternion: v + 2w(u x v) + 2u x (u x v).
+		 */
+		constexpr Vec<T, 3> rotate(const Vec<T, 3>& v) const {
+			Vec<T, 3> u(this->data[0], this->data[1], this->data[2]);
+			Vec<T, 3> t = Vec<T, 3>::cross(u, v) * static_cast<T>(2.0);
+			return v + t * this->data[3] + Vec<T, 3>::cross(u, t);
+		};
+
+		/**
+		 * @brief Rotation matrix of a unit quaternion, row-major like Mat.
+		 */
+		constexpr Mat<T, 3, 3> toMat3() const {
+			T x = this->data[0], y = this->data[1], z = this->data[2], w = this->data[3];
+			T xx = x * x, yy = y * y, zz = z * z;
+			T xy = x * y, xz = x * z, yz = y * z;
+			T wx = w * x, wy = w * y, wz = w * z;
+			const T one = static_cast<T>(1.0);
+			const T two = static_cast<T>(2.0);
+			Mat<T, 3, 3> m;
+			m[0][0] = one - two * (yy + zz);
+			m[0][1] = two * (xy - wz);
+			m[0][2] = two * (xz + wy);
+			m[1][0] = two * (xy + wz);
+			m[1][1] = one - two * (xx + zz);
+			m[1][2] = two * (yz - wx);
+			m[2][0] = two * (xz - wy);
+			m[2][1] = two * (yz + wx);
+			m[2][2] = one - two * (xx + yy);
+			return (m);
+		};
+		constexpr Mat<T, 4, 4> toMat4() const {
+			Mat<T, 3, 3> r = toMat3();
+			Mat<T, 4, 4> m;
+			for (size_t i = 0; i < 3; ++i)
+				for (size_t j = 0; j < 3; ++j)
+					m[i][j] = r[i][j];
+			m[3][3] = static_cast<T>(1.0);
+			return (m);
+		};
+
+		static constexpr T dot(const Quaternion<T>& a, const Quaternion<T>& b) {
+			return a.data[0] * b.data[0] + a.data[1] * b.data[1]
+				+ a.data[2] * b.data[2] + a.data[3] * b.data[3];
+		};
+
+		/**
+		 * @brief Normalized linear interpolation along the shorter arc. Not
+		 * constant speed, but cheap and close to slerp for small angles.
+		 */
+		static Quaternion<T> nlerp(const Quaternion<T>& a, const Quaternion<T>& b, T t) {
+			T sign = dot(a, b) < static_cast<T>(0.0) ? static_cast<T>(-1.0) : static_cast<T>(1.0);
+			Quaternion<T> result;
+			for (size_t i = 0; i < 4; ++i)
+				result.data[i] = a.data[i] + (sign * b.data[i] - a.data[i]) * t;
+			result.normalize();
+			return (result);
+		};
+
+		/**
+		 * @brief Constant-speed spherical interpolation along the shorter arc.
+		 */
+		static Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, T t) {
+			T cosTheta = dot(a, b);
+			T sign = static_cast<T>(1.0);
+			if (cosTheta < static_cast<T>(0.0)) {
+				cosTheta = -cosTheta;
+				sign = static_cast<T>(-1.0);
+			}
+			// sin(theta) -> 0, the weights below lose precision
+			if (cosTheta > static_cast<T>(0.9995))
+				return nlerp(a, b, t);
+			T theta = std::acos(cosTheta);
+			T invSin = static_cast<T>(1.0) / std::sin(theta);
+			T wa = std::sin((static_cast<T>(1.0) - t) * theta) * invSin;
+			T wb = std::sin(t * theta) * invSin * sign;
+			Quaternion<T> result;
+			for (size_t i = 0; i < 4; ++i)
+				result.data[i] = a.data[i] * wa + b.data[i] * wb;
+			return (result);
+		};
+
+	private:
+		static constexpr size_t component(char c) {
+			if (c == 'x')
+				return (0);
+			if (c == 'y')
+				return (1);
+			if (c == 'z')
+				return (2);
+			if (c == 'w')
+				return (3);
+			throw std::runtime_error("Value is out of range!");
+		};
+	};
+
+	template <class T>
+	std::ostream& operator<<(std::ostream& os, const Quaternion<T>& q) {
+		os << "[ " << q['w'] << " " << q['x'] << " " << q['y'] << " " << q['z'] << " ]";
+		return os;
+	}
+
+	typedef Quaternion<float>	Quatf;
+	typedef Quaternion<double>	Quatd;
+} // namespace rt
+
+#endif // !RT_QUATERNION_HPP
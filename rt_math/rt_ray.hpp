@@ -0,0 +1,477 @@
+#ifndef RT_RAY_HPP
+#define RT_RAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "rt_simd.hpp"
+#include "rt_vec.hpp"
+
+namespace rt
+{
+	/**
+	 * Ray origin + t * direction, t > 0. direction need not be unit length;
+	 * hit distances are then in units of |direction|.
+	 */
+	struct Ray
+	{
+		Vec3f	origin;
+		Vec3f	direction;
+	};
+
+/**
+ * Moller-Trumbore ray/triangle intersection over SoA triangles.
+ *
+ * - intersectClosest: one ray against many triangles, 4 (SSE2) or 8 (AVX)
+ *   triangles per step, returns the nearest hit.
+ * - intersectPacket: many rays (SoA) against one triangle, 4 or 8 rays per
+ *   step, keeps the nearest hit per ray; loop it over the triangles of a
+ *   mesh, or over the leaves of a BVH.
+ *
+ * Triangles are stored as v0 and the edges e1 = v1 - v0, e2 = v2 - v0,
+ * see packTriangles. Hits report t and the barycentrics (u, v) of v1 and
+ * v2. Triangles are two-sided; a ray parallel to the plane
+ * (|det| <= EPSILON) misses.
+ */
+namespace ray
+{
+	const float EPSILON = 1e-8f;
+
+	struct Hit
+	{
+		float	t;
+		float	u;
+		float	v;
+		int		index;	// -1 when nothing was hit
+	};
+
+	/**
+	 * @brief View over 9 * count floats laid out v0x[count], v0y, v0z, e1x,
+	 * e1y, e1z, e2x, e2y, e2z.
+	 */
+	struct Triangles
+	{
+		const float	*v0x, *v0y, *v0z;
+		const float	*e1x, *e1y, *e1z;
+		const float	*e2x, *e2y, *e2z;
+		size_t		count;
+
+		Triangles(const float *packed, size_t count)
+			: v0x(packed), v0y(packed + count), v0z(packed + 2 * count),
+			e1x(packed + 3 * count), e1y(packed + 4 * count), e1z(packed + 5 * count),
+			e2x(packed + 6 * count), e2y(packed + 7 * count), e2z(packed + 8 * count),
+			count(count) {}
+	};
+
+	/**
+	 * @brief Packs count indexed triangles (3 indices each) from interleaved
+	 * positions (stride in floats, e.g. 6 for x y z r g b) into the
+	 * Triangles layout; packed holds 9 * count floats.
+	 */
+	inline void packTriangles(const float *positions, size_t stride,
+		const int *indices, size_t count, float *packed
+	) {
+		for (size_t i = 0; i < count; ++i) {
+			const float *a = positions + static_cast<size_t>(indices[3 * i]) * stride;
+			const float *b = positions + static_cast<size_t>(indices[3 * i + 1]) * stride;
+			const float *c = positions + static_cast<size_t>(indices[3 * i + 2]) * stride;
+			for (size_t k = 0; k < 3; ++k) {
+				packed[k * count + i] = a[k];
+				packed[(3 + k) * count + i] = b[k] - a[k];
+				packed[(6 + k) * count + i] = c[k] - a[k];
+			}
+		}
+	}
+
+	/**
+	 * @brief SoA rays (origins and directions) and their hits, t doubling as
+	 * the current closest distance: initialize it to the far limit and index
+	 * to -1 (see resetHits).
+	 */
+	struct RayPacket
+	{
+		const float	*ox, *oy, *oz;
+		const float	*dx, *dy, *dz;
+		size_t		count;
+	};
+
+	struct HitPacket
+	{
+		float	*t;
+		float	*u;
+		float	*v;
+		int		*index;
+	};
+
+	inline void resetHits(const HitPacket &hits, size_t count,
+		float tMax = std::numeric_limits<float>::infinity()
+	) {
+		for (size_t i = 0; i < count; ++i) {
+			hits.t[i] = tMax;
+			hits.u[i] = 0.0f;
+			hits.v[i] = 0.0f;
+			hits.index[i] = -1;
+		}
+	}
+
+	/**
+	 * @brief Scalar test of one ray against triangle i, true when it hits at
+	 * EPSILON < t < tMax.
+	 */
+	inline bool intersectTriangle(float ox, float oy, float oz, float dx, float dy, float dz,
+		const Triangles &tris, size_t i, float tMax, float &t, float &u, float &v
+	) {
+		float e1x = tris.e1x[i], e1y = tris.e1y[i], e1z = tris.e1z[i];
+		float e2x = tris.e2x[i], e2y = tris.e2y[i], e2z = tris.e2z[i];
+		float px = dy * e2z - dz * e2y;
+		float py = dz * e2x - dx * e2z;
+		float pz = dx * e2y - dy * e2x;
+		float det = e1x * px + e1y * py + e1z * pz;
+		if (det <= EPSILON && det >= -EPSILON)
+			return (false);
+		float inv = 1.0f / det;
+		float sx = ox - tris.v0x[i], sy = oy - tris.v0y[i], sz = oz - tris.v0z[i];
+		float hu = (sx * px + sy * py + sz * pz) * inv;
+		if (hu < 0.0f || hu > 1.0f)
+			return (false);
+		float qx = sy * e1z - sz * e1y;
+		float qy = sz * e1x - sx * e1z;
+		float qz = sx * e1y - sy * e1x;
+		float hv = (dx * qx + dy * qy + dz * qz) * inv;
+		if (hv < 0.0f || hu + hv > 1.0f)
+			return (false);
+		float ht = (e2x * qx + e2y * qy + e2z * qz) * inv;
+		if (!(ht > EPSILON && ht < tMax))
+			return (false);
+		t = ht;
+		u = hu;
+		v = hv;
+		return (true);
+	}
+
+	typedef void (*ClosestFn)(const float *ray, const Triangles &tris, size_t begin, Hit &hit);
+	typedef void (*PacketFn)(const RayPacket &rays, const Triangles &tris, size_t tri, const HitPacket &hits);
+
+	/**
+	 * ray is ox oy oz dx dy dz. Triangles [begin, count) are tested and hit
+	 * is updated in place, hit.t being the current far limit.
+	 */
+	inline void closestScalar(const float *ray, const Triangles &tris, size_t begin, Hit &hit) {
+		for (size_t i = begin; i < tris.count; ++i)
+			if (intersectTriangle(ray[0], ray[1], ray[2], ray[3], ray[4], ray[5],
+					tris, i, hit.t, hit.t, hit.u, hit.v))
+				hit.index = static_cast<int>(i);
+	}
+
+	inline void packetScalarRange(const RayPacket &rays, size_t begin,
+		const Triangles &tris, size_t tri, const HitPacket &hits
+	) {
+		for (size_t r = begin; r < rays.count; ++r)
+			if (intersectTriangle(rays.ox[r], rays.oy[r], rays.oz[r], rays.dx[r], rays.dy[r], rays.dz[r],
+					tris, tri, hits.t[r], hits.t[r], hits.u[r], hits.v[r]))
+				hits.index[r] = static_cast<int>(tri);
+	}
+
+	inline void packetScalar(const RayPacket &rays, const Triangles &tris, size_t tri, const HitPacket &hits) {
+		packetScalarRange(rays, 0, tris, tri, hits);
+	}
+
+#if RT_SIMD_X86
+
+	__attribute__((target("sse2")))
+	inline __m128 selectSse2(__m128 mask, __m128 a, __m128 b) {
+		return (_mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)));
+	}
+
+	__attribute__((target("sse2")))
+	inline void closestSse2(const float *ray, const Triangles &tris, size_t begin, Hit &hit) {
+		const __m128 ox = _mm_set1_ps(ray[0]), oy = _mm_set1_ps(ray[1]), oz = _mm_set1_ps(ray[2]);
+		const __m128 dx = _mm_set1_ps(ray[3]), dy = _mm_set1_ps(ray[4]), dz = _mm_set1_ps(ray[5]);
+		const __m128 eps = _mm_set1_ps(EPSILON);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 bestT = _mm_set1_ps(hit.t);
+		__m128 bestU = zero, bestV = zero;
+		__m128i bestI = _mm_set1_epi32(-1);
+		__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+		index = _mm_add_epi32(index, _mm_set1_epi32(static_cast<int>(begin)));
+		const __m128i step = _mm_set1_epi32(4);
+
+		size_t i = begin;
+		for (; i + 4 <= tris.count; i += 4, index = _mm_add_epi32(index, step)) {
+			__m128 e1x = _mm_loadu_ps(tris.e1x + i), e1y = _mm_loadu_ps(tris.e1y + i), e1z = _mm_loadu_ps(tris.e1z + i);
+			__m128 e2x = _mm_loadu_ps(tris.e2x + i), e2y = _mm_loadu_ps(tris.e2y + i), e2z = _mm_loadu_ps(tris.e2z + i);
+			__m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+			__m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+			__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+			__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+			__m128 inv = _mm_div_ps(one, det);
+			__m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(tris.v0x + i));
+			__m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(tris.v0y + i));
+			__m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(tris.v0z + i));
+			__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv);
+			__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+			__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+			__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+			__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv);
+			__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+
+			__m128 mask = _mm_cmpgt_ps(_mm_and_ps(det, absMask), eps);
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+			mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, eps));
+			mask = _mm_and_ps(mask, _mm_cmplt_ps(t, bestT));
+			if (_mm_movemask_ps(mask) == 0)
+				continue;
+			bestT = selectSse2(mask, t, bestT);
+			bestU = selectSse2(mask, u, bestU);
+			bestV = selectSse2(mask, v, bestV);
+			bestI = _mm_castps_si128(selectSse2(mask, _mm_castsi128_ps(index), _mm_castsi128_ps(bestI)));
+		}
+
+		float lt[4], lu[4], lv[4];
+		int li[4];
+		_mm_storeu_ps(lt, bestT);
+		_mm_storeu_ps(lu, bestU);
+		_mm_storeu_ps(lv, bestV);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(li), bestI);
+		// equal distances go to the lower index, as in the scalar loop
+		for (size_t k = 0; k < 4; ++k) {
+			if (li[k] >= 0 && (lt[k] < hit.t || (lt[k] == hit.t && li[k] < hit.index))) {
+				hit.t = lt[k];
+				hit.u = lu[k];
+				hit.v = lv[k];
+				hit.index = li[k];
+			}
+		}
+		closestScalar(ray, tris, i, hit);
+	}
+
+	__attribute__((target("sse2")))
+	inline void packetSse2(const RayPacket &rays, const Triangles &tris, size_t tri, const HitPacket &hits) {
+		const __m128 v0x = _mm_set1_ps(tris.v0x[tri]), v0y = _mm_set1_ps(tris.v0y[tri]), v0z = _mm_set1_ps(tris.v0z[tri]);
+		const __m128 e1x = _mm_set1_ps(tris.e1x[tri]), e1y = _mm_set1_ps(tris.e1y[tri]), e1z = _mm_set1_ps(tris.e1z[tri]);
+		const __m128 e2x = _mm_set1_ps(tris.e2x[tri]), e2y = _mm_set1_ps(tris.e2y[tri]), e2z = _mm_set1_ps(tris.e2z[tri]);
+		const __m128 eps = _mm_set1_ps(EPSILON);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		const __m128i triIndex = _mm_set1_epi32(static_cast<int>(tri));
+
+		size_t r = 0;
+		for (; r + 4 <= rays.count; r += 4) {
+			__m128 dx = _mm_loadu_ps(rays.dx + r), dy = _mm_loadu_ps(rays.dy + r), dz = _mm_loadu_ps(rays.dz + r);
+			__m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+			__m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+			__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+			__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+			__m128 inv = _mm_div_ps(one, det);
+			__m128 sx = _mm_sub_ps(_mm_loadu_ps(rays.ox + r), v0x);
+			__m128 sy = _mm_sub_ps(_mm_loadu_ps(rays.oy + r), v0y);
+			__m128 sz = _mm_sub_ps(_mm_loadu_ps(rays.oz + r), v0z);
+			__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv);
+			__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+			__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+			__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+			__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv);
+			__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+			__m128 bestT = _mm_loadu_ps(hits.t + r);
+
+			__m128 mask = _mm_cmpgt_ps(_mm_and_ps(det, absMask), eps);
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+			mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, eps));
+			mask = _mm_and_ps(mask, _mm_cmplt_ps(t, bestT));
+			if (_mm_movemask_ps(mask) == 0)
+				continue;
+			_mm_storeu_ps(hits.t + r, selectSse2(mask, t, bestT));
+			_mm_storeu_ps(hits.u + r, selectSse2(mask, u, _mm_loadu_ps(hits.u + r)));
+			_mm_storeu_ps(hits.v + r, selectSse2(mask, v, _mm_loadu_ps(hits.v + r)));
+			__m128 bestI = _mm_loadu_ps(reinterpret_cast<const float *>(hits.index + r));
+			_mm_storeu_ps(reinterpret_cast<float *>(hits.index + r), selectSse2(mask, _mm_castsi128_ps(triIndex), bestI));
+		}
+		packetScalarRange(rays, r, tris, tri, hits);
+	}
+
+	__attribute__((target("avx")))
+	inline void closestAvx(const float *ray, const Triangles &tris, size_t begin, Hit &hit) {
+		const __m256 ox = _mm256_set1_ps(ray[0]), oy = _mm256_set1_ps(ray[1]), oz = _mm256_set1_ps(ray[2]);
+		const __m256 dx = _mm256_set1_ps(ray[3]), dy = _mm256_set1_ps(ray[4]), dz = _mm256_set1_ps(ray[5]);
+		const __m256 eps = _mm256_set1_ps(EPSILON);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		__m256 bestT = _mm256_set1_ps(hit.t);
+		__m256 bestU = zero, bestV = zero;
+		// float lanes hold int indices, blends only move bits
+		__m256 bestI = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+		size_t i = begin;
+		for (; i + 8 <= tris.count; i += 8) {
+			__m256 e1x = _mm256_loadu_ps(tris.e1x + i), e1y = _mm256_loadu_ps(tris.e1y + i), e1z = _mm256_loadu_ps(tris.e1z + i);
+			__m256 e2x = _mm256_loadu_ps(tris.e2x + i), e2y = _mm256_loadu_ps(tris.e2y + i), e2z = _mm256_loadu_ps(tris.e2z + i);
+			__m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+			__m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+			__m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+			__m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+			__m256 inv = _mm256_div_ps(one, det);
+			__m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(tris.v0x + i));
+			__m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(tris.v0y + i));
+			__m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(tris.v0z + i));
+			__m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), inv);
+			__m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+			__m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+			__m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+			__m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv);
+			__m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv);
+
+			__m256 mask = _mm256_cmp_ps(_mm256_and_ps(det, absMask), eps, _CMP_GT_OQ);
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, eps, _CMP_GT_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, bestT, _CMP_LT_OQ));
+			if (_mm256_movemask_ps(mask) == 0)
+				continue;
+			__m256 index = _mm256_castsi256_ps(_mm256_setr_epi32(
+				static_cast<int>(i), static_cast<int>(i + 1), static_cast<int>(i + 2), static_cast<int>(i + 3),
+				static_cast<int>(i + 4), static_cast<int>(i + 5), static_cast<int>(i + 6), static_cast<int>(i + 7)));
+			bestT = _mm256_blendv_ps(bestT, t, mask);
+			bestU = _mm256_blendv_ps(bestU, u, mask);
+			bestV = _mm256_blendv_ps(bestV, v, mask);
+			bestI = _mm256_blendv_ps(bestI, index, mask);
+		}
+
+		float lt[8], lu[8], lv[8];
+		int li[8];
+		_mm256_storeu_ps(lt, bestT);
+		_mm256_storeu_ps(lu, bestU);
+		_mm256_storeu_ps(lv, bestV);
+		_mm256_storeu_ps(reinterpret_cast<float *>(li), bestI);
+		// equal distances go to the lower index, as in the scalar loop
+		for (size_t k = 0; k < 8; ++k) {
+			if (li[k] >= 0 && (lt[k] < hit.t || (lt[k] == hit.t && li[k] < hit.index))) {
+				hit.t = lt[k];
+				hit.u = lu[k];
+				hit.v = lv[k];
+				hit.index = li[k];
+			}
+		}
+		closestScalar(ray, tris, i, hit);
+	}
+
+	__attribute__((target("avx")))
+	inline void packetAvx(const RayPacket &rays, const Triangles &tris, size_t tri, const HitPacket &hits) {
+		const __m256 v0x = _mm256_set1_ps(tris.v0x[tri]), v0y = _mm256_set1_ps(tris.v0y[tri]), v0z = _mm256_set1_ps(tris.v0z[tri]);
+		const __m256 e1x = _mm256_set1_ps(tris.e1x[tri]), e1y = _mm256_set1_ps(tris.e1y[tri]), e1z = _mm256_set1_ps(tris.e1z[tri]);
+		const __m256 e2x = _mm256_set1_ps(tris.e2x[tri]), e2y = _mm256_set1_ps(tris.e2y[tri]), e2z = _mm256_set1_ps(tris.e2z[tri]);
+		const __m256 eps = _mm256_set1_ps(EPSILON);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		const __m256 triIndex = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(tri)));
+
+		size_t r = 0;
+		for (; r + 8 <= rays.count; r += 8) {
+			__m256 dx = _mm256_loadu_ps(rays.dx + r), dy = _mm256_loadu_ps(rays.dy + r), dz = _mm256_loadu_ps(rays.dz + r);
+			__m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+			__m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+			__m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+			__m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+			__m256 inv = _mm256_div_ps(one, det);
+			__m256 sx = _mm256_sub_ps(_mm256_loadu_ps(rays.ox + r), v0x);
+			__m256 sy = _mm256_sub_ps(_mm256_loadu_ps(rays.oy + r), v0y);
+			__m256 sz = _mm256_sub_ps(_mm256_loadu_ps(rays.oz + r), v0z);
+			__m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), inv);
+			__m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+			__m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+			__m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+			__m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv);
+			__m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv);
+			__m256 bestT = _mm256_loadu_ps(hits.t + r);
+
+			__m256 mask = _mm256_cmp_ps(_mm256_and_ps(det, absMask), eps, _CMP_GT_OQ);
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, eps, _CMP_GT_OQ));
+			mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, bestT, _CMP_LT_OQ));
+			if (_mm256_movemask_ps(mask) == 0)
+				continue;
+			_mm256_storeu_ps(hits.t + r, _mm256_blendv_ps(bestT, t, mask));
+			_mm256_storeu_ps(hits.u + r, _mm256_blendv_ps(_mm256_loadu_ps(hits.u + r), u, mask));
+			_mm256_storeu_ps(hits.v + r, _mm256_blendv_ps(_mm256_loadu_ps(hits.v + r), v, mask));
+			float *index = reinterpret_cast<float *>(hits.index + r);
+			_mm256_storeu_ps(index, _mm256_blendv_ps(_mm256_loadu_ps(index), triIndex, mask));
+		}
+		packetScalarRange(rays, r, tris, tri, hits);
+	}
+
+#endif // RT_SIMD_X86
+
+	inline ClosestFn closestKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2 || isa == simd::ISA_AVX)
+			return (closestAvx);
+		if (isa == simd::ISA_SSE2)
+			return (closestSse2);
+#endif
+		(void)isa;
+		return (closestScalar);
+	}
+
+	inline PacketFn packetKernel(simd::Isa isa) {
+#if RT_SIMD_X86
+		if (isa == simd::ISA_AVX2 || isa == simd::ISA_AVX)
+			return (packetAvx);
+		if (isa == simd::ISA_SSE2)
+			return (packetSse2);
+#endif
+		(void)isa;
+		return (packetScalar);
+	}
+
+	/**
+	 * @brief Nearest hit of ray among tris closer than tMax, index -1 if none.
+	 */
+	inline Hit intersectClosest(const Ray &ray, const Triangles &tris,
+		float tMax = std::numeric_limits<float>::infinity()
+	) {
+		static const ClosestFn kernel = closestKernel(simd::activeIsa());
+		const float r[6] = {
+			ray.origin[0], ray.origin[1], ray.origin[2],
+			ray.direction[0], ray.direction[1], ray.direction[2]
+		};
+		Hit hit;
+		hit.t = tMax;
+		hit.u = 0.0f;
+		hit.v = 0.0f;
+		hit.index = -1;
+		kernel(r, tris, 0, hit);
+		return (hit);
+	}
+
+	/**
+	 * @brief Tests every ray of the packet against triangle tri, updating the
+	 * hits it is closer for.
+	 */
+	inline void intersectPacket(const RayPacket &rays, const Triangles &tris, size_t tri, const HitPacket &hits) {
+		static const PacketFn kernel = packetKernel(simd::activeIsa());
+		kernel(rays, tris, tri, hits);
+	}
+
+	/**
+	 * @brief Brute-force nearest hits of a packet over all triangles.
+	 */
+	inline void intersectPacket(const RayPacket &rays, const Triangles &tris, const HitPacket &hits) {
+		static const PacketFn kernel = packetKernel(simd::activeIsa());
+		for (size_t tri = 0; tri < tris.count; ++tri)
+			kernel(rays, tris, tri, hits);
+	}
+} // namespace ray
+} // namespace rt
+
+#endif // !RT_RAY_HPP
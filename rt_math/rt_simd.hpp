@@ -0,0 +1,242 @@
+#ifndef RT_SIMD_HPP
+#define RT_SIMD_HPP
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define RT_SIMD_X86 1
+# include <immintrin.h>
+#else
+# define RT_SIMD_X86 0
+#endif
+
+/**
+ * 4x4 float kernels for row-major matrices (element (i, j) at m[i * 4 + j]).
+ *
+ * Every kernel has a scalar reference and, on x86, SSE2, AVX and AVX2+FMA
+ * variants compiled with target attributes, so the translation unit itself
+ * needs no -m flags. The variant is chosen once at runtime from cpuid.
+ * The FMA variant rounds once per multiply-add and may differ from the
+ * scalar path in the last bit.
+ */
+namespace rt
+{
+namespace simd
+{
+	enum Isa
+	{
+		ISA_SCALAR,
+		ISA_SSE2,
+		ISA_AVX,
+		ISA_AVX2
+	};
+
+	inline const char *isaName(Isa isa) {
+		if (isa == ISA_AVX2)
+			return ("avx2");
+		if (isa == ISA_AVX)
+			return ("avx");
+		if (isa == ISA_SSE2)
+			return ("sse2");
+		return ("scalar");
+	}
+
+	inline Isa detectIsa() {
+#if RT_SIMD_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			return (ISA_AVX2);
+		if (__builtin_cpu_supports("avx"))
+			return (ISA_AVX);
+		if (__builtin_cpu_supports("sse2"))
+			return (ISA_SSE2);
+#endif
+		return (ISA_SCALAR);
+	}
+
+	/**
+	 * @brief ISA used by the dispatching entry points, detected on first call.
+	 */
+	inline Isa activeIsa() {
+		static const Isa isa = detectIsa();
+		return (isa);
+	}
+
+	typedef void (*Mat4MulFn)(const float *a, const float *b, float *out);
+	typedef void (*Mat4MulVec4Fn)(const float *m, const float *v, float *out);
+
+////////////////////////////////// Scalar //////////////////////////////////////
+
+	inline void mat4MulScalar(const float *a, const float *b, float *out) {
+		float result[16];
+		for (size_t i = 0; i < 4; ++i) {
+			for (size_t j = 0; j < 4; ++j) {
+				float sum = 0.0f;
+				for (size_t k = 0; k < 4; ++k)
+					sum += a[i * 4 + k] * b[k * 4 + j];
+				result[i * 4 + j] = sum;
+			}
+		}
+		for (size_t i = 0; i < 16; ++i)
+			out[i] = result[i];
+	}
+
+	inline void mat4MulVec4Scalar(const float *m, const float *v, float *out) {
+		float result[4];
+		for (size_t i = 0; i < 4; ++i) {
+			float sum = 0.0f;
+			for (size_t j = 0; j < 4; ++j)
+				sum += m[i * 4 + j] * v[j];
+			result[i] = sum;
+		}
+		for (size_t i = 0; i < 4; ++i)
+			out[i] = result[i];
+	}
+
+#if RT_SIMD_X86
+
+/////////////////////////////////// SSE2 ///////////////////////////////////////
+
+	// out row i = sum over k of a[i][k] * (row k of b)
+	__attribute__((target("sse2")))
+	inline void mat4MulSse2(const float *a, const float *b, float *out) {
+		__m128 b0 = _mm_loadu_ps(b);
+		__m128 b1 = _mm_loadu_ps(b + 4);
+		__m128 b2 = _mm_loadu_ps(b + 8);
+		__m128 b3 = _mm_loadu_ps(b + 12);
+		__m128 r[4];
+		for (size_t i = 0; i < 4; ++i) {
+			__m128 row = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), b1));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), b2));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), b3));
+			r[i] = row;
+		}
+		for (size_t i = 0; i < 4; ++i)
+			_mm_storeu_ps(out + i * 4, r[i]);
+	}
+
+	__attribute__((target("sse2")))
+	inline void mat4MulVec4Sse2(const float *m, const float *v, float *out) {
+		__m128 vec = _mm_loadu_ps(v);
+		__m128 p0 = _mm_mul_ps(_mm_loadu_ps(m), vec);
+		__m128 p1 = _mm_mul_ps(_mm_loadu_ps(m + 4), vec);
+		__m128 p2 = _mm_mul_ps(_mm_loadu_ps(m + 8), vec);
+		__m128 p3 = _mm_mul_ps(_mm_loadu_ps(m + 12), vec);
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		// same association as the scalar loop: ((x + y) + z) + w
+		_mm_storeu_ps(out, _mm_add_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), p3));
+	}
+
+//////////////////////////////////// AVX ///////////////////////////////////////
+
+	// Two output rows per 256-bit register: lane 0 holds row i, lane 1 row i + 1.
+	__attribute__((target("avx")))
+	inline void mat4MulAvx(const float *a, const float *b, float *out) {
+		__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b));
+		__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 4));
+		__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 8));
+		__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 12));
+		__m256 a01 = _mm256_loadu_ps(a);
+		__m256 a23 = _mm256_loadu_ps(a + 8);
+
+		__m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0x55), b1));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xAA), b2));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xFF), b3));
+
+		__m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0x55), b1));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xAA), b2));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xFF), b3));
+
+		_mm256_storeu_ps(out, r01);
+		_mm256_storeu_ps(out + 8, r23);
+	}
+
+	__attribute__((target("avx")))
+	inline void mat4MulVec4Avx(const float *m, const float *v, float *out) {
+		__m256 vec = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(v));
+		__m256 p01 = _mm256_mul_ps(_mm256_loadu_ps(m), vec);
+		__m256 p23 = _mm256_mul_ps(_mm256_loadu_ps(m + 8), vec);
+		// [r0 r2 r0 r2 | r1 r3 r1 r3] after two horizontal adds
+		__m256 h = _mm256_hadd_ps(p01, p23);
+		h = _mm256_hadd_ps(h, h);
+		__m128 lo = _mm256_castps256_ps128(h);
+		__m128 hi = _mm256_extractf128_ps(h, 1);
+		_mm_storeu_ps(out, _mm_unpacklo_ps(lo, hi));
+	}
+
+/////////////////////////////////// AVX2 ///////////////////////////////////////
+
+	__attribute__((target("avx2,fma")))
+	inline void mat4MulAvx2(const float *a, const float *b, float *out) {
+		__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b));
+		__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 4));
+		__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 8));
+		__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b + 12));
+		__m256 a01 = _mm256_loadu_ps(a);
+		__m256 a23 = _mm256_loadu_ps(a + 8);
+
+		__m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+		r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, r01);
+		r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, r01);
+		r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xFF), b3, r01);
+
+		__m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+		r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0x55), b1, r23);
+		r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xAA), b2, r23);
+		r23 = _mm256_fmadd_ps(_mm256_permute_ps(a23, 0xFF), b3, r23);
+
+		_mm256_storeu_ps(out, r01);
+		_mm256_storeu_ps(out + 8, r23);
+	}
+
+#endif // RT_SIMD_X86
+
+///////////////////////////////// Dispatch /////////////////////////////////////
+
+	inline Mat4MulFn mat4MulKernel(Isa isa) {
+#if RT_SIMD_X86
+		if (isa == ISA_AVX2)
+			return (mat4MulAvx2);
+		if (isa == ISA_AVX)
+			return (mat4MulAvx);
+		if (isa == ISA_SSE2)
+			return (mat4MulSse2);
+#endif
+		(void)isa;
+		return (mat4MulScalar);
+	}
+
+	inline Mat4MulVec4Fn mat4MulVec4Kernel(Isa isa) {
+#if RT_SIMD_X86
+		// a horizontal-add kernel gains nothing from FMA, AVX2 reuses AVX
+		if (isa == ISA_AVX2 || isa == ISA_AVX)
+			return (mat4MulVec4Avx);
+		if (isa == ISA_SSE2)
+			return (mat4MulVec4Sse2);
+#endif
+		(void)isa;
+		return (mat4MulVec4Scalar);
+	}
+
+	/**
+	 * @brief out = a * b for row-major 4x4 matrices. out may alias a or b.
+	 */
+	inline void mat4Mul(const float *a, const float *b, float *out) {
+		static const Mat4MulFn kernel = mat4MulKernel(activeIsa());
+		kernel(a, b, out);
+	}
+
+	/**
+	 * @brief out = m * v for a row-major 4x4 matrix. out may alias v.
+	 */
+	inline void mat4MulVec4(const float *m, const float *v, float *out) {
+		static const Mat4MulVec4Fn kernel = mat4MulVec4Kernel(activeIsa());
+		kernel(m, v, out);
+	}
+} // namespace simd
+} // namespace rt
+
+#endif // !RT_SIMD_HPP
@@ -0,0 +1,216 @@
+#ifndef RT_SOLVE_HPP
+#define RT_SOLVE_HPP
+
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+#include "rt_gemm.hpp"
+
+/**
+ * Dense factorizations of row-major n x n matrices (element (i, j) at
+ * a[i * lda + j]) and the matching solvers, so systems are solved without
+ * forming an inverse. Right-hand sides are n x nrhs row-major blocks and
+ * are overwritten with the solution.
+ *
+ * Both factorizations are blocked: a narrow panel is factored with row
+ * operations and the trailing submatrix is updated with gemm, which is
+ * where nearly all of the O(n^3) work goes.
+ */
+namespace rt
+{
+namespace solve
+{
+	const size_t BLOCK = 64;
+
+	/**
+	 * @brief In-place LU with partial pivoting, P * A = L * U. L (unit
+	 * diagonal) is stored below the diagonal, U on and above it, and row i
+	 * was swapped with row pivots[i] at step i.
+	 */
+	template <class T>
+	void luDecompose(T *a, size_t n, size_t lda, size_t *pivots, unsigned threads = 0) {
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK) {
+			size_t kb = n - k0 < BLOCK ? n - k0 : BLOCK;
+			size_t k1 = k0 + kb;
+
+			// panel: columns [k0, k1) of rows [k0, n)
+			for (size_t j = k0; j < k1; ++j) {
+				size_t pivot = j;
+				T max = std::fabs(a[j * lda + j]);
+				for (size_t i = j + 1; i < n; ++i) {
+					if (std::fabs(a[i * lda + j]) > max) {
+						max = std::fabs(a[i * lda + j]);
+						pivot = i;
+					}
+				}
+				pivots[j] = pivot;
+				if (max == static_cast<T>(0.0))
+					throw std::runtime_error("Matrix is singular!");
+				if (pivot != j) {
+					T *r1 = a + j * lda;
+					T *r2 = a + pivot * lda;
+					for (size_t c = 0; c < n; ++c) {
+						T temp = r1[c];
+						r1[c] = r2[c];
+						r2[c] = temp;
+					}
+				}
+				T inv = static_cast<T>(1.0) / a[j * lda + j];
+				const T *rowJ = a + j * lda;
+				for (size_t i = j + 1; i < n; ++i) {
+					T *rowI = a + i * lda;
+					T l = rowI[j] * inv;
+					rowI[j] = l;
+					for (size_t c = j + 1; c < k1; ++c)
+						rowI[c] -= l * rowJ[c];
+				}
+			}
+			if (k1 == n)
+				break;
+
+			// U12 = L11^-1 * A12
+			for (size_t i = k0 + 1; i < k1; ++i) {
+				T *rowI = a + i * lda;
+				for (size_t r = k0; r < i; ++r) {
+					T l = rowI[r];
+					const T *rowR = a + r * lda;
+					for (size_t c = k1; c < n; ++c)
+						rowI[c] -= l * rowR[c];
+				}
+			}
+
+			// A22 -= L21 * U12
+			gemm::multiplyAdd(n - k1, n - k1, kb, static_cast<T>(-1.0),
+				a + k1 * lda + k0, lda, a + k0 * lda + k1, lda, a + k1 * lda + k1, lda, threads);
+		}
+	}
+
+	/**
+	 * @brief Solves A * X = B from luDecompose's output, B overwritten by X.
+	 */
+	template <class T>
+	void luSolve(const T *lu, size_t n, size_t lda, const size_t *pivots, T *b, size_t nrhs, size_t ldb) {
+		for (size_t i = 0; i < n; ++i) {
+			if (pivots[i] == i)
+				continue;
+			T *r1 = b + i * ldb;
+			T *r2 = b + pivots[i] * ldb;
+			for (size_t c = 0; c < nrhs; ++c) {
+				T temp = r1[c];
+				r1[c] = r2[c];
+				r2[c] = temp;
+			}
+		}
+		// L * Y = P * B
+		for (size_t i = 1; i < n; ++i) {
+			T *rowI = b + i * ldb;
+			for (size_t r = 0; r < i; ++r) {
+				T l = lu[i * lda + r];
+				const T *rowR = b + r * ldb;
+				for (size_t c = 0; c < nrhs; ++c)
+					rowI[c] -= l * rowR[c];
+			}
+		}
+		// U * X = Y
+		for (size_t i = n; i-- > 0;) {
+			T *rowI = b + i * ldb;
+			for (size_t r = i + 1; r < n; ++r) {
+				T u = lu[i * lda + r];
+				const T *rowR = b + r * ldb;
+				for (size_t c = 0; c < nrhs; ++c)
+					rowI[c] -= u * rowR[c];
+			}
+			T inv = static_cast<T>(1.0) / lu[i * lda + i];
+			for (size_t c = 0; c < nrhs; ++c)
+				rowI[c] *= inv;
+		}
+	}
+
+	/**
+	 * @brief In-place Cholesky A = L * L^T of a symmetric positive definite
+	 * matrix. Only the lower triangle is read; L replaces it and the strict
+	 * upper triangle is zeroed.
+	 */
+	template <class T>
+	void choleskyDecompose(T *a, size_t n, size_t lda, unsigned threads = 0) {
+		T *panelT = NULL;
+		for (size_t k0 = 0; k0 < n; k0 += BLOCK) {
+			size_t kb = n - k0 < BLOCK ? n - k0 : BLOCK;
+			size_t k1 = k0 + kb;
+
+			// L11 and L21 column by column, dot products over the panel only
+			for (size_t i = k0; i < n; ++i) {
+				T *rowI = a + i * lda;
+				size_t last = i < k1 ? i + 1 : k1;
+				for (size_t j = k0; j < last; ++j) {
+					const T *rowJ = a + j * lda;
+					T sum = rowI[j];
+					for (size_t p = k0; p < j; ++p)
+						sum -= rowI[p] * rowJ[p];
+					if (i == j) {
+						if (!(sum > static_cast<T>(0.0))) {
+							delete[] panelT;
+							throw std::runtime_error("Matrix is not positive definite!");
+						}
+						rowI[j] = std::sqrt(sum);
+					}
+					else
+						rowI[j] = sum / rowJ[j];
+				}
+			}
+			if (k1 == n)
+				break;
+
+			// A22 -= L21 * L21^T, L21^T copied out so gemm reads it row-major
+			size_t m = n - k1;
+			if (panelT == NULL)
+				panelT = new T[BLOCK * m];
+			for (size_t p = 0; p < kb; ++p)
+				for (size_t i = 0; i < m; ++i)
+					panelT[p * m + i] = a[(k1 + i) * lda + k0 + p];
+			gemm::multiplyAdd(m, m, kb, static_cast<T>(-1.0),
+				a + k1 * lda + k0, lda, panelT, m, a + k1 * lda + k1, lda, threads);
+		}
+		delete[] panelT;
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = i + 1; j < n; ++j)
+				a[i * lda + j] = static_cast<T>(0.0);
+	}
+
+	/**
+	 * @brief Solves A * X = B from choleskyDecompose's output, B overwritten
+	 * by X.
+	 */
+	template <class T>
+	void choleskySolve(const T *l, size_t n, size_t lda, T *b, size_t nrhs, size_t ldb) {
+		// L * Y = B
+		for (size_t i = 0; i < n; ++i) {
+			T *rowI = b + i * ldb;
+			for (size_t r = 0; r < i; ++r) {
+				T coef = l[i * lda + r];
+				const T *rowR = b + r * ldb;
+				for (size_t c = 0; c < nrhs; ++c)
+					rowI[c] -= coef * rowR[c];
+			}
+			T inv = static_cast<T>(1.0) / l[i * lda + i];
+			for (size_t c = 0; c < nrhs; ++c)
+				rowI[c] *= inv;
+		}
+		// L^T * X = Y, L^T[i][r] = L[r][i]
+		for (size_t i = n; i-- > 0;) {
+			T *rowI = b + i * ldb;
+			for (size_t r = i + 1; r < n; ++r) {
+				T coef = l[r * lda + i];
+				const T *rowR = b + r * ldb;
+				for (size_t c = 0; c < nrhs; ++c)
+					rowI[c] -= coef * rowR[c];
+			}
+			T inv = static_cast<T>(1.0) / l[i * lda + i];
+			for (size_t c = 0; c < nrhs; ++c)
+				rowI[c] *= inv;
+		}
+	}
+} // namespace solve
+} // namespace rt
+
+#endif // !RT_SOLVE_HPP
@@ -0,0 +1,194 @@
+#ifndef RT_TRANSFORM_HPP
+#define RT_TRANSFORM_HPP
+
+#include <cmath>
+#include <type_traits>
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+#include "rt_quaternion.hpp"
+
+/**
+ * Model/view/projection builders over Mat<T, 4, 4>, all constexpr so that
+ * constant matrices (e.g. a fixed projection) are folded at compile time.
+ *
+ * translate/scale/rotate pre-multiply: translate(m, v) == T(v) * m, so each
+ * call is applied after the transforms already accumulated in m.
+ */
+namespace rt
+{
+	/**
+	 * Compile-time math. In constant evaluation these use series / Newton
+	 * iterations accurate to a few ulp in double; at runtime they forward to
+	 * <cmath>.
+	 */
+	namespace ct
+	{
+		template <class T>
+		constexpr T sqrt(T x) {
+			if (!std::is_constant_evaluated())
+				return std::sqrt(x);
+			if (!(x > static_cast<T>(0.0)))
+				return static_cast<T>(0.0);
+			double r = x > 1.0 ? static_cast<double>(x) : 1.0;
+			for (int i = 0; i < 128; ++i) {
+				double next = 0.5 * (r + static_cast<double>(x) / r);
+				if (next == r)
+					break;
+				r = next;
+			}
+			return static_cast<T>(r);
+		}
+
+		// Taylor series of sin/cos on [-pi/2, pi/2]; the next term is < 1e-20.
+		constexpr double sinReduced(double x) {
+			double term = x;
+			double sum = x;
+			for (int n = 1; n < 14; ++n) {
+				term *= -x * x / ((2 * n) * (2 * n + 1));
+				sum += term;
+			}
+			return sum;
+		}
+
+		constexpr double cosReduced(double x) {
+			double term = 1.0;
+			double sum = 1.0;
+			for (int n = 1; n < 14; ++n) {
+				term *= -x * x / ((2 * n - 1) * (2 * n));
+				sum += term;
+			}
+			return sum;
+		}
+
+		// x - 2pi * round(x / 2pi), in [-pi, pi]
+		constexpr double reduceAngle(double x) {
+			const double twoPi = 2.0 * M_PI;
+			double k = x / twoPi;
+			long long n = static_cast<long long>(k < 0 ? k - 0.5 : k + 0.5);
+			return x - static_cast<double>(n) * twoPi;
+		}
+
+		template <class T>
+		constexpr T sin(T x) {
+			if (!std::is_constant_evaluated())
+				return std::sin(x);
+			double r = reduceAngle(x);
+			if (r > M_PI / 2)
+				r = M_PI - r;
+			else if (r < -M_PI / 2)
+				r = -M_PI - r;
+			return static_cast<T>(sinReduced(r));
+		}
+
+		template <class T>
+		constexpr T cos(T x) {
+			if (!std::is_constant_evaluated())
+				return std::cos(x);
+			double r = reduceAngle(x);
+			if (r > M_PI / 2)
+				return static_cast<T>(-cosReduced(M_PI - r));
+			if (r < -M_PI / 2)
+				return static_cast<T>(-cosReduced(-M_PI - r));
+			return static_cast<T>(cosReduced(r));
+		}
+
+		template <class T>
+		constexpr T tan(T x) {
+			if (!std::is_constant_evaluated())
+				return std::tan(x);
+			return static_cast<T>(sin(static_cast<double>(x)) / cos(static_cast<double>(x)));
+		}
+	} // namespace ct
+
+	template <class T>
+	constexpr T radians(T angle) {
+		return angle * static_cast<T>(M_PI) / static_cast<T>(180);
+	}
+
+	template <class T>
+	constexpr Mat<T, 4, 4> translate(const Mat<T, 4, 4> &matrix, const Vec<T, 3> &transVector) {
+		Mat<T, 4, 4> identityMatrix = Mat<T, 4, 4>::identity();
+
+		identityMatrix[0][3] = transVector['x'];
+		identityMatrix[1][3] = transVector['y'];
+		identityMatrix[2][3] = transVector['z'];
+		return identityMatrix * matrix;
+	}
+
+	template <class T>
+	constexpr Mat<T, 4, 4> scale(const Mat<T, 4, 4> &matrix, const Vec<T, 3> &scaleVector) {
+		Mat<T, 4, 4> identityMatrix = Mat<T, 4, 4>::identity();
+
+		identityMatrix[0][0] = scaleVector['x'];
+		identityMatrix[1][1] = scaleVector['y'];
+		identityMatrix[2][2] = scaleVector['z'];
+		return identityMatrix * matrix;
+	}
+
+	template <class T>
+	constexpr Mat<T, 4, 4> rotate(const Mat<T, 4, 4> &matrix, const Quaternion<T> &rotation) {
+		return rotation.toMat4() * matrix;
+	}
+
+	template <class T>
+	Mat<T, 4, 4> rotate(const Mat<T, 4, 4> &matrix, T rad, const Vec<T, 3> &rotAxis) {
+		return rotate(matrix, Quaternion<T>::fromAxisAngle(rotAxis, rad));
+	}
+
+	/**
+	 * @brief OpenGL perspective projection (right-handed, clip z in [-w, w]).
+	 */
+	template <class T>
+	constexpr Mat<T, 4, 4> perspective(T fov, T aspect, T near, T far) {
+		Mat<T, 4, 4> perspectiveMatrix;
+
+		T tan_half_angle = ct::tan(fov / 2);
+
+		perspectiveMatrix[0][0] = 1 / (aspect * tan_half_angle);
+		perspectiveMatrix[1][1] = 1 / tan_half_angle;
+		perspectiveMatrix[2][2] = -(far + near) / (far - near);
+		perspectiveMatrix[2][3] = -(2 * far * near) / (far - near);
+		perspectiveMatrix[3][2] = -1;
+		return perspectiveMatrix;
+	}
+
+	/**
+	 * @brief View matrix of a camera at eye looking at center.
+	 */
+	template <class T>
+	constexpr Mat<T, 4, 4> lookAt(const Vec<T, 3> &eye, const Vec<T, 3> &center, const Vec<T, 3> &up) {
+		Vec<T, 3> f = center - eye;
+		f = f * (static_cast<T>(1.0) / ct::sqrt(Vec<T, 3>::dot(f, f)));
+		Vec<T, 3> s = Vec<T, 3>::cross(f, up);
+		s = s * (static_cast<T>(1.0) / ct::sqrt(Vec<T, 3>::dot(s, s)));
+		Vec<T, 3> u = Vec<T, 3>::cross(s, f);
+
+		Mat<T, 4, 4> view = Mat<T, 4, 4>::identity();
+		for (size_t j = 0; j < 3; ++j) {
+			view[0][j] = s[j];
+			view[1][j] = u[j];
+			view[2][j] = -f[j];
+		}
+		view[0][3] = -Vec<T, 3>::dot(s, eye);
+		view[1][3] = -Vec<T, 3>::dot(u, eye);
+		view[2][3] = Vec<T, 3>::dot(f, eye);
+		return view;
+	}
+
+	// Compile-time checks: each of these only compiles if the expression is
+	// evaluated during translation.
+	static_assert(ct::sqrt(16.0) == 4.0);
+	static_assert(ct::sin(0.0) == 0.0 && ct::cos(0.0) == 1.0);
+	static_assert(ct::tan(M_PI / 4) - 1.0 < 1e-15 && ct::tan(M_PI / 4) - 1.0 > -1e-15);
+	static_assert(Mat4f::identity() * Mat4f::identity() == Mat4f::identity());
+	static_assert(translate(Mat4d::identity(), Vec3d(1.0, 2.0, 3.0))[1][3] == 2.0);
+	static_assert((scale(Mat4f::identity(), Vec3f(2.0f, 3.0f, 4.0f)) * Vec4f(1.0f, 1.0f, 1.0f, 1.0f))['z'] == 4.0f);
+	static_assert(inverse(translate(Mat4d::identity(), Vec3d(1.0, 2.0, 3.0)))
+		== translate(Mat4d::identity(), Vec3d(-1.0, -2.0, -3.0)));
+	static_assert(lookAt(Vec3d(0.0, 0.0, 10.0), Vec3d(0.0, 0.0, 0.0), Vec3d(0.0, 1.0, 0.0))
+		== translate(Mat4d::identity(), Vec3d(0.0, 0.0, -10.0)));
+	static_assert(perspective(radians(90.0), 1.0, 1.0, 3.0)[3][2] == -1.0
+		&& perspective(radians(90.0), 1.0, 1.0, 3.0)[2][2] == -2.0);
+} // namespace rt
+
+#endif // !RT_TRANSFORM_HPP
@@ -0,0 +1,212 @@
+#ifndef RT_VEC_HPP
+#define RT_VEC_HPP
+
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include "rt_vector.hpp"
+
+namespace rt
+{
+	/**
+	 * Fixed-size vector with inline storage. Same interface as RTVector but
+	 * the dimension is a template parameter, so nothing is heap-allocated.
+	 * Everything except norm/normalize (std::sqrt) is constexpr.
+	 */
+	template <class T, size_t N>
+	class Vec
+	{
+		static_assert(N > 0, "Vec dimension must be positive");
+
+	private:
+		T data[N];
+
+	public:
+		constexpr Vec() {
+			for (size_t i = 0; i < N; ++i)
+				this->data[i] = static_cast<T>(0.0);
+		};
+		constexpr explicit Vec(const T *x) {
+			for (size_t i = 0; i < N; ++i)
+				this->data[i] = x[i];
+		};
+		constexpr Vec(T x, T y) {
+			static_assert(N == 2, "Vec(x, y) needs a 2d vector");
+			this->data[0] = x;
+			this->data[1] = y;
+		};
+		constexpr Vec(T x, T y, T z) {
+			static_assert(N == 3, "Vec(x, y, z) needs a 3d vector");
+			this->data[0] = x;
+			this->data[1] = y;
+			this->data[2] = z;
+		};
+		constexpr Vec(T x, T y, T z, T w) {
+			static_assert(N == 4, "Vec(x, y, z, w) needs a 4d vector");
+			this->data[0] = x;
+			this->data[1] = y;
+			this->data[2] = z;
+			this->data[3] = w;
+		};
+		/**
+		 * @brief Element type conversion, e.g. a double world position to float.
+		 */
+		template <class U>
+		constexpr explicit Vec(const Vec<U, N>& rhs) {
+			for (size_t i = 0; i < N; ++i)
+				this->data[i] = static_cast<T>(rhs[i]);
+		};
+		explicit Vec(const RTVector<T>& rhs) {
+			if (rhs.getDims() != N)
+				throw std::invalid_argument("Vector dimensions do not match!");
+			for (size_t i = 0; i < N; ++i)
+				this->data[i] = rhs[i];
+		};
+
+		RTVector<T> toRTVector() const {
+			T *result = new T[N];
+			for (size_t i = 0; i < N; ++i)
+				result[i] = this->data[i];
+			return (RTVector<T>(result, N));
+		};
+
+		constexpr T* getData() {
+			return this->data;
+		};
+		constexpr const T* getData() const {
+			return this->data;
+		};
+
+		static constexpr size_t getDims() {
+			return N;
+		};
+
+		T norm() const {
+			return std::sqrt(dot(*this, *this));
+		};
+		Vec<T, N> get_normalized() const {
+			Vec<T, N> result(*this);
+			result.normalize();
+			return (result);
+		};
+		void normalize() {
+			T norm = this->norm();
+			if (norm == static_cast<T>(0.0))
+				throw std::runtime_error("try to normalize zero vector!");
+			T inv = static_cast<T>(1.0) / norm;
+			for (size_t i = 0; i < N; ++i)
+				this->data[i] *= inv;
+		};
+
+		constexpr T& operator[] (char c) {
+			return (this->data[component(c)]);
+		};
+		constexpr const T& operator[] (char c) const {
+			return (this->data[component(c)]);
+		};
+		constexpr T& operator[] (int i) {
+			return (this->data[i]);
+		};
+		constexpr const T& operator[] (int i) const {
+			return (this->data[i]);
+		};
+		constexpr T& operator[] (size_t i) {
+			return (this->data[i]);
+		};
+		constexpr const T& operator[] (size_t i) const {
+			return (this->data[i]);
+		};
+
+		constexpr Vec<T, N> operator+ (const Vec<T, N>& rhs) const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = this->data[i] + rhs.data[i];
+			return (result);
+		};
+		constexpr Vec<T, N> operator- (const Vec<T, N>& rhs) const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = this->data[i] - rhs.data[i];
+			return (result);
+		};
+		constexpr Vec<T, N> operator* (const Vec<T, N>& rhs) const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = this->data[i] * rhs.data[i];
+			return (result);
+		};
+		constexpr Vec<T, N> operator* (const T& rhs) const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = this->data[i] * rhs;
+			return (result);
+		};
+		constexpr Vec<T, N> operator/ (const T& rhs) const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = this->data[i] / rhs;
+			return (result);
+		};
+		constexpr Vec<T, N> operator- () const {
+			Vec<T, N> result;
+			for (size_t i = 0; i < N; ++i)
+				result.data[i] = -this->data[i];
+			return (result);
+		};
+
+		static constexpr T dot(const Vec<T, N> &a, const Vec<T, N> &b) {
+			T sum = static_cast<T>(0.0);
+			for (size_t i = 0; i < N; ++i)
+				sum += a.data[i] * b.data[i];
+			return (sum);
+		};
+		static constexpr Vec<T, N> cross(const Vec<T, N> &a, const Vec<T, N> &b) {
+			static_assert(N == 3, "The cross-product can only be computed for 3d vectors!");
+			return Vec<T, N>(
+				(a.data[1] * b.data[2]) - (a.data[2] * b.data[1]),
+				(a.data[2] * b.data[0]) - (a.data[0] * b.data[2]),
+				(a.data[0] * b.data[1]) - (a.data[1] * b.data[0])
+			);
+		};
+
+	private:
+		static constexpr size_t component(char c) {
+			size_t i = N;
+			if (c == 'x')
+				i = 0;
+			else if (c == 'y')
+				i = 1;
+			else if (c == 'z')
+				i = 2;
+			else if (c == 'w')
+				i = 3;
+			if (i >= N)
+				throw std::runtime_error("Value is out of range!");
+			return (i);
+		};
+	};
+
+	template <class T, size_t N>
+	constexpr Vec<T, N> operator* (const T &lhs, const Vec<T, N> &rhs) {
+		return (rhs * lhs);
+	};
+
+	template <class T, size_t N>
+	std::ostream& operator<<(std::ostream& os, const Vec<T, N>& vec) {
+		os << "[ ";
+		for (size_t i = 0; i < N; i++) {
+			os << vec[i] << " ";
+		}
+		os << "]";
+		return os;
+	}
+
+	typedef Vec<float, 2>	Vec2f;
+	typedef Vec<float, 3>	Vec3f;
+	typedef Vec<float, 4>	Vec4f;
+	typedef Vec<double, 3>	Vec3d;
+	typedef Vec<double, 4>	Vec4d;
+} // namespace rt
+
+#endif // !RT_VEC_HPP
@@ -6,8 +6,32 @@
 
 namespace rt
 {
+	/**
+	 * Expression-template base. a + b * s - c builds a tree of lightweight
+	 * nodes; the loop runs once, element by element, when the tree is
+	 * assigned to (or used to construct) an RTVector, so no intermediate
+	 * vector is allocated. Only element-wise operations are expressed, so
+	 * v = v + w is safe.
+	 */
+	template <class T, class E>
+	class RTVectorExpr
+	{
+	public:
+		typedef T value_type;
+
+		const E& self() const {
+			return static_cast<const E&>(*this);
+		};
+		size_t getDims() const {
+			return self().getDims();
+		};
+		T eval(size_t i) const {
+			return self().eval(i);
+		};
+	};
+
 	template <class T>
-	class RTVector
+	class RTVector : public RTVectorExpr<T, RTVector<T> >
 	{
 	private:
 		T *data;
@@ -54,18 +78,67 @@ namespace rt
 			for (size_t i = 0; i < this->dims; ++i)
 				this->data[i] = rhs.data[i];
 		};
+		RTVector(RTVector<T>&& rhs) noexcept {
+			this->data = rhs.data;
+			this->dims = rhs.dims;
+			rhs.data = NULL;
+			rhs.dims = 0;
+		};
 		RTVector<T>& operator= (const RTVector<T>& rhs) {
-			if (this->data == NULL)
-				this->data = new T[rhs.dims];
+			if (this == &rhs)
+				return (*this);
+			// same size: reuse the buffer, otherwise copy-and-swap
+			if (this->dims == rhs.dims && this->data != NULL) {
+				for (size_t i = 0; i < this->dims; ++i)
+					this->data[i] = rhs.data[i];
+				return (*this);
+			}
+			RTVector<T> copy(rhs);
+			swap(copy);
+			return (*this);
+		};
+		RTVector<T>& operator= (RTVector<T>&& rhs) noexcept {
+			swap(rhs);
+			return (*this);
+		};
+
+		void swap(RTVector<T>& rhs) noexcept {
+			T *tempData = this->data;
+			size_t tempDims = this->dims;
+			this->data = rhs.data;
 			this->dims = rhs.dims;
+			rhs.data = tempData;
+			rhs.dims = tempDims;
+		};
+		template <class E>
+		RTVector(const RTVectorExpr<T, E>& expr) {
+			this->dims = expr.getDims();
+			this->data = new T[this->dims];
 			for (size_t i = 0; i < this->dims; ++i)
-				this->data[i] = rhs.data[i];
+				this->data[i] = expr.eval(i);
+		};
+		template <class E>
+		RTVector<T>& operator= (const RTVectorExpr<T, E>& expr) {
+			if (this->dims != expr.getDims() || this->data == NULL) {
+				RTVector<T> result(expr);
+				swap(result);
+				return (*this);
+			}
+			for (size_t i = 0; i < this->dims; ++i)
+				this->data[i] = expr.eval(i);
 			return (*this);
 		};
 
+		T eval(size_t i) const {
+			return (this->data[i]);
+		};
+
         T* getData() {
             return data;
         }
+        const T* getData() const {
+            return data;
+        }
 
 		size_t getDims() const {
 			return this->dims;
@@ -81,7 +154,7 @@ namespace rt
 			T norm = this->norm();
 			if (norm == static_cast<T>(0.0))
 				throw std::runtime_error("try to normalize zero vector!");
-			return RTVector<T>(*this) * (static_cast<T>(1.0) / norm);
+			return RTVector<T>((*this) * (static_cast<T>(1.0) / norm));
 		};
 		void normalize() {
 			T norm = this->norm();
@@ -131,38 +204,13 @@ namespace rt
 			return (this->data[i]);
 		};
 
-		RTVector<T> operator+ (const RTVector<T> rhs) const {
-			if (this->dims != rhs.dims)
-				throw std::invalid_argument("Vector dimensions do not match!");
-			T* result = new T[this->dims];
-			for (size_t i = 0; i < dims; ++i)
-				result[i] = this->data[i] + rhs.data[i];
-			return (RTVector<T>(result, this->dims));
-		};
-		RTVector<T> operator- (const RTVector<T> rhs) const {
-			if (this->dims != rhs.dims)
-				throw std::invalid_argument("Vector dimensions do not match!");
-			T* result = new T[this->dims];
-			for (size_t i = 0; i < dims; ++i)
-				result[i] = this->data[i] - rhs.data[i];
-			return (RTVector<T>(result, this->dims));
-		};
-		RTVector<T> operator* (const RTVector<T> rhs) const {
-			if (this->dims != rhs.dims)
-				throw std::invalid_argument("Vector dimensions do not match!");
-			T* result = new T[this->dims];
-			for (size_t i = 0; i < dims; ++i)
-				result[i] = this->data[i] * rhs.data[i];
-			return (RTVector<T>(result, this->dims));
-		};
-
-
-		static T dot(const RTVector<T> &a, const RTVector<T> &b) {
-			if (a.dims != b.dims)
+		template <class A, class B>
+		static T dot(const RTVectorExpr<T, A> &a, const RTVectorExpr<T, B> &b) {
+			if (a.getDims() != b.getDims())
 				throw std::invalid_argument("Vector dimensions do not match!");
 			T sum = static_cast<T>(0.0);
-			for (size_t i = 0; i < a.dims; ++i)
-				sum += a[i] * b[i];
+			for (size_t i = 0; i < a.getDims(); ++i)
+				sum += a.eval(i) * b.eval(i);
 			return (sum);
 		};
 		static RTVector<T> cross(const RTVector<T> &a, const RTVector<T> &b) {
@@ -177,62 +225,109 @@ namespace rt
 			result[2] = (a.data[0] * b.data[1]) - (a.data[1] * b.data[0]);
 			return (RTVector<T>(result, 3));
 		};
+	};
 
+	/**
+	 * Leaves (RTVector) are held by reference, inner nodes by value, so a
+	 * tree stays valid for as long as the vectors it was built from.
+	 */
+	template <class E>
+	struct RTVectorExprRef {
+		typedef const E type;
+	};
+	template <class T>
+	struct RTVectorExprRef<RTVector<T> > {
+		typedef const RTVector<T>& type;
+	};
+
+	struct RTVectorAdd { template <class T> static T apply(T a, T b) { return a + b; } };
+	struct RTVectorSub { template <class T> static T apply(T a, T b) { return a - b; } };
+	struct RTVectorMul { template <class T> static T apply(T a, T b) { return a * b; } };
+	struct RTVectorDiv { template <class T> static T apply(T a, T b) { return a / b; } };
 
-		template <class U>
-		friend RTVector<U> operator* (const U &lhs, const RTVector<U> &rhs);
-		template <class U>
-		friend RTVector<U> operator* (const RTVector<U> &rhs, const U &lhs);
-		template <class U>
-		friend RTVector<U> operator/ (const U &lhs, const RTVector<U> &rhs);
-		template <class U>
-		friend RTVector<U> operator/ (const RTVector<U> &rhs, const U &lhs);
+	template <class T, class L, class R, class Op>
+	class RTVectorBinary : public RTVectorExpr<T, RTVectorBinary<T, L, R, Op> >
+	{
+	private:
+		typename RTVectorExprRef<L>::type lhs;
+		typename RTVectorExprRef<R>::type rhs;
 
-		template <class U>
-		friend std::ostream& operator<<(std::ostream& os, const RTVector<U>& vec);
+	public:
+		RTVectorBinary(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {
+			if (lhs.getDims() != rhs.getDims())
+				throw std::invalid_argument("Vector dimensions do not match!");
+		};
+		size_t getDims() const {
+			return lhs.getDims();
+		};
+		T eval(size_t i) const {
+			return Op::apply(lhs.eval(i), rhs.eval(i));
+		};
 	};
 
-	template <class U>
-	RTVector<U> operator* (const U &lhs, const RTVector<U> &rhs)
+	template <class T, class E, class Op>
+	class RTVectorScalar : public RTVectorExpr<T, RTVectorScalar<T, E, Op> >
 	{
-		U* result = new U[rhs.dims];
-		for (size_t i = 0; i < rhs.dims; ++i)
-			result[i] = rhs.data[i] * lhs;
-		return (RTVector<U>(result, rhs.dims));
+	private:
+		typename RTVectorExprRef<E>::type vec;
+		T scalar;
+
+	public:
+		RTVectorScalar(const E& vec, T scalar) : vec(vec), scalar(scalar) {};
+		size_t getDims() const {
+			return vec.getDims();
+		};
+		T eval(size_t i) const {
+			return Op::apply(vec.eval(i), scalar);
+		};
 	};
 
-	template <class U>
-	RTVector<U> operator* (const RTVector<U> &rhs, const U &lhs)
-	{
-		U* result = new U[rhs.dims];
-		for (size_t i = 0; i < rhs.dims; ++i)
-			result[i] = rhs.data[i] * lhs;
-		return (RTVector<U>(result, rhs.dims));
+	template <class T, class L, class R>
+	RTVectorBinary<T, L, R, RTVectorAdd> operator+ (const RTVectorExpr<T, L> &lhs, const RTVectorExpr<T, R> &rhs) {
+		return RTVectorBinary<T, L, R, RTVectorAdd>(lhs.self(), rhs.self());
 	};
 
-	template <class U>
-	RTVector<U> operator/ (const U &lhs, const RTVector<U> &rhs)
-	{
-		U* result = new U[rhs.dims];
-		for (size_t i = 0; i < rhs.dims; ++i)
-			result[i] = rhs.data[i] / lhs;
-		return (RTVector<U>(result, rhs.dims));
+	template <class T, class L, class R>
+	RTVectorBinary<T, L, R, RTVectorSub> operator- (const RTVectorExpr<T, L> &lhs, const RTVectorExpr<T, R> &rhs) {
+		return RTVectorBinary<T, L, R, RTVectorSub>(lhs.self(), rhs.self());
 	};
 
-	template <class U>
-	RTVector<U> operator/ (const RTVector<U> &rhs, const U &lhs)
-	{
-		U* result = new U[rhs.dims];
-		for (size_t i = 0; i < rhs.dims; ++i)
-			result[i] = rhs.data[i] / lhs;
-		return (RTVector<U>(result, rhs.dims));
+	template <class T, class L, class R>
+	RTVectorBinary<T, L, R, RTVectorMul> operator* (const RTVectorExpr<T, L> &lhs, const RTVectorExpr<T, R> &rhs) {
+		return RTVectorBinary<T, L, R, RTVectorMul>(lhs.self(), rhs.self());
+	};
+
+	template <class T, class E>
+	RTVectorScalar<T, E, RTVectorMul> operator* (const typename RTVectorExpr<T, E>::value_type &lhs, const RTVectorExpr<T, E> &rhs) {
+		return RTVectorScalar<T, E, RTVectorMul>(rhs.self(), lhs);
 	};
 
-	template <class U>
-	std::ostream& operator<<(std::ostream& os, const RTVector<U>& vec) {
+	template <class T, class E>
+	RTVectorScalar<T, E, RTVectorMul> operator* (const RTVectorExpr<T, E> &rhs, const typename RTVectorExpr<T, E>::value_type &lhs) {
+		return RTVectorScalar<T, E, RTVectorMul>(rhs.self(), lhs);
+	};
+
+	// scalar / vector divides each element by the scalar, as before
+	template <class T, class E>
+	RTVectorScalar<T, E, RTVectorDiv> operator/ (const typename RTVectorExpr<T, E>::value_type &lhs, const RTVectorExpr<T, E> &rhs) {
+		return RTVectorScalar<T, E, RTVectorDiv>(rhs.self(), lhs);
+	};
+
+	template <class T, class E>
+	RTVectorScalar<T, E, RTVectorDiv> operator/ (const RTVectorExpr<T, E> &rhs, const typename RTVectorExpr<T, E>::value_type &lhs) {
+		return RTVectorScalar<T, E, RTVectorDiv>(rhs.self(), lhs);
+	};
+
+	template <class T>
+	void swap(RTVector<T>& x, RTVector<T>& y) noexcept {
+		x.swap(y);
+	}
+
+	template <class U, class E>
+	std::ostream& operator<<(std::ostream& os, const RTVectorExpr<U, E>& vec) {
 		os << "[ ";
 		for (size_t i = 0; i < vec.getDims(); i++) {
-			os << vec[i] << " ";
+			os << vec.eval(i) << " ";
 		}
 		os << "]";
 		return os;
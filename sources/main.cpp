@@ -4,84 +4,23 @@
 #include <iostream>
 #include <cmath>
 #include <limits>
+#include <cstring>
+#include <cstdlib>
 #include "texture_loader.hpp"
+#include "model.hpp"
 #include "rt_vector.hpp"
 #include "rt_matrix.hpp"
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+#include "rt_quaternion.hpp"
+#include "rt_transform.hpp"
+#include "rt_frustum.hpp"
+#include "rt_relative.hpp"
 #include "Vector.hpp"
+#include "SmallVector.hpp"
 #include "Pair.hpp"
-
-rt::RTMatrix<float> translate(
-	rt::RTMatrix<float> matrix,
-	rt::RTVector<float> transVector
-) {
-	rt::RTMatrix<float> identityMatrix(4, 4);
-	identityMatrix.toIdentity();
-
-	identityMatrix[0][3] = transVector['x'];
-	identityMatrix[1][3] = transVector['y'];
-	identityMatrix[2][3] = transVector['z'];
-
-	return matrix * identityMatrix;
-}
-
-rt::RTMatrix<float> rotate(
-	rt::RTMatrix<float> matrix,
-	float rad,
-	rt::RTVector<float> rotAxis
-) {
-	rt::RTMatrix<float> iMat(4, 4);
-	iMat.toIdentity();
-
-	iMat[0][0] = cos(rad) + rotAxis['x'] * rotAxis['x'] * (1 - cos(rad));
-	iMat[1][0] = rotAxis['y'] * rotAxis['x'] * (1 - cos(rad)) + rotAxis['z'] * sin(rad);
-	iMat[2][0] = rotAxis['z'] * rotAxis['x'] * (1 - cos(rad)) - rotAxis['y'] * sin(rad);
-
-	iMat[0][1] = rotAxis['x'] * rotAxis['y'] * (1 - cos(rad)) - rotAxis['z'] * sin(rad);
-	iMat[1][1] = cos(rad) + rotAxis['y'] * rotAxis['y'] * (1 - cos(rad));
-	iMat[2][1] = rotAxis['z'] * rotAxis['y'] * (1 - cos(rad)) + rotAxis['x'] * sin(rad);
-
-	iMat[0][2] = rotAxis['x'] * rotAxis['z'] * (1 - cos(rad)) + rotAxis['y'] * sin(rad);
-	iMat[1][2] = rotAxis['y'] * rotAxis['z'] * (1 - cos(rad)) - rotAxis['x'] * sin(rad);
-	iMat[2][2] = cos(rad) + rotAxis['z'] * rotAxis['z'] * (1 - cos(rad));
-
-	return matrix * iMat;
-}
-
-rt::RTMatrix<float> scale(
-	rt::RTMatrix<float> matrix,
-	rt::RTVector<float> scaleVector
-) {
-	rt::RTMatrix<float> identityMatrix(4, 4);
-	identityMatrix.toIdentity();
-
-	identityMatrix[0][0] = scaleVector['x'];
-	identityMatrix[1][1] = scaleVector['y'];
-	identityMatrix[2][2] = scaleVector['z'];
-	return matrix * identityMatrix;
-}
-
-float radians(float angle) {
-	return angle * M_PI / 180;
-}
-
-rt::RTMatrix<float> perspective(
-	float fov,
-	float aspect,
-	float near,
-	float far
-) {
-	rt::RTMatrix<float> perspectiveMatrix(4, 4);
-
-	float tan_half_angle = tan(fov / 2);
-
-	perspectiveMatrix[0][0] = 1 / (aspect * tan_half_angle);
-	perspectiveMatrix[1][1] = 1 / tan_half_angle;
-	perspectiveMatrix[2][2] = -(far + near) / (far - near);
-	perspectiveMatrix[2][3] = -(2 * far * near) / (far - near);
-	perspectiveMatrix[3][2] = -1;
-
-	return perspectiveMatrix;
-}
+#include "StringView.hpp"
+#include "mapped_file.hpp"
 
 int	ft_isdigit(int c)
 {
@@ -90,35 +29,32 @@ int	ft_isdigit(int c)
 	return (0);
 }
 
-int	ft_atoi(const char *str)
+int	ft_atoi(ft::StringView str)
 {
 	long long int	num;
 	int				minus;
 
 	minus = 1;
-	while (*str == '\f' || *str == '\v' || *str == ' '
-		|| *str == '\t' || *str == '\n' || *str == '\r')
-		str++;
-	if (*str == '-')
+	str = str.trim_left();
+	if (str.starts_with('-'))
 	{
 		minus = -1;
-		str++;
+		str.remove_prefix(1);
 	}
-	else if (*str == '+')
-		str++;
+	else if (str.starts_with('+'))
+		str.remove_prefix(1);
 	num = 0;
-	while (*str != '\0')
+	for (size_t i = 0; i < str.size(); i++)
 	{
-		if (*str < '0' || *str > '9')
+		if (str[i] < '0' || str[i] > '9')
 			break ;
-		num += *str - '0';
+		num += str[i] - '0';
 		num *= 10;
-		str++;
 	}
 	return (num / 10 * minus);
 }
 
-float	ft_atof(const char *str)
+float	ft_atof(ft::StringView str)
 {
 	int		n;
 	float	d;
@@ -126,17 +62,17 @@ float	ft_atof(const char *str)
 	int		sign;
 
 	sign = 1;
-	if (str[0] == '-' && str[1] == '0')
+	if (str.starts_with("-0"))
 		sign = -1;
 	d = 0;
 	len = 0;
 	n = ft_atoi(str);
-	while (ft_isdigit(*str) || *str == '-')
-		str++;
-	if (*str == '.')
+	while (!str.empty() && (ft_isdigit(str.front()) || str.front() == '-'))
+		str.remove_prefix(1);
+	if (str.starts_with('.'))
 	{
-		str++;
-		while (ft_isdigit(str[len]))
+		str.remove_prefix(1);
+		while (len < (int)str.size() && ft_isdigit(str[len]))
 			len++;
 		d = ft_atoi(str);
 	}
@@ -147,7 +83,7 @@ float	ft_atof(const char *str)
 	return (((double)n + d) * sign);
 }
 
-bool isNumber(ft::String str) {
+bool isNumber(ft::StringView str) {
 	for (auto it = str.begin(); it != str.end(); it++) {
 		if (!ft_isdigit(*it)) {
 			return false;
@@ -162,12 +98,13 @@ bool loadOBJ(
 	ft::Vector<int> &outVertexIndices,
     rt::RTVector<float> &center
 ) {
-	std::ifstream file;
-	file.open(path, std::ios::in | std::ios::binary);
+	// tokens are views into the mapped file, nothing is copied
+	Scop::MappedFile file(path);
 
-	if (!file.is_open()) {
+	if (!file.isOpen()) {
 		return false;
 	}
+	ft::Tokenizer tokens(file.getView());
 
     rt::RTVector<float> min(
             std::numeric_limits<float>::max(),
@@ -180,51 +117,53 @@ bool loadOBJ(
             std::numeric_limits<float>::min()
     );
 
-    ft::String tempStr;
-    file >> tempStr;
+    ft::StringView tempStr;
+    bool good = tokens.next(tempStr);
     float red = 0.0f;
     float green = 0.0f;
     float blue = 0.0f;
     size_t counter = 0;
-	while (file) {
+	while (good) {
 		if (tempStr == "v") {
-			file >> tempStr;
-            float x = ft_atof(tempStr.c_str());
-            outVertices.push_back(x);
+			tokens.next(tempStr);
+            float x = ft_atof(tempStr);
             min['x'] = x < min['x'] ? x : min['x'];
             max['x'] = x > max['x'] ? x : max['x'];
-			file >> tempStr;
-            float y = ft_atof(tempStr.c_str());
-            outVertices.push_back(y);
+			tokens.next(tempStr);
+            float y = ft_atof(tempStr);
             min['y'] = y < min['y'] ? y : min['y'];
             max['y'] = y > max['y'] ? y : max['y'];
-			file >> tempStr;
-            float z = ft_atof(tempStr.c_str());
-            outVertices.push_back(z);
+			tokens.next(tempStr);
+            float z = ft_atof(tempStr);
             min['z'] = z < min['z'] ? z : min['z'];
             max['z'] = z > max['z'] ? z : max['z'];
-            file >> tempStr;
+            good = tokens.next(tempStr);
 
             red = sin(counter) / 2.0f + 0.5f;
             green = cos(counter) / 2.0f + 0.5f;
             blue = tan(counter) / 2.0f + 0.5f;
-            outVertices.push_back(red);
-            outVertices.push_back(green);
-            outVertices.push_back(blue);
+            float *vertex = outVertices.append_uninitialized(6);
+            vertex[0] = x;
+            vertex[1] = y;
+            vertex[2] = z;
+            vertex[3] = red;
+            vertex[4] = green;
+            vertex[5] = blue;
             counter++;
 		} else if (tempStr == "f") {
-            ft::Vector<float> tempVector;
-			while (file >> tempStr && isNumber(tempStr)) {
-                tempVector.push_back(ft_atoi(tempStr.c_str()) - 1);
+            ft::SmallVector<int, 3> tempVector;
+			while ((good = tokens.next(tempStr)) && isNumber(tempStr)) {
+                tempVector.push_back(ft_atoi(tempStr) - 1);
                 if (tempVector.size() == 3) {
-                    outVertexIndices.push_back(tempVector[0]);
-                    outVertexIndices.push_back(tempVector[1]);
-                    outVertexIndices.push_back(tempVector[2]);
+                    int *triangle = outVertexIndices.append_uninitialized(3);
+                    triangle[0] = tempVector[0];
+                    triangle[1] = tempVector[1];
+                    triangle[2] = tempVector[2];
                     tempVector.erase(tempVector.begin() + 1);
                 }
 			}
 		} else {
-            file >> tempStr;
+            good = tokens.next(tempStr);
         }
 	}
     center = rt::RTVector(
@@ -245,13 +184,63 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-void processInput(GLFWwindow *window)
+void processInput(GLFWwindow *window, rt::Quatf &orbit)
 {
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
+
+    // Arrow keys orbit the camera: yaw around the world Y axis, pitch
+    // around the camera's own X axis.
+    const float step = rt::radians(1.5f);
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+        yaw -= step;
+    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+        yaw += step;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        pitch -= step;
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+        pitch += step;
+    if (yaw != 0.0f)
+        orbit = rt::Quatf::fromAxisAngle(rt::Vec3f(0.0f, 1.0f, 0.0f), yaw) * orbit;
+    if (pitch != 0.0f)
+        orbit = orbit * rt::Quatf::fromAxisAngle(rt::Vec3f(1.0f, 0.0f, 0.0f), pitch);
+    orbit.normalize();
 }
 
-int main() {
+// "X,Y,Z" in double, float would already round 1e7 coordinates to a meter
+bool parseOrigin(const char *str, rt::Vec3d &origin)
+{
+    char *end;
+    for (size_t i = 0; i < 3; ++i) {
+        origin[i] = std::strtod(str, &end);
+        if (end == str || *end != (i < 2 ? ',' : '\0'))
+            return false;
+        str = end + 1;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+	Scop::ResidencyPolicy residency = Scop::RESIDENCY_DROP;
+	// world position of the model, e.g. georeferenced coordinates
+	rt::Vec3d origin(0.0, 0.0, 0.0);
+	for (int i = 1; i < argc; ++i) {
+		if (strncmp(argv[i], "--origin=", 9) == 0 && parseOrigin(argv[i] + 9, origin))
+			continue;
+		if (strncmp(argv[i], "--residency=", 12) != 0) {
+			std::cerr << "Usage: " << argv[0] << " [--residency=keep|drop|picking] [--origin=X,Y,Z]" << std::endl;
+			return (-1);
+		}
+		try {
+			residency = Scop::parseResidencyPolicy(argv[i] + 12);
+		} catch (std::exception &e) {
+			std::cerr << e.what() << std::endl;
+			return (-1);
+		}
+	}
+
 /////////////////////////Window/////////////////////////////////////////////////
 	if (!glfwInit()) {
 		std::cerr << "GLFW initialization failed" << std::endl;
@@ -407,72 +396,13 @@ int main() {
 
 //////////////////////////Load obj///////////////////////////////////////////////
 
-	ft::Vector<float> vertices;
-	ft::Vector<int> indices;
-    rt::RTVector<float> center;
-
-	loadOBJ("models/42.obj", vertices, indices, center);
-
-//	for (auto it = vertices.begin(); it != vertices.end(); it++) {
-//		std::cout << *it << std::endl;
-//	}
-//	for (auto it = indices.begin(); it != indices.end(); it++) {
-//        std::cout << *it << ' ';
-//	}
-//    std::cout << std::endl;
-
-////////////////////////////////////////////////////////////////////////////////
-
-	// float vertices[] = {
-	// 	-0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		0.0f, 0.0f,
-	// 	0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		1.0f, 0.0f,
-	// 	0.0f, 0.5f, 0.0f,		0.0f, 0.0f, 0.0f,		0.5f, 1.0f,
-
-	// 	0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		0.0f, 0.0f,
-	// 	0.0f, -0.5f, -0.577f,	0.0f, 0.0f, 0.0f,		1.0f, 0.0f,
-	// 	0.0f, 0.5f, 0.0f,		0.0f, 0.0f, 0.0f,		0.5f, 1.0f,
-
-	// 	0.0f, -0.5f, -0.577f,	0.0f, 0.0f, 0.0f,		0.0f, 0.0f,
-	// 	-0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		1.0f, 0.0f,
-	// 	0.0f, 0.5f, 0.0f,		0.0f, 0.0f, 0.0f,		0.5f, 1.0f,
-
-	// 	-0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		0.0f, 0.0f,
-	// 	0.5f, -0.5f, 0.28867f,	0.0f, 0.0f, 0.0f,		1.0f, 0.0f,
-	// 	0.0f, -0.5f, -0.577f,	0.0f, 0.0f, 0.0f,		0.5f, 1.0f,
-	// };
+	Scop::Model object("models/42.obj");
 
-	unsigned int VBO;
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+	loadOBJ("models/42.obj", object.vertices, object.indices, object.center);
+	object.upload(residency);
 
-	unsigned int VAO;
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	// unsigned int indices[] = {
-	// 	0, 1, 2,
-	// 	3, 4, 5,
-	// 	6, 7, 8,
-	// 	9, 10, 11
-	// };
-
-	unsigned int EBO;
-	glGenBuffers(1, &EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int), &indices[0], GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
-
-	 glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-	 glEnableVertexAttribArray(1);
-
-	// glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-	// glEnableVertexAttribArray(2);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+	std::cout << "Geometry residency: " << Scop::residencyPolicyName(object.getResidency()) << std::endl;
+	std::cout << object.memoryReport() << std::endl;
 
 	// glUseProgram(shaderProgram);
 	// glUniform1i(glGetUniformLocation(shaderProgram, "texture"), 0);
@@ -480,14 +410,17 @@ int main() {
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
 /////////////// Transformation matrix //////////////////////////////////////////
-	float angle = 0;
+	const rt::Quatf spinStep = rt::Quatf::fromAxisAngle(rt::Vec3f(0.0f, 1.0f, 0.0f), rt::radians(1.0f));
+	rt::Quatf spin;
+	rt::Quatf orbit;
+	constexpr rt::Mat4f projection = rt::perspective(rt::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
 	glEnable(GL_DEPTH_TEST);
 
 	while(!glfwWindowShouldClose(window))
 	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		// Input
-		processInput(window);
+		processInput(window, orbit);
 
 		// rendering commands
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -499,40 +432,42 @@ int main() {
 		glUseProgram(shaderProgram);
 
 ///////////////////// Transformation ///////////////////////////////////////////////////////////////////////////////////
-		// Model matrix
-		rt::RTMatrix<float> model(4, 4);
-		model.toIdentity();
-        model = translate(model, rt::RTVector<float>(
-                -center['x'],
-                -center['y'],
-                -center['z']
-        ));
-		model = scale(model, rt::RTVector<float>(1.0f, 1.0f, 1.0f));
-		model = rotate(model, radians(angle), rt::RTVector<float>(0.0f, 1.0f, 0.0f));
-		angle += 1;
+		// Model and view are composed in double around the world origin and
+		// only their camera-relative split is converted to float
+		rt::Mat4d model = rt::Mat4d::identity();
+		model = rt::translate(model, -rt::Vec3d(rt::Vec3f(object.center)));
+		model = rt::scale(model, rt::Vec3d(1.0, 1.0, 1.0));
+		model = rt::Mat4d(spin.toMat4()) * model;
+		model = rt::translate(model, origin);
+		// renormalizing every frame keeps the accumulated spin a pure rotation
+		spin = spinStep * spin;
+		spin.normalize();
+
+		// View matrix
+		rt::Mat4d view = rt::Mat4d::identity();
+		view = rt::translate(view, -origin);
+		view = rt::Mat4d(orbit.conjugate().toMat4()) * view;
+		view = rt::translate(view, rt::Vec3d(0.0, 0.0, -10.0));
+
+		rt::CameraRelative relative = rt::cameraRelative(view, model);
 
 		//glUseProgram(shaderProgram);
 		unsigned int modelLoc = glGetUniformLocation(shaderProgram, "model");
-		glUniformMatrix4fv(modelLoc, 1, GL_TRUE, (model).getData());
-
-		// View matrix
-		rt::RTMatrix<float> view(4, 4);
-		view.toIdentity();
-		view = translate(view, rt::RTVector<float>(0.0f, 0.0f, -10.0f));
+		glUniformMatrix4fv(modelLoc, 1, GL_TRUE, relative.model.getData());
 
 		//glUseProgram(shaderProgram);
 		unsigned int viewLoc = glGetUniformLocation(shaderProgram, "view");
-		glUniformMatrix4fv(viewLoc, 1, GL_TRUE, (view).getData());
-
-		rt::RTMatrix<float> projection = perspective(radians(45), 800.0f / 600.0f, 0.1f, 100.0f);
+		glUniformMatrix4fv(viewLoc, 1, GL_TRUE, relative.view.getData());
 
 		//glUseProgram(shaderProgram);
 		unsigned int projectionLoc = glGetUniformLocation(shaderProgram, "projection");
-		glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, (projection).getData());
+		glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, projection.getData());
 
 		///////////////////////////////////////////////////////////////////////////////
-		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		// skip the draw call when the bounding sphere is outside the view
+		rt::Frustumf frustum = rt::Frustumf::fromMatrix(projection * relative.view * relative.model);
+		if (frustum.intersectsSphere(rt::Vec3f(object.center), object.radius))
+			object.draw();
 		//glDrawArrays(GL_TRIANGLES, 0, 3);
 
 		// check call events and swap
@@ -540,6 +475,7 @@ int main() {
 		glfwPollEvents();
 	}
 
+	object.release();
 	glfwTerminate();
 	return (0);
 }
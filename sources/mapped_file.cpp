@@ -0,0 +1,56 @@
+#include "mapped_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+Scop::MappedFile::MappedFile(const char *path) {
+	this->data = NULL;
+	this->size = 0;
+	this->opened = false;
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+		this->opened = true;
+		this->size = info.st_size;
+		// mmap rejects zero-length maps; an empty file is an empty view
+		if (this->size > 0) {
+			void *map = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map == MAP_FAILED) {
+				this->opened = false;
+				this->size = 0;
+			} else {
+				this->data = static_cast<const char *>(map);
+				madvise(map, this->size, MADV_SEQUENTIAL);
+			}
+		}
+	}
+	close(fd);
+}
+
+Scop::MappedFile::~MappedFile() {
+	if (this->data) {
+		munmap(const_cast<char *>(this->data), this->size);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Scop::MappedFile::isOpen() const {
+	return this->opened;
+}
+
+ft::StringView Scop::MappedFile::getView() const {
+	return ft::StringView(this->data, this->size);
+}
+
+size_t Scop::MappedFile::getSize() const {
+	return this->size;
+}
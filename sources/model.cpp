@@ -0,0 +1,165 @@
+#define GL_SILENCE_DEPRECATION
+#include <glad/glad.hpp>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+#include "model.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+Scop::ResidencyPolicy Scop::parseResidencyPolicy(const char *str) {
+	if (strcmp(str, "keep") == 0)
+		return (RESIDENCY_KEEP);
+	if (strcmp(str, "drop") == 0)
+		return (RESIDENCY_DROP);
+	if (strcmp(str, "picking") == 0)
+		return (RESIDENCY_PICKING);
+	throw std::invalid_argument("Unknown residency policy (keep, drop, picking)");
+}
+
+const char *Scop::residencyPolicyName(ResidencyPolicy policy) {
+	if (policy == RESIDENCY_KEEP)
+		return ("keep");
+	if (policy == RESIDENCY_DROP)
+		return ("drop");
+	return ("picking");
+}
+
+std::ostream& Scop::operator<<(std::ostream& os, const MemoryReport& report) {
+	os << std::left << std::setw(24) << report.name.c_str() << std::right
+		<< " cpu: " << std::setw(10) << report.cpuBytes() << " B"
+		<< " (vertices " << report.cpuVertexBytes
+		<< ", indices " << report.cpuIndexBytes << ")"
+		<< " gpu: " << std::setw(10) << report.gpuBytes() << " B"
+		<< " (vertices " << report.gpuVertexBytes
+		<< ", indices " << report.gpuIndexBytes << ")";
+	return os;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Scop::Model::Model(ft::String name) {
+	this->name = name;
+	this->VAO = 0;
+	this->VBO = 0;
+	this->EBO = 0;
+	this->indexCount = 0;
+	this->radius = 0.0f;
+	this->residency = RESIDENCY_KEEP;
+}
+
+Scop::Model::~Model() {
+	release();
+}
+
+void Scop::Model::upload(ResidencyPolicy policy) {
+	this->indexCount = this->indices.size();
+
+	// the bounding sphere outlives the CPU copy, it is used for culling
+	float cx = this->center.getDims() >= 3 ? this->center['x'] : 0.0f;
+	float cy = this->center.getDims() >= 3 ? this->center['y'] : 0.0f;
+	float cz = this->center.getDims() >= 3 ? this->center['z'] : 0.0f;
+	float maxDist2 = 0.0f;
+	for (size_t i = 0; i + 2 < this->vertices.size(); i += 6) {
+		float dx = this->vertices[i] - cx;
+		float dy = this->vertices[i + 1] - cy;
+		float dz = this->vertices[i + 2] - cz;
+		if (dx * dx + dy * dy + dz * dz > maxDist2)
+			maxDist2 = dx * dx + dy * dy + dz * dz;
+	}
+	this->radius = std::sqrt(maxDist2);
+
+	glGenBuffers(1, &this->VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(this->vertices.size() * sizeof(float)), &this->vertices[0], GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &this->VAO);
+	glBindVertexArray(this->VAO);
+
+	glGenBuffers(1, &this->EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(this->indices.size() * sizeof(int)), &this->indices[0], GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	this->residency = policy;
+	if (policy == RESIDENCY_PICKING) {
+		size_t count = this->vertices.size() / 6;
+		ft::Vector<float> positions;
+		positions.resize_for_overwrite(3 * count);
+		for (size_t i = 0; i < count; ++i) {
+			positions[3 * i] = this->vertices[6 * i];
+			positions[3 * i + 1] = this->vertices[6 * i + 1];
+			positions[3 * i + 2] = this->vertices[6 * i + 2];
+		}
+		this->positions.swap(positions);
+	}
+	if (policy != RESIDENCY_KEEP) {
+		// clear() keeps the capacity, swapping with an empty vector frees it
+		ft::Vector<float> emptyVertices;
+		this->vertices.swap(emptyVertices);
+	}
+	if (policy == RESIDENCY_DROP) {
+		ft::Vector<int> emptyIndices;
+		this->indices.swap(emptyIndices);
+	}
+}
+
+void Scop::Model::draw() const {
+	glBindVertexArray(this->VAO);
+	glDrawElements(GL_TRIANGLES, this->indexCount, GL_UNSIGNED_INT, 0);
+}
+
+void Scop::Model::release() {
+	if (this->VAO)
+		glDeleteVertexArrays(1, &this->VAO);
+	if (this->VBO)
+		glDeleteBuffers(1, &this->VBO);
+	if (this->EBO)
+		glDeleteBuffers(1, &this->EBO);
+	this->VAO = 0;
+	this->VBO = 0;
+	this->EBO = 0;
+}
+
+Scop::MemoryReport Scop::Model::memoryReport() const {
+	MemoryReport report;
+
+	report.name = this->name;
+	report.cpuVertexBytes = (this->vertices.capacity() + this->positions.capacity()) * sizeof(float);
+	report.cpuIndexBytes = this->indices.capacity() * sizeof(int);
+
+	// 64-bit query, GL_BUFFER_SIZE overflows a GLint past 2 GiB
+	GLint64 size = 0;
+	report.gpuVertexBytes = 0;
+	report.gpuIndexBytes = 0;
+	if (this->VBO) {
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+		glGetBufferParameteri64v(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+		report.gpuVertexBytes = size;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	if (this->EBO) {
+		// the element array binding is VAO state, query it through the VAO
+		glBindVertexArray(this->VAO);
+		glGetBufferParameteri64v(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+		report.gpuIndexBytes = size;
+		glBindVertexArray(0);
+	}
+	return (report);
+}
+
+Scop::ResidencyPolicy Scop::Model::getResidency() const {
+	return (this->residency);
+}
+
+size_t Scop::Model::getIndexCount() const {
+	return (this->indexCount);
+}
@@ -10,11 +10,10 @@ Scop::TextureLoader::TextureLoader(ft::String path_to_png) {
 }
 
 void Scop::TextureLoader::readFile(ft::String path) {
-	ft::String::size_type n = path.rfind(".bmp");
+	ft::StringView extension(".bmp");
 
-	if (n == ft::String::npos
-		|| path.length() <= 4
-		|| n + 4 != path.length()
+	if (path.length() <= extension.length()
+		|| !ft::StringView(path).ends_with(extension)
 	) {
 		throw Scop::TextureLoaderException("Wrong format of file: " + path);
 	}
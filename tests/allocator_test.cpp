@@ -0,0 +1,211 @@
+#include <cstring>
+#include "check.hpp"
+#include "ArenaAllocator.hpp"
+#include "List.hpp"
+#include "Map.hpp"
+#include "SmallVector.hpp"
+#include "String.hpp"
+#include "Vector.hpp"
+
+/**
+ * Containers with a stateful allocator: swapping or assigning between one
+ * on an Arena and one on the heap (an ArenaAllocator without an arena) has
+ * to move the allocator along with the storage. Otherwise the heap buffer
+ * is "freed" into the arena and leaks, and the arena buffer is passed to
+ * operator delete, both of which ASan reports.
+ */
+namespace
+{
+	typedef ft::ArenaAllocator<int>								IntAlloc;
+	typedef ft::Vector<int, IntAlloc>							ArenaVector;
+	typedef ft::List<int, IntAlloc>								ArenaList;
+	typedef ft::SmallVector<int, 4, IntAlloc>					ArenaSmallVector;
+	typedef ft::ArenaAllocator<ft::Pair<const int, int> >		PairAlloc;
+	typedef ft::Map<int, int, ft::less<int>, PairAlloc>			ArenaMap;
+	typedef ft::BasicString<char, ft::ArenaAllocator<char> >	ArenaString;
+
+	const char *LONG_TEXT = "long enough to live outside the inline buffer";
+
+	template <class Container>
+	void fill(Container &c, int first, int count) {
+		for (int i = 0; i < count; ++i)
+			c.push_back(first + i);
+	}
+
+	template <class Container>
+	bool holds(const Container &c, int first, int count) {
+		if ((int)c.size() != count)
+			return (false);
+		int expected = first;
+		for (typename Container::const_iterator it = c.begin(); it != c.end(); ++it)
+			if (*it != expected++)
+				return (false);
+		return (true);
+	}
+
+	void testVector(ft::Arena &arena) {
+		{
+			ArenaVector onArena((IntAlloc(arena)));
+			ArenaVector onHeap((IntAlloc()));
+			fill(onArena, 0, 100);
+			fill(onHeap, 1000, 10);
+			onArena.swap(onHeap);
+			CHECK(holds(onArena, 1000, 10));
+			CHECK(holds(onHeap, 0, 100));
+			CHECK(onArena.get_allocator().arena() == NULL);
+			CHECK(onHeap.get_allocator().arena() == &arena);
+			// growing after the swap allocates from the swapped-in allocator
+			fill(onArena, 1010, 200);
+			CHECK(holds(onArena, 1000, 210));
+		}
+		{
+			ArenaVector onArena((IntAlloc(arena)));
+			ArenaVector onHeap((IntAlloc()));
+			fill(onArena, 0, 50);
+			fill(onHeap, 500, 70);
+			onArena = onHeap;
+			CHECK(holds(onArena, 500, 70));
+			CHECK(onArena.get_allocator().arena() == NULL);
+			ArenaVector other((IntAlloc(arena)));
+			fill(other, 7, 3);
+			onHeap = other;
+			CHECK(holds(onHeap, 7, 3));
+			CHECK(onHeap.get_allocator().arena() == &arena);
+			onHeap = onHeap;
+			CHECK(holds(onHeap, 7, 3));
+		}
+		{
+			ArenaVector onArena((IntAlloc(arena)));
+			ArenaVector onHeap((IntAlloc()));
+			fill(onArena, 0, 40);
+			fill(onHeap, 40, 40);
+			onHeap = std::move(onArena);
+			CHECK(holds(onHeap, 0, 40));
+			CHECK(onHeap.get_allocator().arena() == &arena);
+		}
+	}
+
+	void testSmallVector(ft::Arena &arena) {
+		{
+			// both past the inline buffer: the heap blocks trade places
+			ArenaSmallVector onArena((IntAlloc(arena)));
+			ArenaSmallVector onHeap((IntAlloc()));
+			fill(onArena, 0, 20);
+			fill(onHeap, 200, 10);
+			onArena.swap(onHeap);
+			CHECK(holds(onArena, 200, 10));
+			CHECK(holds(onHeap, 0, 20));
+			CHECK(onArena.get_allocator().arena() == NULL);
+			CHECK(onHeap.get_allocator().arena() == &arena);
+			fill(onArena, 210, 100);
+			CHECK(holds(onArena, 200, 110));
+		}
+		{
+			ArenaSmallVector onArena((IntAlloc(arena)));
+			ArenaSmallVector inlineOnHeap((IntAlloc()));
+			fill(onArena, 0, 20);
+			fill(inlineOnHeap, 50, 3);
+			onArena.swap(inlineOnHeap);
+			CHECK(holds(onArena, 50, 3));
+			CHECK(holds(inlineOnHeap, 0, 20));
+			CHECK(inlineOnHeap.get_allocator().arena() == &arena);
+			fill(onArena, 53, 30);
+			CHECK(holds(onArena, 50, 33));
+		}
+	}
+
+	void testList(ft::Arena &arena) {
+		{
+			ArenaList onArena((IntAlloc(arena)));
+			ArenaList onHeap((IntAlloc()));
+			fill(onArena, 0, 30);
+			fill(onHeap, 100, 5);
+			onArena.swap(onHeap);
+			CHECK(holds(onArena, 100, 5));
+			CHECK(holds(onHeap, 0, 30));
+			CHECK(onArena.get_allocator().arena() == NULL);
+			CHECK(onHeap.get_allocator().arena() == &arena);
+			fill(onArena, 105, 20);
+			onArena.pop_front();
+			CHECK(holds(onArena, 101, 24));
+		}
+		{
+			ArenaList onArena((IntAlloc(arena)));
+			ArenaList onHeap((IntAlloc()));
+			fill(onArena, 0, 30);
+			fill(onHeap, 100, 5);
+			onArena = onHeap;
+			CHECK(holds(onArena, 100, 5));
+			CHECK(onArena.get_allocator().arena() == NULL);
+			ArenaList other((IntAlloc(arena)));
+			fill(other, 9, 12);
+			onHeap = other;
+			CHECK(holds(onHeap, 9, 12));
+			CHECK(onHeap.get_allocator().arena() == &arena);
+			onHeap = onHeap;
+			CHECK(holds(onHeap, 9, 12));
+		}
+	}
+
+	void testMap(ft::Arena &arena) {
+		ArenaMap onArena(ft::less<int>(), (PairAlloc(arena)));
+		ArenaMap onHeap(ft::less<int>(), (PairAlloc()));
+		for (int i = 0; i < 40; ++i)
+			onArena[i] = i * 2;
+		for (int i = 0; i < 8; ++i)
+			onHeap[i + 100] = i;
+		onArena.swap(onHeap);
+		CHECK(onArena.size() == 8 && onArena[103] == 3);
+		CHECK(onHeap.size() == 40 && onHeap[39] == 78);
+		CHECK(onArena.get_allocator().arena() == NULL);
+		CHECK(onHeap.get_allocator().arena() == &arena);
+		for (int i = 0; i < 20; ++i)
+			onArena[i] = i;
+		onArena.erase(103);
+		CHECK(onArena.size() == 27);
+	}
+
+	void testString(ft::Arena &arena) {
+		ArenaString onHeap(LONG_TEXT);
+		ArenaString shortOnHeap("short");
+		{
+			ft::ArenaScope scope(arena);
+			ArenaString onArena("another string that does not fit inline");
+			ArenaString shortOnArena("tiny");
+
+			onArena.swap(onHeap);
+			CHECK(onArena == LONG_TEXT);
+			CHECK(onHeap == "another string that does not fit inline");
+			// heap and inline: only the heap side's allocator holds memory
+			onArena.swap(shortOnArena);
+			CHECK(onArena == "tiny");
+			CHECK(shortOnArena == LONG_TEXT);
+			shortOnArena.swap(shortOnHeap);
+			CHECK(shortOnArena == "short");
+			CHECK(shortOnHeap == LONG_TEXT);
+
+			// move assignment goes through swap as well
+			ArenaString fromArena("moved out of the arena, past the inline size");
+			onHeap = std::move(fromArena);
+			CHECK(onHeap == "moved out of the arena, past the inline size");
+		}
+		// copy assignment that has to grow keeps the target's allocator
+		ArenaString grown("x");
+		grown = onHeap;
+		grown += LONG_TEXT;
+		CHECK(grown.size() == onHeap.size() + std::strlen(LONG_TEXT));
+		onHeap += " and longer still, so the buffer has to move";
+		shortOnHeap += " and more";
+		CHECK(shortOnHeap.size() == std::strlen(LONG_TEXT) + 9);
+	}
+}
+
+int main() {
+	ft::Arena arena(4096);
+	testVector(arena);
+	testSmallVector(arena);
+	testList(arena);
+	testMap(arena);
+	testString(arena);
+	return (check::result("allocator_test"));
+}
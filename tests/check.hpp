@@ -0,0 +1,42 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+/**
+ * Minimal assertions for the programs in tests/. A failed CHECK prints
+ * where and what and the run goes on; the program's exit status is nonzero
+ * if anything failed. `make test` builds each one with ASan and UBSan, so
+ * memory errors fail the run too.
+ */
+namespace check
+{
+	inline int &failures() {
+		static int count = 0;
+		return (count);
+	}
+
+	inline bool report(bool passed, const char *file, int line, const char *code) {
+		if (!passed)
+		{
+			++failures();
+			std::cerr << file << ":" << line << ": FAILED " << code << std::endl;
+		}
+		return (passed);
+	}
+
+	/**
+	 * @brief Prints the summary line; main returns this.
+	 */
+	inline int result(const char *name) {
+		if (failures() == 0)
+			std::cout << name << ": ok" << std::endl;
+		else
+			std::cout << name << ": " << failures() << " failed" << std::endl;
+		return (failures() != 0);
+	}
+}
+
+#define CHECK(condition)	check::report((condition), __FILE__, __LINE__, #condition)
+
+#endif
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include "check.hpp"
+#include "rt_frustum.hpp"
+
+/**
+ * Every cull kernel the CPU runs against Frustumf::intersectsSphere and
+ * intersectsAabb, bit for bit, for counts that leave every tail length.
+ * Half the bounds are placed so their distance to one of the planes
+ * rounds to about zero, where a different association of the plane sums
+ * would flip the result.
+ */
+namespace
+{
+	const size_t COUNTS[] = { 1, 3, 7, 63, 64, 65, 100, 129, 1021 };
+	const size_t MAX_COUNT = 1021;
+
+	std::mt19937 rng(5);
+
+	float uniform(float low, float high) {
+		return (std::uniform_real_distribution<float>(low, high)(rng));
+	}
+
+	rt::Frustumf randomFrustum() {
+		rt::Mat4f projection = rt::perspective(rt::radians(uniform(30.0f, 90.0f)), uniform(0.5f, 2.0f),
+			uniform(0.1f, 1.0f), uniform(20.0f, 100.0f));
+		rt::Mat4f view = rt::translate(rt::Mat4f::identity(),
+			rt::Vec3f(uniform(-5.0f, 5.0f), uniform(-5.0f, 5.0f), uniform(-5.0f, 5.0f)));
+		view = rt::rotate(view, uniform(0.0f, 6.28f), rt::Vec3f(uniform(-1.0f, 1.0f), 1.0f, uniform(-1.0f, 1.0f)));
+		return (rt::Frustumf::fromMatrix(projection * view));
+	}
+
+	float planeDistance(const rt::Vec4f &p, float x, float y, float z) {
+		return (p[0] * x + p[1] * y + p[2] * z + p[3]);
+	}
+
+	bool sameBits(const uint64_t *mask, const bool *expected, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			if (((mask[i / 64] >> (i % 64)) & 1) != expected[i])
+				return (false);
+		// bits past count have to be clear
+		if (count % 64 && mask[count / 64] >> (count % 64))
+			return (false);
+		return (true);
+	}
+
+	void testSpheres(const rt::Frustumf &frustum, size_t count) {
+		static float x[MAX_COUNT], y[MAX_COUNT], z[MAX_COUNT], r[MAX_COUNT];
+		static bool expected[MAX_COUNT];
+		for (size_t i = 0; i < count; ++i)
+		{
+			x[i] = uniform(-60.0f, 60.0f);
+			y[i] = uniform(-60.0f, 60.0f);
+			z[i] = uniform(-60.0f, 60.0f);
+			r[i] = uniform(0.0f, 10.0f);
+			if (i % 2)
+			{
+				// radius equal to the distance behind one plane
+				const rt::Vec4f &p = frustum.planes[rng() % rt::Frustumf::PLANE_COUNT];
+				float d = planeDistance(p, x[i], y[i], z[i]);
+				r[i] = d < 0.0f ? -d : d;
+			}
+			expected[i] = frustum.intersectsSphere(rt::Vec3f(x[i], y[i], z[i]), r[i]);
+		}
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa)
+		{
+			uint64_t mask[(MAX_COUNT + 63) / 64 + 1];
+			for (size_t w = 0; w < sizeof(mask) / sizeof(mask[0]); ++w)
+				mask[w] = ~static_cast<uint64_t>(0);
+			rt::cull::cullSpheresKernel(static_cast<rt::simd::Isa>(isa))(rt::cull::Planes(frustum),
+				x, y, z, r, count, mask);
+			if (!CHECK(sameBits(mask, expected, count)))
+				std::cerr << "  spheres, count " << count << " with "
+					<< rt::simd::isaName(static_cast<rt::simd::Isa>(isa)) << std::endl;
+		}
+	}
+
+	void testAabbs(const rt::Frustumf &frustum, size_t count) {
+		static float minX[MAX_COUNT], minY[MAX_COUNT], minZ[MAX_COUNT];
+		static float maxX[MAX_COUNT], maxY[MAX_COUNT], maxZ[MAX_COUNT];
+		static bool expected[MAX_COUNT];
+		for (size_t i = 0; i < count; ++i)
+		{
+			minX[i] = uniform(-60.0f, 60.0f);
+			minY[i] = uniform(-60.0f, 60.0f);
+			minZ[i] = uniform(-60.0f, 60.0f);
+			maxX[i] = minX[i] + uniform(0.0f, 8.0f);
+			maxY[i] = minY[i] + uniform(0.0f, 8.0f);
+			maxZ[i] = minZ[i] + uniform(0.0f, 8.0f);
+			if (i % 2)
+			{
+				// slide the box along a plane normal until its furthest
+				// corner sits on the plane
+				const rt::Vec4f &p = frustum.planes[rng() % rt::Frustumf::PLANE_COUNT];
+				float d = planeDistance(p, p[0] >= 0.0f ? maxX[i] : minX[i],
+					p[1] >= 0.0f ? maxY[i] : minY[i], p[2] >= 0.0f ? maxZ[i] : minZ[i]);
+				minX[i] -= d * p[0];
+				maxX[i] -= d * p[0];
+				minY[i] -= d * p[1];
+				maxY[i] -= d * p[1];
+				minZ[i] -= d * p[2];
+				maxZ[i] -= d * p[2];
+			}
+			expected[i] = frustum.intersectsAabb(rt::Vec3f(minX[i], minY[i], minZ[i]),
+				rt::Vec3f(maxX[i], maxY[i], maxZ[i]));
+		}
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa)
+		{
+			uint64_t mask[(MAX_COUNT + 63) / 64 + 1];
+			for (size_t w = 0; w < sizeof(mask) / sizeof(mask[0]); ++w)
+				mask[w] = ~static_cast<uint64_t>(0);
+			rt::cull::cullAabbsKernel(static_cast<rt::simd::Isa>(isa))(rt::cull::Planes(frustum),
+				minX, minY, minZ, maxX, maxY, maxZ, count, mask);
+			if (!CHECK(sameBits(mask, expected, count)))
+				std::cerr << "  boxes, count " << count << " with "
+					<< rt::simd::isaName(static_cast<rt::simd::Isa>(isa)) << std::endl;
+		}
+	}
+}
+
+int main() {
+	for (int n = 0; n < 50; ++n)
+	{
+		rt::Frustumf frustum = randomFrustum();
+		for (size_t c = 0; c < sizeof(COUNTS) / sizeof(COUNTS[0]); ++c)
+		{
+			testSpheres(frustum, COUNTS[c]);
+			testAabbs(frustum, COUNTS[c]);
+		}
+	}
+	return (check::result("cull_test"));
+}
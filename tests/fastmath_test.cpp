@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "check.hpp"
+#include "rt_fastmath.hpp"
+
+/**
+ * rt::fast against double-precision <cmath>, asserting the bounds
+ * documented in rt_fastmath.hpp. Every STRIDE-th float of each domain is
+ * checked, which covers all exponents and a spread of mantissas; the
+ * batch kernels of every ISA the CPU runs are compared with the scalar
+ * functions on the same inputs.
+ */
+namespace
+{
+	const uint32_t STRIDE = 257;
+
+	const double SIN_COS_ULP = 1.6;
+	const double SIN_COS_ABS = 1e-7;	// where |result| <= 1e-3
+	const double TAN_ULP = 3.3;
+#if defined(__SSE__)
+	const double RSQRT_ULP = 4.0;
+#else
+	const double RSQRT_ULP = 2.2;
+#endif
+
+	float fromBits(uint32_t bits) {
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		return (f);
+	}
+
+	uint32_t toBits(float f) {
+		uint32_t bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return (bits);
+	}
+
+	// Error of result in units of the float ulp at exact.
+	double ulpError(float result, double exact) {
+		if ((float)exact == 0.0f)
+			return (result == 0.0f ? 0.0 : HUGE_VAL);
+		double ulp = std::ldexp(1.0, std::ilogb((float)exact) - 23);
+		return (std::fabs(result - exact) / ulp);
+	}
+
+	bool withinSinCos(float result, double exact) {
+		if (std::fabs(exact) > 1e-3)
+			return (ulpError(result, exact) <= SIN_COS_ULP);
+		return (std::fabs(result - exact) <= SIN_COS_ABS);
+	}
+
+	void testSinCos() {
+		const uint32_t last = toBits(8192.0f);
+		size_t failed = 0;
+		for (uint32_t bits = 0; bits <= last; bits += STRIDE)
+		{
+			for (int sign = 0; sign < 2; ++sign)
+			{
+				float x = sign ? -fromBits(bits) : fromBits(bits);
+				float s, c;
+				rt::fast::sinCos(x, s, c);
+				if (!withinSinCos(s, std::sin((double)x)) || !withinSinCos(c, std::cos((double)x)))
+					++failed;
+				if (rt::fast::sin(x) != s || rt::fast::cos(x) != c)
+					++failed;
+			}
+		}
+		CHECK(failed == 0);
+	}
+
+	void testTan() {
+		const uint32_t last = toBits(1.57079625f);	// largest float below pi / 2
+		double worst = 0.0;
+		for (uint32_t bits = 0; bits <= last; bits += STRIDE)
+		{
+			float x = fromBits(bits);
+			double e = ulpError(rt::fast::tan(x), std::tan((double)x));
+			worst = e > worst ? e : worst;
+			e = ulpError(rt::fast::tan(-x), std::tan(-(double)x));
+			worst = e > worst ? e : worst;
+		}
+		CHECK(worst <= TAN_ULP);
+	}
+
+	void testRsqrt() {
+		const uint32_t first = toBits(1.17549435e-38f);	// smallest normal
+		const uint32_t last = 0x7f7fffffu;				// largest finite
+		double worst = 0.0;
+		for (uint32_t bits = first; bits <= last && bits >= first; bits += STRIDE)
+		{
+			float x = fromBits(bits);
+			double e = ulpError(rt::fast::rsqrt(x), 1.0 / std::sqrt((double)x));
+			worst = e > worst ? e : worst;
+		}
+		CHECK(worst <= RSQRT_ULP);
+	}
+
+	// Inputs spread over the sin/cos domain and the normal floats, with a
+	// count that leaves a tail for the scalar remainder loops.
+	const size_t BATCH = 4099;
+
+	void testBatches() {
+		static float x[BATCH], positive[BATCH];
+		static float s[BATCH], c[BATCH], expectedS[BATCH], expectedC[BATCH];
+		static float r[BATCH];
+		for (size_t i = 0; i < BATCH; ++i)
+		{
+			x[i] = -8192.0f + 16384.0f * (float)i / (float)BATCH;
+			positive[i] = fromBits(0x00800000u + (uint32_t)i * 0x7e000u);
+			rt::fast::sinCos(x[i], expectedS[i], expectedC[i]);
+		}
+		for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa)
+		{
+			rt::simd::Isa kernelIsa = static_cast<rt::simd::Isa>(isa);
+			rt::fast::sinCosKernel(kernelIsa)(x, s, c, BATCH);
+			rt::fast::rsqrtKernel(kernelIsa)(positive, r, BATCH);
+			size_t differ = 0;
+			double worst = 0.0;
+			for (size_t i = 0; i < BATCH; ++i)
+			{
+				if (s[i] != expectedS[i] || c[i] != expectedC[i])
+					++differ;
+				double e = ulpError(r[i], 1.0 / std::sqrt((double)positive[i]));
+				worst = e > worst ? e : worst;
+			}
+			if (!CHECK(differ == 0) || !CHECK(worst <= RSQRT_ULP))
+				std::cerr << "  with the " << rt::simd::isaName(kernelIsa) << " kernels" << std::endl;
+		}
+	}
+}
+
+int main() {
+	testSinCos();
+	testTan();
+	testRsqrt();
+	testBatches();
+	return (check::result("fastmath_test"));
+}
@@ -0,0 +1,100 @@
+#include <cmath>
+#include <utility>
+#include "check.hpp"
+#include "bench.hpp"
+#include "rt_vector.hpp"
+#include "rt_matrix.hpp"
+#include "rt_vec.hpp"
+#include "rt_mat.hpp"
+#include "rt_quaternion.hpp"
+#include "rt_transform.hpp"
+#include "rt_frustum.hpp"
+#include "rt_relative.hpp"
+
+/**
+ * The per-frame math of the render loop in main.cpp, plus same-size
+ * RTMatrix/RTVector copy, move and expression assignment, run for FRAMES
+ * frames: none of it may allocate. bench::allocationCount() counts every
+ * operator new and new[] of the process.
+ */
+namespace
+{
+	const size_t FRAMES = 1000000;
+
+	struct Frame
+	{
+		rt::Quatf				spinStep;
+		rt::Quatf				spin;
+		rt::Quatf				orbit;
+		rt::Mat4f				projection;
+		rt::Vec3d				origin;
+		rt::Vec3f				center;
+		float					radius;
+
+		rt::RTMatrix<float>		matrix;
+		rt::RTMatrix<float>		matrixCopy;
+		rt::RTVector<float>		a;
+		rt::RTVector<float>		b;
+		rt::RTVector<float>		sum;
+
+		Frame()
+			: spinStep(rt::Quatf::fromAxisAngle(rt::Vec3f(0.0f, 1.0f, 0.0f), rt::radians(1.0f))),
+			projection(rt::perspective(rt::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f)),
+			origin(1e6, -2e5, 3.5), center(0.5f, 1.0f, -0.25f), radius(2.0f),
+			matrix(4, 4), matrixCopy(4, 4), a(1.0f, 2.0f, 3.0f), b(0.5f, 0.25f, 0.125f), sum(0.0f, 0.0f, 0.0f) {
+			this->matrix.toIdentity();
+		};
+
+		// One iteration of main.cpp's loop without the GL calls; returns
+		// whether the object would be drawn.
+		bool run() {
+			rt::Mat4d model = rt::Mat4d::identity();
+			model = rt::translate(model, -rt::Vec3d(this->center));
+			model = rt::scale(model, rt::Vec3d(1.0, 1.0, 1.0));
+			model = rt::Mat4d(this->spin.toMat4()) * model;
+			model = rt::translate(model, this->origin);
+			this->spin = this->spinStep * this->spin;
+			this->spin.normalize();
+
+			rt::Mat4d view = rt::Mat4d::identity();
+			view = rt::translate(view, -this->origin);
+			view = rt::Mat4d(this->orbit.conjugate().toMat4()) * view;
+			view = rt::translate(view, rt::Vec3d(0.0, 0.0, -10.0));
+
+			rt::CameraRelative relative = rt::cameraRelative(view, model);
+			rt::Frustumf frustum = rt::Frustumf::fromMatrix(this->projection * relative.view * relative.model);
+			bool visible = frustum.intersectsSphere(this->center, this->radius);
+
+			// same-size assignments reuse the buffers, moves swap them
+			this->matrixCopy = this->matrix;
+			rt::RTMatrix<float> moved(std::move(this->matrixCopy));
+			this->matrixCopy = std::move(moved);
+			this->sum = this->a + this->b * 2.0f;
+			return (visible);
+		};
+	};
+}
+
+int main() {
+	// the counter has to see allocations for the check below to mean anything
+	size_t before = bench::allocationCount();
+	int *probe = new int(0);
+	CHECK(bench::allocationCount() == before + 1);
+	delete probe;
+
+	Frame frame;
+	size_t visible = 0;
+	frame.run();	// first-call setup such as the SIMD dispatch is not per frame
+	before = bench::allocationCount();
+	for (size_t i = 0; i < FRAMES; ++i)
+		visible += frame.run();
+	size_t allocations = bench::allocationCount() - before;
+
+	CHECK(allocations == 0);
+	if (allocations)
+		std::cerr << "  " << (double)allocations / FRAMES << " allocations per frame" << std::endl;
+	CHECK(visible == FRAMES);
+	CHECK(std::fabs(frame.sum[0] - 2.0f) < 1e-6f);
+	CHECK(std::fabs(frame.spin.norm() - 1.0f) < 1e-4f);
+	return (check::result("frame_alloc_test"));
+}
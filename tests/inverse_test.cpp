@@ -0,0 +1,211 @@
+#include <cmath>
+#include <random>
+#include "check.hpp"
+#include "rt_mat.hpp"
+#include "rt_matrix.hpp"
+
+/**
+ * The closed-form inverses in rt_inverse.hpp, in float, against a
+ * Gauss-Jordan reference in double on random well-conditioned matrices:
+ * diagonally dominant ones for the full inverses, rotation * scale plus a
+ * translation for the affine and normal-matrix variants. The error of a
+ * matrix is its largest absolute one over max(1, largest |reference|).
+ */
+namespace
+{
+	const int SAMPLES = 10000;
+	// about twice the worst seen over these samples: 2.4e-7 for the full
+	// and normal matrices, 3.7e-7 for the affine inverse, whose translation
+	// column cancels terms up to 40 in magnitude
+	const double INVERSE_TOLERANCE = 4e-7;
+	const double AFFINE_TOLERANCE = 7e-7;
+
+	std::mt19937 rng(42);
+
+	double uniform(double low, double high) {
+		return (std::uniform_real_distribution<double>(low, high)(rng));
+	}
+
+	// In-place Gauss-Jordan with partial pivoting on an n x n row-major
+	// matrix, n <= 8.
+	void referenceInverse(double *m, int n) {
+		double inv[64];
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j)
+				inv[i * n + j] = (i == j) ? 1.0 : 0.0;
+		for (int col = 0; col < n; ++col)
+		{
+			int pivot = col;
+			for (int r = col + 1; r < n; ++r)
+				if (std::fabs(m[r * n + col]) > std::fabs(m[pivot * n + col]))
+					pivot = r;
+			for (int j = 0; j < n; ++j)
+			{
+				std::swap(m[col * n + j], m[pivot * n + j]);
+				std::swap(inv[col * n + j], inv[pivot * n + j]);
+			}
+			double scale = 1.0 / m[col * n + col];
+			for (int j = 0; j < n; ++j)
+			{
+				m[col * n + j] *= scale;
+				inv[col * n + j] *= scale;
+			}
+			for (int r = 0; r < n; ++r)
+			{
+				if (r == col)
+					continue;
+				double f = m[r * n + col];
+				for (int j = 0; j < n; ++j)
+				{
+					m[r * n + j] -= f * m[col * n + j];
+					inv[r * n + j] -= f * inv[col * n + j];
+				}
+			}
+		}
+		for (int i = 0; i < n * n; ++i)
+			m[i] = inv[i];
+	}
+
+	double error(const float *result, const double *reference, int count) {
+		double worst = 0.0;
+		double scale = 1.0;
+		for (int i = 0; i < count; ++i)
+		{
+			double e = std::fabs(result[i] - reference[i]);
+			if (e > worst)
+				worst = e;
+			if (std::fabs(reference[i]) > scale)
+				scale = std::fabs(reference[i]);
+		}
+		return (worst / scale);
+	}
+
+	// Diagonally dominant n x n, rounded to float before the reference sees
+	// it so both start from the same matrix.
+	void randomDominant(float *f, double *d, int n) {
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j)
+			{
+				f[i * n + j] = (float)(uniform(-0.5, 0.5) + (i == j ? 2.0 : 0.0));
+				d[i * n + j] = f[i * n + j];
+			}
+	}
+
+	// Rotation from a random unit quaternion, per-axis scale, translation.
+	void randomAffine(float *f, double *d) {
+		double q[4];
+		double len = 0.0;
+		for (int i = 0; i < 4; ++i)
+		{
+			q[i] = uniform(-1.0, 1.0);
+			len += q[i] * q[i];
+		}
+		len = std::sqrt(len);
+		double w = q[0] / len, x = q[1] / len, y = q[2] / len, z = q[3] / len;
+		double r[9] = {
+			1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y),
+			2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x),
+			2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y)
+		};
+		double s[3] = { uniform(0.5, 2.0), uniform(0.5, 2.0), uniform(0.5, 2.0) };
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+				f[i * 4 + j] = (float)(r[i * 3 + j] * s[j]);
+			f[i * 4 + 3] = (float)uniform(-10.0, 10.0);
+		}
+		f[12] = 0.0f;
+		f[13] = 0.0f;
+		f[14] = 0.0f;
+		f[15] = 1.0f;
+		for (int i = 0; i < 16; ++i)
+			d[i] = f[i];
+	}
+
+	void testInverse3() {
+		double worst = 0.0;
+		for (int n = 0; n < SAMPLES; ++n)
+		{
+			float f[9];
+			double d[9];
+			randomDominant(f, d, 3);
+			rt::Mat3f result = rt::inverse(rt::Mat3f(f));
+			referenceInverse(d, 3);
+			double e = error(result.getData(), d, 9);
+			worst = e > worst ? e : worst;
+		}
+		CHECK(worst < INVERSE_TOLERANCE);
+	}
+
+	void testInverse4() {
+		double worst = 0.0;
+		for (int n = 0; n < SAMPLES; ++n)
+		{
+			float f[16];
+			double d[16];
+			randomDominant(f, d, 4);
+			rt::Mat4f result = rt::inverse(rt::Mat4f(f));
+			referenceInverse(d, 4);
+			double e = error(result.getData(), d, 16);
+			worst = e > worst ? e : worst;
+		}
+		CHECK(worst < INVERSE_TOLERANCE);
+	}
+
+	void testAffineAndNormal() {
+		double worstAffine = 0.0;
+		double worstNormal = 0.0;
+		for (int n = 0; n < SAMPLES; ++n)
+		{
+			float f[16];
+			double d[16];
+			randomAffine(f, d);
+			rt::Mat4f affine = rt::affineInverse(rt::Mat4f(f));
+			rt::Mat3f normal = rt::normalMatrix(rt::Mat4f(f));
+			referenceInverse(d, 4);
+			double e = error(affine.getData(), d, 16);
+			worstAffine = e > worstAffine ? e : worstAffine;
+			// the normal matrix is the transpose of the inverse's upper 3x3
+			double expected[9];
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+					expected[i * 3 + j] = d[j * 4 + i];
+			e = error(normal.getData(), expected, 9);
+			worstNormal = e > worstNormal ? e : worstNormal;
+		}
+		CHECK(worstAffine < AFFINE_TOLERANCE);
+		CHECK(worstNormal < INVERSE_TOLERANCE);
+	}
+
+	// Sizes above 4 keep the Gauss-Jordan path; A * A^-1 has to be I.
+	void testLargeResidual() {
+		const int N = 5;
+		double worst = 0.0;
+		for (int n = 0; n < 100; ++n)
+		{
+			double d[N * N];
+			for (int i = 0; i < N * N; ++i)
+				d[i] = uniform(-1.0, 1.0) + (i % (N + 1) == 0 ? 3.0 : 0.0);
+			rt::RTMatrix<double> m(N, N, d);
+			m.inverse();
+			for (int i = 0; i < N; ++i)
+				for (int j = 0; j < N; ++j)
+				{
+					double sum = 0.0;
+					for (int k = 0; k < N; ++k)
+						sum += d[i * N + k] * m[k][j];
+					double e = std::fabs(sum - (i == j ? 1.0 : 0.0));
+					worst = e > worst ? e : worst;
+				}
+		}
+		CHECK(worst < 1e-12);
+	}
+}
+
+int main() {
+	testInverse3();
+	testInverse4();
+	testAffineAndNormal();
+	testLargeResidual();
+	return (check::result("inverse_test"));
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "check.hpp"
+#include "rt_matrix.hpp"
+#include "rt_linalg.hpp"
+
+/**
+ * RTMatrix operator* against a naive loop over square and non-square
+ * shapes on both sides of the 4x4 kernel. a * b is b * a in the usual
+ * order, so b.cols has to match a.rows; rt::multiply keeps the usual
+ * order.
+ */
+namespace
+{
+	std::mt19937 rng(3);
+
+	template <class T>
+	rt::RTMatrix<T> random(size_t rows, size_t cols) {
+		rt::RTMatrix<T> m(rows, cols);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 0; j < cols; ++j)
+				m[i][j] = static_cast<T>(std::uniform_real_distribution<double>(-1.0, 1.0)(rng));
+		return m;
+	}
+
+	// Largest |result - a * b| over |a| * |b| summed per element.
+	template <class T>
+	double error(const rt::RTMatrix<T>& result, const rt::RTMatrix<T>& a, const rt::RTMatrix<T>& b) {
+		if (result.getRows() != a.getRows() || result.getCols() != b.getCols())
+			return (HUGE_VAL);
+		double worst = 0.0;
+		for (size_t i = 0; i < a.getRows(); ++i)
+			for (size_t j = 0; j < b.getCols(); ++j)
+			{
+				double sum = 0.0;
+				double magnitude = 0.0;
+				for (size_t k = 0; k < a.getCols(); ++k)
+				{
+					sum += (double)a[i][k] * b[k][j];
+					magnitude += std::fabs((double)a[i][k] * b[k][j]);
+				}
+				double e = std::fabs(result[i][j] - sum) / (magnitude > 0.0 ? magnitude : 1.0);
+				worst = e > worst ? e : worst;
+			}
+		return (worst);
+	}
+
+	template <class T>
+	void testShapes(double tolerance) {
+		const size_t shapes[][3] = {
+			{ 1, 1, 1 }, { 3, 3, 3 }, { 4, 4, 4 }, { 2, 3, 4 }, { 4, 4, 1 },
+			{ 1, 4, 4 }, { 5, 2, 7 }, { 33, 33, 33 }, { 40, 17, 3 }, { 7, 64, 31 }
+		};
+		for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s)
+		{
+			// a is m x k, b is k x n
+			rt::RTMatrix<T> a = random<T>(shapes[s][0], shapes[s][1]);
+			rt::RTMatrix<T> b = random<T>(shapes[s][1], shapes[s][2]);
+			double e = error(b * a, a, b);
+			double ordinary = error(rt::multiply(a, b), a, b);
+			if (!CHECK(e < tolerance) || !CHECK(ordinary < tolerance))
+				std::cerr << "  " << shapes[s][0] << "x" << shapes[s][1]
+					<< " times " << shapes[s][1] << "x" << shapes[s][2] << std::endl;
+		}
+	}
+
+	void testMismatch() {
+		rt::RTMatrix<double> a = random<double>(2, 3);
+		bool thrown = false;
+		try
+		{
+			rt::RTMatrix<double> r = a * a;
+		}
+		catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+}
+
+int main() {
+	testShapes<float>(1e-5);
+	testShapes<double>(1e-13);
+	testMismatch();
+	return (check::result("matrix_product_test"));
+}
@@ -0,0 +1,90 @@
+#include <mutex>
+#include "check.hpp"
+#include "PoolAllocator.hpp"
+#include "List.hpp"
+#include "Map.hpp"
+#include "Vector.hpp"
+#include "rt_parallel.hpp"
+
+/**
+ * PoolSet::local() from short-lived threads: every rt::parallelFor call
+ * starts new workers, and each worker's set has to be handed on at exit
+ * instead of leaking its slabs (LeakSanitizer reports those).
+ */
+namespace
+{
+	typedef ft::Map<int, int, ft::less<int>, ft::PoolAllocator<ft::Pair<const int, int> > >	PoolMap;
+	typedef ft::List<int, ft::PoolAllocator<int> >											PoolList;
+
+	std::mutex				seenLock;
+	ft::Vector<ft::PoolSet*>	seen;
+
+	void remember(ft::PoolSet *pools) {
+		std::lock_guard<std::mutex> guard(seenLock);
+		for (size_t i = 0; i < seen.size(); ++i)
+			if (seen[i] == pools)
+				return ;
+		seen.push_back(pools);
+	}
+
+	// Builds and destroys pooled containers on the calling thread.
+	bool work(size_t begin, size_t end) {
+		PoolMap map;
+		PoolList list;
+		for (size_t i = begin; i < end; ++i)
+		{
+			map[(int)i] = (int)i;
+			list.push_back((int)i);
+		}
+		remember(&ft::PoolSet::local());
+		return (map.size() == end - begin && list.size() == end - begin);
+	}
+
+	void testWorkersReuseSets() {
+		const unsigned THREADS = 4;
+		const int ROUNDS = 50;
+		bool ok = true;
+		std::mutex okLock;
+		for (int round = 0; round < ROUNDS; ++round)
+			rt::parallelFor(4096, THREADS, 1, 1, [&](size_t begin, size_t end) {
+				bool done = work(begin, end);
+				std::lock_guard<std::mutex> guard(okLock);
+				ok = ok && done;
+			});
+		CHECK(ok);
+		// one set per concurrent thread, not one per worker started
+		CHECK(seen.size() <= THREADS);
+		CHECK(ft::PoolSet::local().liveBlocks() == 0);
+	}
+
+	void testSetWithLiveBlocksIsKept() {
+		PoolList *survivor = NULL;
+		std::thread builder([&survivor]() {
+			survivor = new PoolList();
+			for (int i = 0; i < 100; ++i)
+				survivor->push_back(i);
+		});
+		builder.join();
+		ft::PoolSet *kept = survivor->get_allocator().pools();
+		CHECK(kept->liveBlocks() == 101);
+		// the builder has exited, so this thread is the only one freeing
+		int sum = 0;
+		for (PoolList::iterator it = survivor->begin(); it != survivor->end(); ++it)
+			sum += *it;
+		CHECK(sum == 4950);
+		delete survivor;
+		CHECK(kept->liveBlocks() == 0);
+		// the kept set was not handed to another thread
+		std::thread other([kept]() {
+			CHECK(&ft::PoolSet::local() != kept);
+		});
+		other.join();
+		delete kept;
+	}
+}
+
+int main() {
+	testWorkersReuseSets();
+	testSetWithLiveBlocksIsKept();
+	return (check::result("pool_allocator_test"));
+}
@@ -0,0 +1,172 @@
+#include <cstring>
+#include <random>
+#include "check.hpp"
+#include "rt_ray.hpp"
+
+/**
+ * Every ray kernel the CPU runs against a loop over the scalar
+ * intersectTriangle: hit index, t, u and v have to match exactly. Triangle
+ * and ray counts leave every tail length, intersectClosest kernels also
+ * start at non-zero offsets, and some triangles are duplicated so equal
+ * distances have to resolve to the lower index as the scalar loop does.
+ */
+namespace
+{
+	const size_t MAX_TRIS = 67;
+	const size_t MAX_RAYS = 67;
+
+	std::mt19937 rng(9);
+
+	float uniform(float low, float high) {
+		return (std::uniform_real_distribution<float>(low, high)(rng));
+	}
+
+	// Random triangles in a box around the origin, every fifth one a copy of
+	// an earlier one.
+	void randomTriangles(float *packed, size_t count) {
+		float positions[9 * MAX_TRIS];
+		int indices[3 * MAX_TRIS];
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (i % 5 == 4)
+			{
+				size_t copy = rng() % i;
+				for (size_t k = 0; k < 9; ++k)
+					positions[9 * i + k] = positions[9 * copy + k];
+			}
+			else
+			{
+				float cx = uniform(-3.0f, 3.0f), cy = uniform(-3.0f, 3.0f), cz = uniform(-3.0f, 3.0f);
+				for (size_t k = 0; k < 3; ++k)
+				{
+					positions[9 * i + 3 * k] = cx + uniform(-1.5f, 1.5f);
+					positions[9 * i + 3 * k + 1] = cy + uniform(-1.5f, 1.5f);
+					positions[9 * i + 3 * k + 2] = cz + uniform(-1.5f, 1.5f);
+				}
+			}
+			for (size_t k = 0; k < 3; ++k)
+				indices[3 * i + k] = static_cast<int>(3 * i + k);
+		}
+		rt::ray::packTriangles(positions, 3, indices, count, packed);
+	}
+
+	// Origin outside the box, aimed near the centre so most rays hit.
+	void randomRay(float *ray) {
+		for (size_t k = 0; k < 3; ++k)
+			ray[k] = uniform(-10.0f, 10.0f);
+		for (size_t k = 0; k < 3; ++k)
+			ray[3 + k] = uniform(-2.0f, 2.0f) - ray[k];
+	}
+
+	rt::ray::Hit referenceClosest(const float *ray, const rt::ray::Triangles &tris, size_t begin, float tMax) {
+		rt::ray::Hit hit;
+		hit.t = tMax;
+		hit.u = 0.0f;
+		hit.v = 0.0f;
+		hit.index = -1;
+		for (size_t i = begin; i < tris.count; ++i)
+		{
+			float t, u, v;
+			if (rt::ray::intersectTriangle(ray[0], ray[1], ray[2], ray[3], ray[4], ray[5],
+					tris, i, hit.t, t, u, v))
+			{
+				hit.t = t;
+				hit.u = u;
+				hit.v = v;
+				hit.index = static_cast<int>(i);
+			}
+		}
+		return (hit);
+	}
+
+	bool sameHit(const rt::ray::Hit &a, const rt::ray::Hit &b) {
+		return (a.index == b.index && std::memcmp(&a.t, &b.t, sizeof(float)) == 0
+			&& std::memcmp(&a.u, &b.u, sizeof(float)) == 0 && std::memcmp(&a.v, &b.v, sizeof(float)) == 0);
+	}
+
+	void testClosest(rt::simd::Isa isa) {
+		static float packed[9 * MAX_TRIS];
+		rt::ray::ClosestFn kernel = rt::ray::closestKernel(isa);
+		size_t hits = 0;
+		bool ok = true;
+		for (size_t count = 1; count <= MAX_TRIS; count += (count < 20 ? 1 : 47))
+		{
+			randomTriangles(packed, count);
+			rt::ray::Triangles tris(packed, count);
+			const size_t begins[] = { 0, 1, 3, 5, 9 };
+			for (size_t b = 0; b < sizeof(begins) / sizeof(begins[0]) && begins[b] < count; ++b)
+				for (int n = 0; n < 200; ++n)
+				{
+					float ray[6];
+					randomRay(ray);
+					float tMax = (n % 4 == 0) ? uniform(0.5f, 10.0f) : std::numeric_limits<float>::infinity();
+					rt::ray::Hit expected = referenceClosest(ray, tris, begins[b], tMax);
+					rt::ray::Hit hit;
+					hit.t = tMax;
+					hit.u = 0.0f;
+					hit.v = 0.0f;
+					hit.index = -1;
+					kernel(ray, tris, begins[b], hit);
+					ok = ok && sameHit(hit, expected);
+					hits += expected.index >= 0;
+				}
+		}
+		if (!CHECK(ok))
+			std::cerr << "  closest with " << rt::simd::isaName(isa) << std::endl;
+		// the rays have to hit often for the comparison to mean anything
+		CHECK(hits > 1000);
+	}
+
+	void testPacket(rt::simd::Isa isa) {
+		static float packed[9 * MAX_TRIS];
+		static float origins[3 * MAX_RAYS], directions[3 * MAX_RAYS];
+		static float t[MAX_RAYS], u[MAX_RAYS], v[MAX_RAYS];
+		static int index[MAX_RAYS];
+		rt::ray::PacketFn kernel = rt::ray::packetKernel(isa);
+		randomTriangles(packed, MAX_TRIS);
+		rt::ray::Triangles tris(packed, MAX_TRIS);
+		bool ok = true;
+		for (size_t count = 1; count <= MAX_RAYS; count += (count < 20 ? 1 : 47))
+			for (int n = 0; n < 20; ++n)
+			{
+				for (size_t r = 0; r < count; ++r)
+				{
+					float ray[6];
+					randomRay(ray);
+					for (size_t k = 0; k < 3; ++k)
+					{
+						origins[k * MAX_RAYS + r] = ray[k];
+						directions[k * MAX_RAYS + r] = ray[3 + k];
+					}
+				}
+				rt::ray::RayPacket rays = {
+					origins, origins + MAX_RAYS, origins + 2 * MAX_RAYS,
+					directions, directions + MAX_RAYS, directions + 2 * MAX_RAYS, count
+				};
+				rt::ray::HitPacket result = { t, u, v, index };
+				rt::ray::resetHits(result, count, (n % 4 == 0) ? 5.0f : std::numeric_limits<float>::infinity());
+				float tMax = t[0];
+				for (size_t tri = 0; tri < MAX_TRIS; ++tri)
+					kernel(rays, tris, tri, result);
+				for (size_t r = 0; r < count; ++r)
+				{
+					float ray[6] = {
+						rays.ox[r], rays.oy[r], rays.oz[r], rays.dx[r], rays.dy[r], rays.dz[r]
+					};
+					rt::ray::Hit hit = { t[r], u[r], v[r], index[r] };
+					ok = ok && sameHit(hit, referenceClosest(ray, tris, 0, tMax));
+				}
+			}
+		if (!CHECK(ok))
+			std::cerr << "  packet with " << rt::simd::isaName(isa) << std::endl;
+	}
+}
+
+int main() {
+	for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa)
+	{
+		testClosest(static_cast<rt::simd::Isa>(isa));
+		testPacket(static_cast<rt::simd::Isa>(isa));
+	}
+	return (check::result("ray_test"));
+}
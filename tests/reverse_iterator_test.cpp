@@ -0,0 +1,82 @@
+#include "check.hpp"
+#include "FlatMap.hpp"
+#include "Map.hpp"
+#include "StringView.hpp"
+#include "Vector.hpp"
+
+/**
+ * reverse_iterator::operator-> has to reach the same element as
+ * operator*, one before base(), for pointer iterators as well as for class
+ * iterators whose operator-> returns a proxy (FlatMap).
+ */
+namespace
+{
+	struct Point
+	{
+		int	x;
+		int	y;
+	};
+
+	void testFlatMap() {
+		ft::FlatMap<int, int> flat;
+		for (int i = 0; i < 5; ++i)
+			flat[i] = i * 10;
+		CHECK(flat.rbegin()->first == 4);
+		CHECK(flat.rbegin()->second == 40);
+		flat.rbegin()->second = 41;
+		CHECK(flat[4] == 41);
+
+		int expected = 4;
+		for (ft::FlatMap<int, int>::reverse_iterator it = flat.rbegin(); it != flat.rend(); ++it)
+		{
+			CHECK(it->first == expected);
+			CHECK(it->first == (*it).first);
+			--expected;
+		}
+		CHECK(expected == -1);
+
+		const ft::FlatMap<int, int> &constFlat = flat;
+		CHECK(constFlat.rbegin()->first == 4);
+	}
+
+	void testMap() {
+		ft::Map<int, int> map;
+		for (int i = 0; i < 5; ++i)
+			map[i] = i * 10;
+		CHECK(map.rbegin()->first == 4);
+		CHECK((*map.rbegin()).first == 4);
+
+		int expected = 4;
+		for (ft::Map<int, int>::reverse_iterator it = map.rbegin(); it != map.rend(); ++it)
+		{
+			CHECK(it->first == expected);
+			CHECK(it->second == expected * 10);
+			--expected;
+		}
+		CHECK(expected == -1);
+
+		ft::Map<int, int> empty;
+		CHECK(empty.rbegin() == empty.rend());
+	}
+
+	void testPointers() {
+		ft::Vector<Point> points;
+		for (int i = 0; i < 3; ++i)
+		{
+			Point p = {i, -i};
+			points.push_back(p);
+		}
+		CHECK(points.rbegin()->x == 2);
+		CHECK((points.rbegin() + 2)->y == 0);
+
+		ft::StringView view("abc");
+		CHECK(*view.rbegin().operator->() == 'c');
+	}
+}
+
+int main() {
+	testFlatMap();
+	testMap();
+	testPointers();
+	return (check::result("reverse_iterator_test"));
+}
@@ -0,0 +1,146 @@
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include "check.hpp"
+#include "rt_simd.hpp"
+#include "rt_batch.hpp"
+
+/**
+ * Every SIMD variant the CPU can run (each ISA up to simd::activeIsa())
+ * against the scalar kernel on random inputs. Kernels that keep the
+ * scalar association must match it bit for bit; the FMA and
+ * horizontal-add ones may differ by rounding, bounded here by
+ * 4 * FLT_EPSILON * the sum of |terms| of each dot product.
+ */
+namespace
+{
+	const int SAMPLES = 20000;
+
+	std::mt19937 rng(7);
+
+	float uniform() {
+		return (std::uniform_real_distribution<float>(-4.0f, 4.0f)(rng));
+	}
+
+	bool close(float result, float expected, float magnitude) {
+		return (std::fabs(result - expected) <= 4.0f * FLT_EPSILON * magnitude);
+	}
+
+	void report(bool ok, const char *kernel, rt::simd::Isa isa) {
+		if (!CHECK(ok))
+			std::cerr << "  " << kernel << " with " << rt::simd::isaName(isa) << std::endl;
+	}
+
+	void testMat4Mul(rt::simd::Isa isa) {
+		rt::simd::Mat4MulFn kernel = rt::simd::mat4MulKernel(isa);
+		bool exact = (isa != rt::simd::ISA_AVX2);
+		bool ok = true;
+		for (int n = 0; n < SAMPLES; ++n)
+		{
+			float a[16], b[16], expected[16], out[16];
+			for (int i = 0; i < 16; ++i)
+			{
+				a[i] = uniform();
+				b[i] = uniform();
+			}
+			rt::simd::mat4MulScalar(a, b, expected);
+			kernel(a, b, out);
+			for (int i = 0; i < 16; ++i)
+			{
+				float magnitude = 0.0f;
+				for (int k = 0; k < 4; ++k)
+					magnitude += std::fabs(a[(i / 4) * 4 + k] * b[k * 4 + i % 4]);
+				ok = ok && (exact ? out[i] == expected[i] : close(out[i], expected[i], magnitude));
+			}
+			// out may alias either operand
+			float aliasA[16], aliasB[16];
+			for (int i = 0; i < 16; ++i)
+			{
+				aliasA[i] = a[i];
+				aliasB[i] = b[i];
+			}
+			kernel(aliasA, b, aliasA);
+			kernel(a, aliasB, aliasB);
+			for (int i = 0; i < 16; ++i)
+				ok = ok && aliasA[i] == out[i] && aliasB[i] == out[i];
+		}
+		report(ok, "mat4Mul", isa);
+	}
+
+	void testMat4MulVec4(rt::simd::Isa isa) {
+		rt::simd::Mat4MulVec4Fn kernel = rt::simd::mat4MulVec4Kernel(isa);
+		// the AVX kernel adds pairs with hadd, (x + y) + (z + w)
+		bool exact = (isa == rt::simd::ISA_SCALAR || isa == rt::simd::ISA_SSE2);
+		bool ok = true;
+		for (int n = 0; n < SAMPLES; ++n)
+		{
+			float m[16], v[4], expected[4], out[4];
+			for (int i = 0; i < 16; ++i)
+				m[i] = uniform();
+			for (int i = 0; i < 4; ++i)
+				v[i] = uniform();
+			rt::simd::mat4MulVec4Scalar(m, v, expected);
+			kernel(m, v, out);
+			for (int i = 0; i < 4; ++i)
+			{
+				float magnitude = 0.0f;
+				for (int k = 0; k < 4; ++k)
+					magnitude += std::fabs(m[i * 4 + k] * v[k]);
+				ok = ok && (exact ? out[i] == expected[i] : close(out[i], expected[i], magnitude));
+			}
+			kernel(m, v, v);
+			for (int i = 0; i < 4; ++i)
+				ok = ok && v[i] == out[i];
+		}
+		report(ok, "mat4MulVec4", isa);
+	}
+
+	void testTransformSoa(rt::simd::Isa isa) {
+		// not a multiple of 8, so the scalar tail runs too
+		const size_t COUNT = 1021;
+		static float x[COUNT], y[COUNT], z[COUNT];
+		static float ex[COUNT], ey[COUNT], ez[COUNT];
+		static float ox[COUNT], oy[COUNT], oz[COUNT];
+		rt::batch::TransformSoaFn kernel = rt::batch::transformSoaKernel(isa);
+		bool exact = (isa != rt::simd::ISA_AVX2);
+		bool ok = true;
+		for (int n = 0; n < SAMPLES / 1000; ++n)
+		{
+			float m[16];
+			for (int i = 0; i < 16; ++i)
+				m[i] = uniform();
+			for (size_t i = 0; i < COUNT; ++i)
+			{
+				x[i] = uniform();
+				y[i] = uniform();
+				z[i] = uniform();
+			}
+			rt::batch::transformSoaScalar(m, x, y, z, ex, ey, ez, COUNT);
+			kernel(m, x, y, z, ox, oy, oz, COUNT);
+			for (size_t i = 0; i < COUNT; ++i)
+			{
+				const float *e[3] = { ex, ey, ez };
+				const float *o[3] = { ox, oy, oz };
+				for (int row = 0; row < 3; ++row)
+				{
+					const float *r = m + row * 4;
+					float magnitude = std::fabs(r[0] * x[i]) + std::fabs(r[1] * y[i])
+						+ std::fabs(r[2] * z[i]) + std::fabs(r[3]);
+					ok = ok && (exact ? o[row][i] == e[row][i] : close(o[row][i], e[row][i], magnitude));
+				}
+			}
+		}
+		report(ok, "transformSoa", isa);
+	}
+}
+
+int main() {
+	std::cout << "active isa: " << rt::simd::isaName(rt::simd::activeIsa()) << std::endl;
+	for (int isa = rt::simd::ISA_SCALAR; isa <= rt::simd::activeIsa(); ++isa)
+	{
+		testMat4Mul(static_cast<rt::simd::Isa>(isa));
+		testMat4MulVec4(static_cast<rt::simd::Isa>(isa));
+		testTransformSoa(static_cast<rt::simd::Isa>(isa));
+	}
+	return (check::result("simd_test"));
+}
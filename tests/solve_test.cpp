@@ -0,0 +1,170 @@
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "check.hpp"
+#include "rt_linalg.hpp"
+#include "rt_inverse.hpp"
+#include "rt_parallel.hpp"
+
+/**
+ * rt::LU, rt::Cholesky and rt::leastSquares on random double systems whose
+ * sizes straddle the factorizations' BLOCK of 64, single-threaded and on
+ * every hardware thread. A solve passes when |A * x - b| is within
+ * RESIDUAL of |A| * |x| per element; singular and indefinite inputs have
+ * to throw.
+ */
+namespace
+{
+	const double RESIDUAL = 1e-12;
+
+	std::mt19937 rng(11);
+
+	double uniform(double low, double high) {
+		return (std::uniform_real_distribution<double>(low, high)(rng));
+	}
+
+	rt::RTMatrix<double> random(size_t rows, size_t cols) {
+		rt::RTMatrix<double> m(rows, cols);
+		for (size_t i = 0; i < rows; ++i)
+			for (size_t j = 0; j < cols; ++j)
+				m[i][j] = uniform(-1.0, 1.0);
+		return m;
+	}
+
+	// Largest |a * x - b| over (|a| * |x|) per element.
+	double residual(const rt::RTMatrix<double>& a, const rt::RTMatrix<double>& x, const rt::RTMatrix<double>& b) {
+		double worst = 0.0;
+		for (size_t i = 0; i < a.getRows(); ++i)
+			for (size_t j = 0; j < x.getCols(); ++j)
+			{
+				double sum = 0.0;
+				double magnitude = 0.0;
+				for (size_t k = 0; k < a.getCols(); ++k)
+				{
+					sum += a[i][k] * x[k][j];
+					magnitude += std::fabs(a[i][k] * x[k][j]);
+				}
+				double e = std::fabs(sum - b[i][j]) / (magnitude > 0.0 ? magnitude : 1.0);
+				worst = e > worst ? e : worst;
+			}
+		return (worst);
+	}
+
+	// a^T * a + n * I, symmetric positive definite.
+	rt::RTMatrix<double> randomSpd(size_t n) {
+		rt::RTMatrix<double> a = random(n, n);
+		rt::RTMatrix<double> spd = rt::multiply(rt::transposed(a), a);
+		for (size_t i = 0; i < n; ++i)
+			spd[i][i] += (double)n;
+		return spd;
+	}
+
+	template <class Function>
+	bool throws(Function f) {
+		try
+		{
+			f();
+		}
+		catch (const std::runtime_error&)
+		{
+			return (true);
+		}
+		return (false);
+	}
+
+	void testSolves() {
+		const size_t sizes[] = { 1, 63, 64, 65, 200 };
+		const unsigned threads[] = { 1, 0 };
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+			for (size_t t = 0; t < 2; ++t)
+			{
+				size_t n = sizes[s];
+				rt::RTMatrix<double> a = random(n, n);
+				rt::RTMatrix<double> b = random(n, 3);
+				rt::RTMatrix<double> x = rt::LU<double>(a, threads[t]).solve(b);
+				bool lu = CHECK(residual(a, x, b) < RESIDUAL);
+
+				rt::RTMatrix<double> spd = randomSpd(n);
+				x = rt::Cholesky<double>(spd, threads[t]).solve(b);
+				bool cholesky = CHECK(residual(spd, x, b) < RESIDUAL);
+				if (!lu || !cholesky)
+					std::cerr << "  n = " << n << ", threads = " << threads[t] << std::endl;
+			}
+	}
+
+	void testDeterminant() {
+		for (int n = 0; n < 100; ++n)
+		{
+			rt::RTMatrix<double> a = random(3, 3);
+			double expected = rt::inv::determinant3(a.getData());
+			double det = rt::LU<double>(a).determinant();
+			CHECK(std::fabs(det - expected) <= 1e-14 * (1.0 + std::fabs(expected)));
+		}
+		// the pivoting swaps rows 0 and 2, flipping the sign once
+		double swapped[9] = { 0.0, 0.0, 3.0, 0.0, 2.0, 0.0, 5.0, 0.0, 0.0 };
+		CHECK(rt::LU<double>(rt::RTMatrix<double>(3, 3, swapped)).determinant() == -30.0);
+	}
+
+	void testFailures() {
+		// a zero column past the first block stays exactly zero through the
+		// elimination, LU only rejects exact zero pivots
+		rt::RTMatrix<double> singular = random(70, 70);
+		for (size_t i = 0; i < 70; ++i)
+			singular[i][66] = 0.0;
+		CHECK(throws([&]() { rt::LU<double> lu(singular); }));
+		CHECK(throws([]() { rt::LU<double> lu(rt::RTMatrix<double>(4, 4)); }));
+
+		rt::RTMatrix<double> indefinite = randomSpd(70);
+		indefinite[66][66] = -1.0;
+		CHECK(throws([&]() { rt::Cholesky<double> cholesky(indefinite); }));
+		CHECK(throws([]() { rt::Cholesky<double> cholesky(rt::RTMatrix<double>(3, 4)); }));
+	}
+
+	void testLeastSquares() {
+		// consistent overdetermined system: b = a * expected exactly
+		const size_t ROWS = 500, COLS = 6;
+		rt::RTMatrix<double> a = random(ROWS, COLS);
+		rt::RTMatrix<double> expected = random(COLS, 2);
+		rt::RTMatrix<double> b = rt::multiply(a, expected);
+		rt::RTMatrix<double> x = rt::leastSquares(a, b);
+		CHECK(x.getRows() == COLS && x.getCols() == 2);
+		double worst = 0.0;
+		for (size_t i = 0; i < COLS; ++i)
+			for (size_t j = 0; j < 2; ++j)
+				worst = std::fabs(x[i][j] - expected[i][j]) > worst ? std::fabs(x[i][j] - expected[i][j]) : worst;
+		CHECK(worst < 1e-10);
+
+		// noisy line fit y = 2 + 3t: the fit lands near the true coefficients
+		rt::RTMatrix<double> design(ROWS, 2);
+		rt::RTMatrix<double> y(ROWS, 1);
+		for (size_t i = 0; i < ROWS; ++i)
+		{
+			double t = (double)i / ROWS;
+			design[i][0] = 1.0;
+			design[i][1] = t;
+			y[i][0] = 2.0 + 3.0 * t + uniform(-1e-3, 1e-3);
+		}
+		rt::RTMatrix<double> line = rt::leastSquares(design, y);
+		CHECK(std::fabs(line[0][0] - 2.0) < 1e-3 && std::fabs(line[1][0] - 3.0) < 1e-3);
+	}
+
+	// The caller's chunk throwing must not leave joinable workers behind.
+	void testParallelThrow() {
+		bool caught = throws([]() {
+			rt::parallelFor(1000, 4, 1, 1, [](size_t, size_t end) {
+				if (end == 1000)
+					throw std::runtime_error("last chunk");
+			});
+		});
+		CHECK(caught);
+	}
+}
+
+int main() {
+	testSolves();
+	testDeterminant();
+	testFailures();
+	testLeastSquares();
+	testParallelThrow();
+	return (check::result("solve_test"));
+}
@@ -0,0 +1,167 @@
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "check.hpp"
+#include "UnorderedMap.hpp"
+
+/**
+ * ft::UnorderedMap against std::unordered_map over random insert, erase
+ * and find. A small key range keeps the table churning through
+ * tombstones and in-place rehashes, a growing one through doublings, and
+ * a hash with few distinct values through long probe sequences. Also
+ * covers erase while iterating and try_emplace on a present key.
+ */
+namespace
+{
+	typedef ft::UnorderedMap<int, int>	IntMap;
+
+	// Eight hash values for every key: probes run through many full groups.
+	struct ClusteredHash
+	{
+		size_t operator()(int k) const {
+			return (static_cast<size_t>(k % 8));
+		}
+	};
+
+	std::mt19937 rng(13);
+
+	template <class Map>
+	bool sameContents(const Map &map, const std::unordered_map<int, int> &reference) {
+		if (map.size() != reference.size())
+			return (false);
+		// every element once by iteration, and each one findable
+		std::map<int, int> seen;
+		for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+			if (!seen.insert(std::make_pair(it->first, it->second)).second)
+				return (false);
+		if (seen.size() != reference.size())
+			return (false);
+		for (std::unordered_map<int, int>::const_iterator it = reference.begin(); it != reference.end(); ++it)
+		{
+			typename Map::const_iterator found = map.find(it->first);
+			if (found == map.end() || found->second != it->second || seen[it->first] != it->second)
+				return (false);
+		}
+		return (true);
+	}
+
+	// ops random operations on keys in [0, keys); returns the largest
+	// capacity seen.
+	template <class Map>
+	size_t churn(Map &map, std::unordered_map<int, int> &reference, int keys, int ops, bool &ok) {
+		size_t capacity = 0;
+		for (int n = 0; n < ops; ++n)
+		{
+			int k = static_cast<int>(rng() % keys);
+			switch (rng() % 4)
+			{
+				case 0:
+				{
+					bool inserted = map.insert(ft::Pair<const int, int>(k, n)).second;
+					ok = ok && inserted == reference.insert(std::make_pair(k, n)).second;
+					break ;
+				}
+				case 1:
+					map[k] = n;
+					reference[k] = n;
+					break ;
+				case 2:
+					ok = ok && map.erase(k) == reference.erase(k);
+					break ;
+				default:
+				{
+					typename Map::iterator found = map.find(k);
+					std::unordered_map<int, int>::iterator expected = reference.find(k);
+					ok = ok && (found == map.end()) == (expected == reference.end());
+					ok = ok && (found == map.end() || found->second == expected->second);
+					ok = ok && map.count(k) == reference.count(k);
+				}
+			}
+			capacity = map.bucket_count() > capacity ? map.bucket_count() : capacity;
+			if (n % 1000 == 0)
+				ok = ok && sameContents(map, reference);
+		}
+		ok = ok && sameContents(map, reference);
+		return (capacity);
+	}
+
+	void testChurn() {
+		// at most 200 live keys: the tombstones left by erase have to be
+		// reclaimed by rehashing in place, not by doubling forever
+		IntMap map;
+		std::unordered_map<int, int> reference;
+		bool ok = true;
+		size_t capacity = churn(map, reference, 200, 200000, ok);
+		CHECK(ok);
+		CHECK(capacity <= 511);
+
+		// growth through several doublings, then erasing it all
+		IntMap growing;
+		std::unordered_map<int, int> growingReference;
+		ok = true;
+		churn(growing, growingReference, 100000, 100000, ok);
+		for (int k = 0; k < 100000; ++k)
+			ok = ok && growing.erase(k) == growingReference.erase(k);
+		CHECK(ok);
+		CHECK(growing.empty() && growing.begin() == growing.end());
+
+		ft::UnorderedMap<int, int, ClusteredHash> clustered;
+		std::unordered_map<int, int> clusteredReference;
+		ok = true;
+		churn(clustered, clusteredReference, 500, 50000, ok);
+		CHECK(ok);
+	}
+
+	void testEraseWhileIterating() {
+		IntMap map;
+		std::unordered_map<int, int> reference;
+		for (int k = 0; k < 5000; ++k)
+		{
+			map[k] = k;
+			reference[k] = k;
+		}
+		size_t visited = 0;
+		for (IntMap::iterator it = map.begin(); it != map.end(); ++it)
+		{
+			++visited;
+			if (it->first % 3 == 0)
+			{
+				reference.erase(it->first);
+				map.erase(it);
+			}
+		}
+		CHECK(visited == 5000);
+		CHECK(sameContents(map, reference));
+
+		// range erase over everything left
+		map.erase(map.begin(), map.end());
+		CHECK(map.empty() && map.begin() == map.end());
+		map[7] = 7;
+		CHECK(map.size() == 1 && map[7] == 7);
+	}
+
+	void testTryEmplace() {
+		ft::UnorderedMap<int, std::string> map;
+		map[1] = "x";
+		std::string s("a string long enough to own a heap buffer");
+		ft::Pair<ft::UnorderedMap<int, std::string>::iterator, bool> result = map.try_emplace(1, std::move(s));
+		CHECK(!result.second && result.first->second == "x");
+		// nothing was built from s, so it still holds its value
+		CHECK(s == "a string long enough to own a heap buffer");
+
+		result = map.try_emplace(2, std::move(s));
+		CHECK(result.second && result.first->second == "a string long enough to own a heap buffer");
+		result = map.try_emplace(3, 5, 'z');
+		CHECK(result.second && map[3] == "zzzzz");
+		CHECK(map.size() == 3);
+	}
+}
+
+int main() {
+	testChurn();
+	testEraseWhileIterating();
+	testTryEmplace();
+	return (check::result("unordered_map_test"));
+}
@@ -0,0 +1,110 @@
+#include <stdexcept>
+#include "check.hpp"
+#include "SmallVector.hpp"
+#include "Vector.hpp"
+
+/**
+ * Growth of Vector and SmallVector when copying an element throws. The
+ * element type's move may throw, so relocation copies, and the n-th copy
+ * throws. Every path has to leave the container as it was, with no
+ * element or block leaked: Counted tracks live elements, LeakSanitizer
+ * the blocks.
+ */
+namespace
+{
+	struct Counted
+	{
+		static int	live;
+		static int	copiesLeft;	// the copy that brings this to 0 throws
+		int			value;
+
+		explicit Counted(int value) : value(value) {
+			++live;
+		}
+		Counted(const Counted& x) : value(x.value) {
+			if (copiesLeft > 0 && --copiesLeft == 0)
+				throw std::runtime_error("copy");
+			++live;
+		}
+		// not noexcept, so move_if_noexcept picks the copy
+		Counted(Counted&& x) : Counted(static_cast<const Counted&>(x)) {}
+		Counted& operator=(const Counted& x) {
+			this->value = x.value;
+			return (*this);
+		}
+		~Counted() {
+			--live;
+		}
+	};
+
+	int Counted::live = 0;
+	int Counted::copiesLeft = 0;
+
+	template <class Container>
+	void fill(Container &c, int count) {
+		for (int i = 0; i < count; ++i)
+			c.emplace_back(i);
+	}
+
+	template <class Container>
+	bool intact(const Container &c, int count, int others) {
+		if ((int)c.size() != count || Counted::live != others + count)
+			return (false);
+		for (int i = 0; i < count; ++i)
+			if (c[i].value != i)
+				return (false);
+		return (true);
+	}
+
+	// Runs grow on a full container once per copy it makes, with that copy
+	// throwing, and checks nothing changed.
+	template <class Container, class Grow>
+	void testGrowth(const char *what, Grow grow) {
+		// elements outside the container, e.g. a source range
+		int others = Counted::live;
+		bool ok = true;
+		for (int n = 1; n <= 9; ++n)
+		{
+			{
+				Container c;
+				fill(c, 8);
+				while (c.size() < c.capacity())
+					c.emplace_back((int)c.size());
+				int count = (int)c.size();
+				Counted::copiesLeft = n;
+				try
+				{
+					grow(c);
+				}
+				catch (const std::runtime_error&)
+				{
+				}
+				Counted::copiesLeft = 0;
+				ok = ok && (intact(c, count, others) || (int)c.size() > count);
+			}
+			ok = ok && Counted::live == others;
+		}
+		if (!CHECK(ok))
+			std::cerr << "  " << what << std::endl;
+	}
+
+	template <class Container>
+	void testContainer(const char *name) {
+		Counted extra(100);
+		Counted range[3] = { Counted(101), Counted(102), Counted(103) };
+		testGrowth<Container>(name, [&](Container &c) { c.push_back(extra); });
+		testGrowth<Container>(name, [&](Container &c) { c.emplace_back(c[0]); });
+		testGrowth<Container>(name, [&](Container &c) { c.append(range, range + 3); });
+		testGrowth<Container>(name, [&](Container &c) { c.reserve(c.capacity() + 5); });
+	}
+}
+
+int main() {
+	testContainer<ft::Vector<Counted> >("Vector");
+	testContainer<ft::SmallVector<Counted, 4> >("SmallVector");
+	// growing insert in the middle relocates around the gap
+	testGrowth<ft::SmallVector<Counted, 4> >("SmallVector insert", [](ft::SmallVector<Counted, 4> &c) {
+		c.insert(c.begin() + 2, 2, Counted(-1));
+	});
+	return (check::result("vector_storage_test"));
+}